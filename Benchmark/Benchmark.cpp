@@ -0,0 +1,418 @@
+/*
+ * Benchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "classification/LinearKernel.hpp"
+#include "classification/SupportVectorMachine.hpp"
+#include "detection/AggregatedFeaturesDetector.hpp"
+#include "detection/NonMaximumSuppression.hpp"
+#include "imageprocessing/FrameAllocator.hpp"
+#include "imageprocessing/ImagePyramid.hpp"
+#include "imageprocessing/VersionedImage.hpp"
+#include "imageprocessing/filtering/ConvolutionFilter.hpp"
+#include "imageprocessing/filtering/FhogFilter.hpp"
+#include "imageprocessing/filtering/FpdwFeaturesFilter.hpp"
+#include "imageprocessing/filtering/GrayscaleFilter.hpp"
+#include "libsvm/LibSvmTrainer.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include "tracking/filtering/MeasurementModel.hpp"
+#include "tracking/filtering/ParticleFilter.hpp"
+#include "tracking/filtering/RandomWalkModel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using classification::LinearKernel;
+using classification::SupportVectorMachine;
+using cv::Mat;
+using cv::Rect;
+using cv::Size;
+using detection::AggregatedFeaturesDetector;
+using detection::Detection;
+using detection::NonMaximumSuppression;
+using imageprocessing::FrameAllocator;
+using imageprocessing::ImagePyramid;
+using imageprocessing::VersionedImage;
+using imageprocessing::filtering::ConvolutionFilter;
+using imageprocessing::filtering::FhogFilter;
+using imageprocessing::filtering::FpdwFeaturesFilter;
+using imageprocessing::filtering::GrayscaleFilter;
+using libsvm::LibSvmTrainer;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::function;
+using std::make_shared;
+using std::ostream;
+using std::shared_ptr;
+using std::string;
+using std::to_string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using tracking::filtering::MeasurementModel;
+using tracking::filtering::ParticleFilter;
+using tracking::filtering::RandomWalkModel;
+using tracking::filtering::TargetState;
+
+/**
+ * Timing of a single benchmark.
+ */
+struct Measurement {
+	string name; ///< Name of the benchmark, including its parameters.
+	int iterations; ///< Number of measured iterations.
+	double minTime; ///< Minimum time of an iteration in microseconds.
+	double medianTime; ///< Median time of an iteration in microseconds.
+	double meanTime; ///< Mean time of an iteration in microseconds.
+	double stddevTime; ///< Standard deviation of the time of an iteration in microseconds.
+};
+
+/**
+ * Runs benchmarks and collects their timings. Each benchmark runs one warm-up iteration that is not measured and
+ * is repeated afterwards until both the minimum time and the minimum number of iterations are reached.
+ */
+class BenchmarkSuite {
+public:
+
+	BenchmarkSuite(const string& filter, double minSeconds, int minIterations) :
+			filter(filter), minSeconds(minSeconds), minIterations(minIterations), measurements() {}
+
+	/**
+	 * @param[in] name Name of a benchmark.
+	 * @return True if the benchmark should run, false if it is excluded by the filter.
+	 */
+	bool isSelected(const string& name) const {
+		return filter.empty() || name.find(filter) != string::npos;
+	}
+
+	/**
+	 * Runs a benchmark unless it is excluded by the filter.
+	 *
+	 * @param[in] name Name of the benchmark, including its parameters.
+	 * @param[in] iteration Function that executes a single iteration.
+	 */
+	void run(const string& name, const function<void()>& iteration) {
+		if (!isSelected(name))
+			return;
+		iteration();
+		vector<double> times;
+		duration<double> totalTime(0);
+		while (totalTime.count() < minSeconds || static_cast<int>(times.size()) < minIterations) {
+			steady_clock::time_point start = steady_clock::now();
+			iteration();
+			steady_clock::time_point end = steady_clock::now();
+			duration<double> time = end - start;
+			totalTime += time;
+			times.push_back(1e6 * time.count());
+		}
+		std::sort(times.begin(), times.end());
+		double mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+		double squaredDeviationSum = 0;
+		for (double time : times)
+			squaredDeviationSum += (time - mean) * (time - mean);
+		Measurement measurement;
+		measurement.name = name;
+		measurement.iterations = static_cast<int>(times.size());
+		measurement.minTime = times.front();
+		measurement.medianTime = times[times.size() / 2];
+		measurement.meanTime = mean;
+		measurement.stddevTime = std::sqrt(squaredDeviationSum / times.size());
+		measurements.push_back(measurement);
+		cerr << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(1)
+				<< std::setw(12) << measurement.medianTime << " us (median of " << measurement.iterations << ")" << endl;
+	}
+
+	/**
+	 * Writes the timings in JSON format.
+	 *
+	 * @param[in] stream Stream to write the timings into.
+	 */
+	void writeJson(ostream& stream) const {
+		std::time_t now = std::time(nullptr);
+		stream << "{" << endl;
+		stream << "  \"context\": {" << endl;
+		stream << "    \"date\": \"" << std::put_time(std::localtime(&now), "%Y-%m-%dT%H:%M:%S") << "\"," << endl;
+		stream << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << "," << endl;
+#ifdef NDEBUG
+		stream << "    \"build_type\": \"release\"," << endl;
+#else
+		stream << "    \"build_type\": \"debug\"," << endl;
+#endif
+		stream << "    \"opencv_threads\": " << cv::getNumThreads() << "," << endl;
+		stream << "    \"min_time_s\": " << minSeconds << "," << endl;
+		stream << "    \"time_unit\": \"us\"" << endl;
+		stream << "  }," << endl;
+		stream << "  \"benchmarks\": [";
+		stream << std::fixed << std::setprecision(3);
+		for (size_t i = 0; i < measurements.size(); ++i) {
+			const Measurement& measurement = measurements[i];
+			stream << (i == 0 ? "" : ",") << endl;
+			stream << "    {\"name\": \"" << escape(measurement.name) << "\""
+					<< ", \"iterations\": " << measurement.iterations
+					<< ", \"min\": " << measurement.minTime
+					<< ", \"median\": " << measurement.medianTime
+					<< ", \"mean\": " << measurement.meanTime
+					<< ", \"stddev\": " << measurement.stddevTime << "}";
+		}
+		stream << endl << "  ]" << endl;
+		stream << "}" << endl;
+	}
+
+private:
+
+	static string escape(const string& text) {
+		string escaped;
+		for (char c : text) {
+			if (c == '"' || c == '\\')
+				escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	string filter; ///< Text that must be contained in the names of the benchmarks to run, empty to run all.
+	double minSeconds; ///< Minimum measured time per benchmark in seconds.
+	int minIterations; ///< Minimum number of measured iterations per benchmark.
+	vector<Measurement> measurements; ///< Timings of the benchmarks that ran.
+};
+
+/**
+ * Measurement model with a cheap likelihood that peaks at a fixed state, so the benchmark measures the particle
+ * filter itself (sampling, weighting, resampling) instead of a classifier.
+ */
+class SyntheticMeasurementModel : public MeasurementModel {
+public:
+
+	explicit SyntheticMeasurementModel(TargetState target) : target(target) {}
+
+	void update(shared_ptr<VersionedImage> image) override {}
+
+	double getLikelihood(const TargetState& state) const override {
+		double dx = static_cast<double>(state.x - target.x) / target.size;
+		double dy = static_cast<double>(state.y - target.y) / target.size;
+		double ds = static_cast<double>(state.size - target.size) / target.size;
+		return std::exp(-0.5 * (dx * dx + dy * dy + ds * ds) / 0.01);
+	}
+
+private:
+
+	TargetState target; ///< State with the highest likelihood.
+};
+
+string toString(Size size) {
+	return to_string(size.width) + "x" + to_string(size.height);
+}
+
+Mat createImage(Size size, int type, unsigned int seed) {
+	Mat image(size, type);
+	cv::RNG rng(seed);
+	if (image.depth() == CV_8U)
+		rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+	else
+		rng.fill(image, cv::RNG::UNIFORM, 0.0, 1.0);
+	cv::GaussianBlur(image, image, Size(5, 5), 0); // smooth the noise, so the gradients resemble natural images
+	return image;
+}
+
+vector<Mat> createFeatureVectors(int count, Size windowSize, int channels, float offset, unsigned int seed) {
+	vector<Mat> vectors;
+	cv::RNG rng(seed);
+	for (int i = 0; i < count; ++i) {
+		Mat featureVector(windowSize, CV_32FC(channels));
+		rng.fill(featureVector, cv::RNG::NORMAL, offset, 1.0f);
+		vectors.push_back(featureVector);
+	}
+	return vectors;
+}
+
+vector<Detection> createDetections(int count, Size imageSize, unsigned int seed) {
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<int> xDistribution(0, imageSize.width - 1);
+	std::uniform_int_distribution<int> yDistribution(0, imageSize.height - 1);
+	std::normal_distribution<float> offsetDistribution(0.0f, 4.0f);
+	std::uniform_real_distribution<float> scoreDistribution(-1.0f, 1.0f);
+	int objectCount = std::max(1, count / 50);
+	vector<Rect> objects;
+	for (int i = 0; i < objectCount; ++i)
+		objects.emplace_back(xDistribution(generator), yDistribution(generator), 40, 80);
+	vector<Detection> detections;
+	for (int i = 0; i < count; ++i) {
+		Rect object = objects[i % objectCount];
+		Rect bounds(object.x + static_cast<int>(offsetDistribution(generator)), object.y + static_cast<int>(offsetDistribution(generator)),
+				object.width + static_cast<int>(offsetDistribution(generator)), object.height + static_cast<int>(offsetDistribution(generator)));
+		detections.push_back(Detection{scoreDistribution(generator), bounds});
+	}
+	return detections;
+}
+
+void benchmarkFilters(BenchmarkSuite& suite, const vector<Size>& sizes) {
+	GrayscaleFilter grayscaleFilter;
+	for (Size size : sizes) {
+		Mat colorImage = createImage(size, CV_8UC3, 1);
+		Mat grayscaleImage = grayscaleFilter.applyTo(colorImage);
+		Mat filtered;
+		for (int cellSize : {4, 8}) {
+			FhogFilter fhogFilter(cellSize, 9, false, true, 0.2f);
+			suite.run("fhog/" + toString(size) + "/cell" + to_string(cellSize), [&]() {
+				fhogFilter.applyTo(grayscaleImage, filtered);
+			});
+		}
+		FpdwFeaturesFilter fpdwFilter(true, false);
+		suite.run("fpdw/" + toString(size), [&]() {
+			fpdwFilter.applyTo(colorImage, filtered);
+		});
+		Mat floatImage = createImage(size, CV_32FC1, 2);
+		for (int kernelSize : {3, 7, 15}) {
+			ConvolutionFilter convolutionFilter(createImage(Size(kernelSize, kernelSize), CV_32FC1, 3));
+			suite.run("convolution/" + toString(size) + "/kernel" + to_string(kernelSize), [&]() {
+				convolutionFilter.applyTo(floatImage, filtered);
+			});
+		}
+	}
+}
+
+void benchmarkPyramids(BenchmarkSuite& suite, const vector<Size>& sizes) {
+	for (Size size : sizes) {
+		Mat image = createImage(size, CV_8UC3, 4);
+		shared_ptr<ImagePyramid> exactPyramid = ImagePyramid::create(5, 0.1);
+		exactPyramid->addImageFilter(make_shared<GrayscaleFilter>());
+		exactPyramid->addLayerFilter(make_shared<FhogFilter>(4, 9, false, true, 0.2f));
+		suite.run("pyramid_exact/" + toString(size), [&]() {
+			exactPyramid->update(image);
+		});
+		shared_ptr<ImagePyramid> approximatedPyramid = ImagePyramid::createApproximated(5, 0.1);
+		approximatedPyramid->addImageFilter(make_shared<GrayscaleFilter>());
+		approximatedPyramid->addLayerFilter(make_shared<FhogFilter>(4, 9, false, true, 0.2f));
+		suite.run("pyramid_approximated/" + toString(size), [&]() {
+			approximatedPyramid->update(image);
+		});
+	}
+}
+
+void benchmarkDetection(BenchmarkSuite& suite, const vector<Size>& sizes) {
+	Size windowSize(10, 10); // in cells
+	int fhogChannels = 3 * 9 + 4;
+	shared_ptr<SupportVectorMachine> svm = make_shared<SupportVectorMachine>(make_shared<LinearKernel>());
+	svm->setSupportVectorsAndCoefficients(createFeatureVectors(1, windowSize, fhogChannels, 0.0f, 5), {1.0f});
+	svm->setBias(0.0f);
+	svm->setThreshold(0.0f);
+	shared_ptr<NonMaximumSuppression> nms = make_shared<NonMaximumSuppression>(0.3);
+	AggregatedFeaturesDetector detector(make_shared<GrayscaleFilter>(), make_shared<FhogFilter>(4, 9, false, true, 0.2f),
+			4, windowSize, 5, svm, nms);
+	for (Size size : sizes) {
+		Mat image = createImage(size, CV_8UC3, 6);
+		suite.run("detect/" + toString(size), [&]() {
+			detector.detect(image);
+		});
+	}
+	for (int count : {100, 1000, 10000}) {
+		vector<Detection> candidates = createDetections(count, Size(640, 480), 7);
+		suite.run("nms/" + to_string(count), [&]() {
+			nms->eliminateRedundantDetections(candidates);
+		});
+	}
+}
+
+void benchmarkTracking(BenchmarkSuite& suite) {
+	TargetState target(320, 240, 80);
+	shared_ptr<VersionedImage> image = make_shared<VersionedImage>(createImage(Size(640, 480), CV_8UC1, 8));
+	for (int particleCount : {100, 500, 2000}) {
+		ParticleFilter filter(make_shared<RandomWalkModel>(0.2, 0.05), make_shared<SyntheticMeasurementModel>(target), particleCount);
+		filter.initialize(image, Rect(300, 200, 80, 80));
+		suite.run("particle_filter/" + to_string(particleCount), [&]() {
+			filter.update(image);
+		});
+	}
+}
+
+void benchmarkTraining(BenchmarkSuite& suite) {
+	Size windowSize(10, 10);
+	int channels = 3 * 9 + 4;
+	for (int count : {100, 400}) {
+		vector<Mat> positives = createFeatureVectors(count / 4, windowSize, channels, 0.5f, 9);
+		vector<Mat> negatives = createFeatureVectors(count - count / 4, windowSize, channels, -0.5f, 10);
+		LibSvmTrainer trainer(1.0, true);
+		suite.run("libsvm_train/" + to_string(count), [&]() {
+			SupportVectorMachine svm(make_shared<LinearKernel>());
+			trainer.train(svm, positives, negatives);
+		});
+	}
+}
+
+void benchmarkAllocation(BenchmarkSuite& suite) {
+	for (int threadCount : {1, 4}) {
+		string name = "frame_allocator/" + to_string(threadCount);
+		FrameAllocator allocator; // must outlive the matrices
+		suite.run(name, [&]() {
+			// each frame starts new threads that hand half of their matrices over to the main thread for releasing
+			vector<vector<Mat>> handedOver(threadCount);
+			vector<std::thread> threads;
+			for (int i = 0; i < threadCount; ++i) {
+				threads.emplace_back([&allocator, &handedOver, i]() {
+					for (int j = 0; j < 500; ++j) {
+						Mat matrix;
+						matrix.allocator = &allocator; // works without installing a default allocator (OpenCV 2)
+						matrix.create(16 + j % 7, 64, CV_32FC1);
+						if (j % 2 == 0)
+							handedOver[i].push_back(matrix);
+					}
+				});
+			}
+			for (std::thread& thread : threads)
+				thread.join();
+			handedOver.clear();
+			allocator.finishFrame();
+		});
+		if (suite.isSelected(name) && (allocator.getLastFrameTotal().heapAllocations > 0 || allocator.getUsedBytes() > 0))
+			cerr << name << ": the arena did not serve all allocations of the last frame or leaked memory" << endl;
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc > 4 || (argc > 1 && (string(argv[1]) == "-h" || string(argv[1]) == "--help"))) {
+		cout << "usage: " << argv[0] << " [output [filter [mintime]]]" << endl;
+		cout << "  output: JSON file that the timings are written into, - for standard output (optional, defaults to -)" << endl;
+		cout << "  filter: text that must be contained in the names of the benchmarks to run (optional, defaults to all)" << endl;
+		cout << "  mintime: minimum measured time per benchmark in seconds (optional, defaults to 0.5)" << endl;
+		return EXIT_FAILURE;
+	}
+	string output = argc > 1 ? argv[1] : "-";
+	string filter = argc > 2 ? argv[2] : "";
+	double minSeconds = argc > 3 ? std::stod(argv[3]) : 0.5;
+
+	BenchmarkSuite suite(filter, minSeconds, 5);
+	vector<Size> sizes = { Size(320, 240), Size(640, 480), Size(1280, 720) };
+	benchmarkFilters(suite, sizes);
+	benchmarkPyramids(suite, sizes);
+	benchmarkDetection(suite, sizes);
+	benchmarkTracking(suite);
+	benchmarkTraining(suite);
+	benchmarkAllocation(suite);
+
+	if (output == "-") {
+		suite.writeJson(cout);
+	} else {
+		std::ofstream stream(output);
+		suite.writeJson(stream);
+		if (!stream) {
+			cerr << "could not write timings into '" << output << "'" << endl;
+			return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
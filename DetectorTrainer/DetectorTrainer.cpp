@@ -8,11 +8,19 @@
 #include "boost/filesystem.hpp"
 #include "boost/property_tree/info_parser.hpp"
 #include "boost/property_tree/ptree.hpp"
+#include "classification/LinearSvmTrainer.hpp"
 #include "classification/SupportVectorMachine.hpp"
 #include "detection/DetectorTester.hpp"
 #include "detection/DetectorTrainer.hpp"
+#include "imageio/AnnotationIndex.hpp"
+#include "imageio/DiskCachingImageSource.hpp"
 #include "imageio/DlibImageSource.hpp"
+#include "imageio/IndexedImageSource.hpp"
+#include "imageio/PrefetchingImageSource.hpp"
 #include "imageprocessing/ImagePyramid.hpp"
+#include "imageprocessing/ImagePyramidCache.hpp"
+#include "imageprocessing/MappedImagePyramidStore.hpp"
+#include "imageprocessing/PatchView.hpp"
 #include "imageprocessing/extraction/AggregatedFeaturesExtractor.hpp"
 #include "imageprocessing/filtering/AggregationFilter.hpp"
 #include "imageprocessing/filtering/ChainedFilter.hpp"
@@ -22,13 +30,24 @@
 #include "libsvm/LibSvmTrainer.hpp"
 #include "opencv2/highgui/highgui.hpp"
 #include <chrono>
+#include <exception>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
 
 using boost::filesystem::path;
 using boost::filesystem::exists;
+using boost::filesystem::create_directories;
 using boost::filesystem::create_directory;
 using boost::property_tree::ptree;
 using boost::property_tree::read_info;
@@ -36,6 +55,8 @@ using boost::property_tree::write_info;
 using cv::Mat;
 using cv::Rect;
 using cv::Size;
+using classification::ExampleStore;
+using classification::LinearSvmTrainer;
 using classification::SupportVectorMachine;
 using detection::AggregatedFeaturesDetector;
 using detection::NonMaximumSuppression;
@@ -43,10 +64,18 @@ using detection::DetectionResult;
 using detection::DetectorEvaluationSummary;
 using detection::DetectorTester;
 using detection::DetectorTrainer;
+using imageio::AnnotationIndex;
+using imageio::DiskCachingImageSource;
 using imageio::DlibImageSource;
+using imageio::IndexedImageSource;
 using imageio::AnnotatedImage;
 using imageio::AnnotatedImageSource;
+using imageio::Annotations;
+using imageio::PrefetchingImageSource;
 using imageprocessing::ImagePyramid;
+using imageprocessing::ImagePyramidCache;
+using imageprocessing::MappedImagePyramidStore;
+using imageprocessing::PatchView;
 using imageprocessing::extraction::AggregatedFeaturesExtractor;
 using imageprocessing::filtering::AggregationFilter;
 using imageprocessing::filtering::ChainedFilter;
@@ -61,13 +90,15 @@ using std::chrono::seconds;
 using std::chrono::steady_clock;
 using std::cout;
 using std::endl;
+using std::function;
 using std::invalid_argument;
 using std::make_shared;
 using std::shared_ptr;
 using std::string;
+using std::thread;
 using std::vector;
 
-enum class TaskType { TRAIN, TEST, SHOW };
+enum class TaskType { TRAIN, TEST, SHOW, SEARCH };
 
 class Features {
 public:
@@ -105,6 +136,7 @@ public:
 	int cellSizeInPixels = 4; ///< Cell size in pixels.
 	int octaveLayerCount = 5; ///< Number of image pyramid layers per octave.
 	vector<double> lambdas;
+	string description; ///< Description of the feature configuration, used for identifying persistent feature pyramids.
 };
 class Fhog : public Features {
 public:
@@ -143,8 +175,73 @@ struct DetectionParams {
 	int octaveLayerCount; ///< Number of image pyramid layers per octave.
 	bool approximatePyramid; ///< Flag that indicates whether to approximate all but one image pyramid layer per octave.
 	double nmsOverlapThreshold; ///< Maximum allowed overlap between two detections.
+	string pyramidCache; ///< Directory of the persistent feature pyramid cache, empty if the pyramids are not kept.
 };
 
+/**
+ * Annotated image source that skips the images of a cross-validation test subset.
+ */
+class TrainingSubsetSource : public AnnotatedImageSource {
+public:
+	TrainingSubsetSource(shared_ptr<AnnotatedImageSource> source, int setCount, int testSetIndex) :
+			source(source), setCount(setCount), testSetIndex(testSetIndex), index(-1) {}
+	void reset() override {
+		source->reset();
+		index = -1;
+	}
+	bool next() override {
+		while (source->next()) {
+			++index;
+			if (index % setCount != testSetIndex)
+				return true;
+		}
+		return false;
+	}
+	const Mat getImage() const override {
+		return source->getImage();
+	}
+	string getName() const override {
+		return source->getName();
+	}
+	string getFile() const override {
+		return source->getFile();
+	}
+	function<Mat()> getImageLoader() const override {
+		return source->getImageLoader();
+	}
+	Annotations getAnnotations() const override {
+		return source->getAnnotations();
+	}
+private:
+	shared_ptr<AnnotatedImageSource> source; ///< Source of all images.
+	int setCount; ///< Number of subsets.
+	int testSetIndex; ///< Index of the subset whose images are skipped.
+	int index; ///< Index of the current image within the underlying source.
+};
+
+shared_ptr<AnnotatedImageSource> createAnnotatedImageSource(const string& filename) {
+	if (AnnotationIndex::isIndex(filename))
+		return make_shared<IndexedImageSource>(filename);
+	return make_shared<DlibImageSource>(filename);
+}
+
+shared_ptr<AnnotatedImageSource> createImageSource(const string& filename) {
+	int threadCount = std::max(1, static_cast<int>(thread::hardware_concurrency()));
+	return make_shared<PrefetchingImageSource>(createAnnotatedImageSource(filename), 4 * threadCount, threadCount);
+}
+
+shared_ptr<AnnotatedImageSource> createTrainingImageSource(const string& filename, const ptree& trainingConfig,
+		int setCount = 1, int testSetIndex = -1) {
+	shared_ptr<AnnotatedImageSource> source = createAnnotatedImageSource(filename);
+	string cacheDirectory = trainingConfig.get<string>("imageCache", "");
+	if (!cacheDirectory.empty())
+		source = make_shared<DiskCachingImageSource>(source, cacheDirectory);
+	if (setCount > 1)
+		source = make_shared<TrainingSubsetSource>(source, setCount, testSetIndex);
+	int threadCount = std::max(1, static_cast<int>(thread::hardware_concurrency()));
+	return make_shared<PrefetchingImageSource>(source, 4 * threadCount, threadCount);
+}
+
 vector<AnnotatedImage> getAnnotatedImages(shared_ptr<AnnotatedImageSource> source, const Features& features) {
 	vector<AnnotatedImage> images;
 	while (source->next())
@@ -172,15 +269,56 @@ vector<AnnotatedImage> getTrainingSet(const vector<vector<AnnotatedImage>>& subs
 	return trainingSet;
 }
 
-shared_ptr<AggregatedFeaturesDetector> loadDetector(
-		const string& filename, const Features& features, DetectionParams detectionParams, float threshold = 0) {
-	std::ifstream stream(filename);
-	shared_ptr<SupportVectorMachine> svm = SupportVectorMachine::load(stream);
-	svm->setThreshold(threshold);
-	stream.close();
-	shared_ptr<AggregatedFeaturesExtractor> extractor = detectionParams.approximatePyramid
+shared_ptr<AggregatedFeaturesExtractor> createFeatureExtractor(const Features& features, DetectionParams detectionParams) {
+	return detectionParams.approximatePyramid
 			? features.createApproximatedFeatureExtractor(detectionParams.minWindowSizeInPixels, detectionParams.octaveLayerCount)
 			: features.createFeatureExtractor(detectionParams.minWindowSizeInPixels, detectionParams.octaveLayerCount);
+}
+
+string describe(const DetectionParams& detectionParams) {
+	std::ostringstream stream;
+	stream << "minWindowWidthInPixels " << detectionParams.minWindowSizeInPixels.width << endl;
+	stream << "minWindowHeightInPixels " << detectionParams.minWindowSizeInPixels.height << endl;
+	stream << "octaveLayerCount " << detectionParams.octaveLayerCount << endl;
+	stream << "approximatePyramid " << detectionParams.approximatePyramid << endl;
+	return stream.str();
+}
+
+/**
+ * Lets a feature extractor take its feature pyramids from a persistent cache, so each pyramid is computed only
+ * once and loaded from disk afterwards (in later bootstrapping rounds and program runs).
+ *
+ * @param[in] extractor Feature extractor.
+ * @param[in] directory Directory of the persistent cache.
+ * @param[in] configuration Description of everything that influences the feature pyramids.
+ * @param[in] pyramidFactory Function that creates feature pyramids like the one of the extractor.
+ */
+void setPersistentPyramidCache(AggregatedFeaturesExtractor& extractor, const string& directory,
+		const string& configuration, function<shared_ptr<ImagePyramid>()> pyramidFactory) {
+	auto cache = make_shared<ImagePyramidCache>(pyramidFactory, 256 * 1024 * 1024);
+	cache->setStore(make_shared<MappedImagePyramidStore>(directory, configuration));
+	extractor.setPyramidCache(cache);
+}
+
+shared_ptr<AggregatedFeaturesDetector> loadDetector(
+		const string& filename, shared_ptr<Features> features, DetectionParams detectionParams, float threshold = 0) {
+	shared_ptr<SupportVectorMachine> svm;
+	if (SupportVectorMachine::isBinary(filename)) {
+		svm = SupportVectorMachine::loadBinary(filename);
+	} else {
+		std::ifstream stream(filename);
+		svm = SupportVectorMachine::load(stream);
+		stream.close();
+	}
+	svm->setThreshold(threshold);
+	shared_ptr<AggregatedFeaturesExtractor> extractor = createFeatureExtractor(*features, detectionParams);
+	if (!detectionParams.pyramidCache.empty()) {
+		string configuration = "detection\n" + features->description + describe(detectionParams);
+		// the factory is kept by the cache and might outlive the caller, so it shares the ownership of the features
+		setPersistentPyramidCache(*extractor, detectionParams.pyramidCache, configuration, [features, detectionParams]() {
+			return createFeatureExtractor(*features, detectionParams)->getFeaturePyramid();
+		});
+	}
 	shared_ptr<NonMaximumSuppression> nms = make_shared<NonMaximumSuppression>(
 			detectionParams.nmsOverlapThreshold, NonMaximumSuppression::MaximumType::MAX_SCORE);
 	return make_shared<AggregatedFeaturesDetector>(extractor, svm, nms);
@@ -222,7 +360,15 @@ TaskType getTaskType(const string& type) {
 		return TaskType::TEST;
 	if (type == "show")
 		return TaskType::SHOW;
-	throw invalid_argument("expected train/test/show, but was '" + (string)type + "'");
+	if (type == "search")
+		return TaskType::SEARCH;
+	throw invalid_argument("expected train/test/show/search, but was '" + (string)type + "'");
+}
+
+string describe(const ptree& config) {
+	std::ostringstream stream;
+	write_info(stream, config);
+	return stream.str();
 }
 
 shared_ptr<Features> getFeatures(const ptree& config) {
@@ -240,15 +386,28 @@ shared_ptr<Features> getFeatures(const ptree& config) {
 	features->windowSizeInCells.height = config.get<int>("windowHeightInCells");
 	features->cellSizeInPixels = config.get<int>("cellSizeInPixels");
 	features->octaveLayerCount = config.get<int>("octaveLayerCount");
+	features->description = describe(config);
 	return features;
 }
 
-void setTrainingParams(DetectorTrainer& trainer, const ptree& config) {
-	auto svmTrainer = make_shared<LibSvmTrainer>(config.get<double>("C"), config.get<bool>("compensateImbalance"));
+template <typename T>
+void setSvmTrainer(DetectorTrainer& trainer, const ptree& config, shared_ptr<T> svmTrainer) {
 	if (config.get<bool>("probabilistic"))
 		trainer.setProbabilisticSvmTrainer(svmTrainer);
 	else
 		trainer.setSvmTrainer(svmTrainer);
+}
+
+void setTrainingParams(DetectorTrainer& trainer, const ptree& config) {
+	string solver = config.get<string>("solver", "libsvm");
+	if (solver == "linear")
+		setSvmTrainer(trainer, config, make_shared<LinearSvmTrainer>(
+				config.get<double>("C"), config.get<bool>("compensateImbalance"), 1000, 0.1, config.get<bool>("warmStart", false)));
+	else if (solver == "libsvm")
+		setSvmTrainer(trainer, config, make_shared<LibSvmTrainer>(
+				config.get<double>("C"), config.get<bool>("compensateImbalance"), config.get<double>("cacheSize", 100)));
+	else
+		throw invalid_argument("expected linear/libsvm, but was '" + solver + "'");
 	trainer.mirrorTrainingData = config.get<bool>("mirrorTrainingData");
 	trainer.maxNegatives = config.get<int>("maxNegatives");
 	trainer.randomNegativesPerImage = config.get<int>("randomNegativesPerImage");
@@ -256,6 +415,16 @@ void setTrainingParams(DetectorTrainer& trainer, const ptree& config) {
 	trainer.bootstrappingRounds = config.get<int>("bootstrappingRounds");
 	trainer.negativeScoreThreshold = config.get<float>("negativeScoreThreshold");
 	trainer.overlapThreshold = config.get<double>("overlapThreshold");
+	string exampleStorage = config.get<string>("exampleStorage", "float32");
+	trainer.compactExampleStorage = exampleStorage != "matrices";
+	if (exampleStorage == "float32" || exampleStorage == "matrices")
+		trainer.negativePrecision = ExampleStore::Precision::FLOAT32;
+	else if (exampleStorage == "float16")
+		trainer.negativePrecision = ExampleStore::Precision::FLOAT16;
+	else if (exampleStorage == "int8")
+		trainer.negativePrecision = ExampleStore::Precision::INT8;
+	else
+		throw invalid_argument("expected matrices/float32/float16/int8, but was '" + exampleStorage + "'");
 }
 
 DetectionParams getDetectionParams(const ptree& config) {
@@ -265,17 +434,277 @@ DetectionParams getDetectionParams(const ptree& config) {
 	parameters.octaveLayerCount = config.get<int>("octaveLayerCount");
 	parameters.approximatePyramid = config.get<bool>("approximatePyramid");
 	parameters.nmsOverlapThreshold = config.get<double>("nmsOverlapThreshold");
+	parameters.pyramidCache = config.get<string>("pyramidCache", "");
 	return parameters;
 }
 
+/**
+ * Point of the hyper-parameter grid that is evaluated by the search.
+ */
+struct GridPoint {
+	string type; ///< Feature type.
+	int octaveLayerCount; ///< Number of image pyramid layers per octave used for training and detection.
+	double C; ///< SVM penalty multiplier.
+	ptree featureConfig; ///< Feature configuration with the overridden values.
+	ptree trainingConfig; ///< Training configuration with the overridden values.
+	DetectionParams detectionParams; ///< Detection parameters with the overridden values.
+};
+
+/**
+ * Caches of the feature pyramids that are shared by all folds and grid points with the same features.
+ */
+struct PyramidCaches {
+	shared_ptr<ImagePyramidCache> training; ///< Cache of the feature pyramids used for training.
+	shared_ptr<ImagePyramidCache> testing; ///< Cache of the feature pyramids used for testing.
+};
+
+template <typename T>
+vector<T> getGridValues(const ptree& gridConfig, const string& key, T defaultValue) {
+	vector<T> values;
+	std::istringstream stream(gridConfig.get<string>(key, ""));
+	T value;
+	while (stream >> value)
+		values.push_back(value);
+	if (values.empty())
+		values.push_back(defaultValue);
+	return values;
+}
+
+vector<GridPoint> getGridPoints(const ptree& featureConfig, const ptree& trainingConfig, const ptree& detectionConfig, const ptree& gridConfig) {
+	vector<GridPoint> gridPoints;
+	for (const string& type : getGridValues<string>(gridConfig, "type", featureConfig.get<string>("type"))) {
+		for (int octaveLayerCount : getGridValues<int>(gridConfig, "octaveLayerCount", detectionConfig.get<int>("octaveLayerCount"))) {
+			for (double C : getGridValues<double>(gridConfig, "C", trainingConfig.get<double>("C"))) {
+				GridPoint point{type, octaveLayerCount, C, featureConfig, trainingConfig, getDetectionParams(detectionConfig)};
+				point.featureConfig.put("type", type);
+				if (gridConfig.count("octaveLayerCount") > 0)
+					point.featureConfig.put("octaveLayerCount", octaveLayerCount);
+				point.trainingConfig.put("C", C);
+				point.detectionParams.octaveLayerCount = octaveLayerCount;
+				gridPoints.push_back(point);
+			}
+		}
+	}
+	return gridPoints;
+}
+
+/**
+ * Determines the number of feature values of a training example by extracting the features of one window.
+ *
+ * @param[in] features Feature configuration.
+ * @param[in] images Annotated images.
+ * @return Number of values per training example.
+ */
+size_t getExampleSize(const Features& features, const vector<AnnotatedImage>& images) {
+	shared_ptr<AggregatedFeaturesExtractor> extractor = features.createFeatureExtractor();
+	Rect window(0, 0, features.windowSizeInCells.width * features.cellSizeInPixels, features.windowSizeInCells.height * features.cellSizeInPixels);
+	for (const AnnotatedImage& image : images) {
+		if (image.image.cols < window.width || image.image.rows < window.height)
+			continue;
+		extractor->update(image.image);
+		PatchView patch;
+		if (extractor->extractView(window, patch))
+			return patch.getData().total() * patch.getData().channels();
+	}
+	return static_cast<size_t>(features.windowSizeInCells.area()) * 32; // generous guess of the channel count
+}
+
+/**
+ * Estimates the memory that a single training task of a grid point needs at most in addition to the pyramid
+ * caches, which consists of the stored training examples, the buffered new examples, the decoded copies of the
+ * hard negatives when ranking new ones, and the decoded examples and kernel cache of libSVM.
+ *
+ * @param[in] point Grid point.
+ * @param[in] exampleSize Number of values per training example.
+ * @param[in] imageCount Number of training images.
+ * @param[in] positiveCount Number of positive annotations of the training images.
+ * @return Estimated memory in bytes.
+ */
+size_t estimateTrainingMemory(const GridPoint& point, size_t exampleSize, size_t imageCount, size_t positiveCount) {
+	const ptree& config = point.trainingConfig;
+	size_t mirrorFactor = config.get<bool>("mirrorTrainingData") ? 2 : 1;
+	size_t positives = mirrorFactor * positiveCount;
+	int maxNegatives = config.get<int>("maxNegatives");
+	size_t negatives = maxNegatives > 0 ? static_cast<size_t>(maxNegatives) : mirrorFactor * imageCount
+			* (config.get<int>("randomNegativesPerImage") + config.get<int>("bootstrappingRounds") * config.get<int>("maxHardNegativesPerImage"));
+	string exampleStorage = config.get<string>("exampleStorage", "float32");
+	size_t negativeValueSize = exampleStorage == "int8" ? 1 : exampleStorage == "float16" ? 2 : sizeof(float);
+	size_t memory = exampleSize * (positives * sizeof(float) + negatives * negativeValueSize);
+	memory += exampleSize * sizeof(float) * DetectorTrainer().exampleBatchSize;
+	if (maxNegatives > 0)
+		memory += exampleSize * sizeof(float) * negatives;
+	if (config.get<string>("solver", "libsvm") == "libsvm") {
+		memory += exampleSize * sizeof(float) * (positives + negatives);
+		memory += static_cast<size_t>(config.get<double>("cacheSize", 100) * 1024 * 1024);
+	}
+	return memory;
+}
+
+/**
+ * Estimates the memory that any single training task of the grid points needs at most in addition to the
+ * pyramid caches.
+ *
+ * @param[in] gridPoints Grid points.
+ * @param[in] imageSet Annotated images (all of them, as an upper bound of the training images).
+ * @return Estimated memory in bytes.
+ */
+size_t estimateTrainingMemory(const vector<GridPoint>& gridPoints, const vector<AnnotatedImage>& imageSet) {
+	size_t positiveCount = 0;
+	for (const AnnotatedImage& image : imageSet)
+		positiveCount += image.annotations.positiveAnnotations().size();
+	std::map<string, size_t> exampleSizes;
+	size_t memory = 0;
+	for (const GridPoint& point : gridPoints) {
+		auto exampleSize = exampleSizes.find(point.type);
+		if (exampleSize == exampleSizes.end())
+			exampleSize = exampleSizes.emplace(point.type, getExampleSize(*getFeatures(point.featureConfig), imageSet)).first;
+		memory = std::max(memory, estimateTrainingMemory(point, exampleSize->second, imageSet.size(), positiveCount));
+	}
+	return memory;
+}
+
+std::map<std::pair<string, int>, PyramidCaches> createPyramidCaches(const vector<GridPoint>& gridPoints, size_t memoryBudget) {
+	std::map<std::pair<string, int>, PyramidCaches> caches;
+	for (const GridPoint& point : gridPoints)
+		caches[std::make_pair(point.type, point.octaveLayerCount)] = PyramidCaches();
+	size_t capacity = memoryBudget / (2 * caches.size());
+	for (const GridPoint& point : gridPoints) {
+		PyramidCaches& pointCaches = caches[std::make_pair(point.type, point.octaveLayerCount)];
+		if (pointCaches.training)
+			continue;
+		shared_ptr<Features> features = getFeatures(point.featureConfig);
+		DetectionParams detectionParams = point.detectionParams;
+		pointCaches.training = make_shared<ImagePyramidCache>([features]() {
+			return features->createFeatureExtractor()->getFeaturePyramid();
+		}, capacity);
+		pointCaches.testing = make_shared<ImagePyramidCache>([features, detectionParams]() {
+			return createFeatureExtractor(*features, detectionParams)->getFeaturePyramid();
+		}, capacity);
+	}
+	return caches;
+}
+
+DetectorTester trainAndTest(const GridPoint& point, const PyramidCaches& caches,
+		const vector<vector<AnnotatedImage>>& subsets, int testSetIndex) {
+	shared_ptr<Features> features = getFeatures(point.featureConfig);
+	shared_ptr<AggregatedFeaturesExtractor> trainingExtractor = features->createFeatureExtractor();
+	trainingExtractor->setPyramidCache(caches.training);
+	DetectorTrainer detectorTrainer;
+	detectorTrainer.printProgressInformation = false;
+	detectorTrainer.setFeatureExtractor(trainingExtractor);
+	setTrainingParams(detectorTrainer, point.trainingConfig);
+	detectorTrainer.train(getTrainingSet(subsets, testSetIndex));
+	shared_ptr<AggregatedFeaturesExtractor> testingExtractor = createFeatureExtractor(*features, point.detectionParams);
+	testingExtractor->setPyramidCache(caches.testing);
+	shared_ptr<NonMaximumSuppression> nms = make_shared<NonMaximumSuppression>(
+			point.detectionParams.nmsOverlapThreshold, NonMaximumSuppression::MaximumType::MAX_SCORE);
+	shared_ptr<AggregatedFeaturesDetector> detector = detectorTrainer.getDetector(nms, testingExtractor, -1.0f);
+	DetectorTester tester(point.detectionParams.minWindowSizeInPixels);
+	tester.evaluate(*detector, subsets[testSetIndex]);
+	return tester;
+}
+
+void writeSearchSummary(std::ostream& out, const vector<GridPoint>& gridPoints, const vector<DetectorTester>& testers) {
+	out << std::left << std::setw(10) << "type" << std::setw(8) << "layers" << std::setw(10) << "C"
+			<< std::setw(12) << "avg MR" << std::setw(12) << "MR@1" << std::setw(12) << "MR@0.1" << std::setw(12) << "MR@0.01"
+			<< std::setw(12) << "default MR" << std::setw(12) << "default FPPI" << endl;
+	size_t bestIndex = 0;
+	double bestMissRate = std::numeric_limits<double>::infinity();
+	for (size_t i = 0; i < gridPoints.size(); ++i) {
+		DetectorEvaluationSummary summary = testers[i].getSummary();
+		out << std::left << std::setw(10) << gridPoints[i].type << std::setw(8) << gridPoints[i].octaveLayerCount << std::setw(10) << gridPoints[i].C
+				<< std::setw(12) << summary.avgMissRate << std::setw(12) << summary.missRateAtFppi0
+				<< std::setw(12) << summary.missRateAtFppi1 << std::setw(12) << summary.missRateAtFppi2
+				<< std::setw(12) << summary.defaultMissRate << std::setw(12) << summary.defaultFppiRate << endl;
+		if (summary.avgMissRate < bestMissRate) {
+			bestMissRate = summary.avgMissRate;
+			bestIndex = i;
+		}
+	}
+	out << "best log-average miss rate: " << bestMissRate << " (type " << gridPoints[bestIndex].type
+			<< ", " << gridPoints[bestIndex].octaveLayerCount << " layers per octave, C " << gridPoints[bestIndex].C << ")" << endl;
+}
+
+void search(const path& directory, const vector<AnnotatedImage>& imageSet, int setCount, const ptree& featureConfig,
+		const ptree& trainingConfig, const ptree& detectionConfig, const ptree& gridConfig) {
+	vector<GridPoint> gridPoints = getGridPoints(featureConfig, trainingConfig, detectionConfig, gridConfig);
+	int threadCount = std::max(1, gridConfig.get<int>("threads", static_cast<int>(thread::hardware_concurrency())));
+	size_t memoryBudget = gridConfig.get<size_t>("memoryBudget", 1024) * 1024 * 1024;
+	// the concurrent training tasks may use at most half of the budget, the remainder is shared by the pyramid caches
+	size_t trainingMemory = std::max(estimateTrainingMemory(gridPoints, imageSet), static_cast<size_t>(1));
+	size_t affordableTaskCount = std::max(memoryBudget / 2 / trainingMemory, static_cast<size_t>(1));
+	threadCount = static_cast<int>(std::min(static_cast<size_t>(threadCount), affordableTaskCount));
+	size_t cacheMemory = memoryBudget - std::min(memoryBudget, threadCount * trainingMemory);
+	std::map<std::pair<string, int>, PyramidCaches> caches = createPyramidCaches(gridPoints, cacheMemory);
+	vector<vector<AnnotatedImage>> subsets = getSubsets(imageSet, setCount);
+	cout << "search " << gridPoints.size() << " grid points on " << setCount << " sets using " << threadCount << " threads" << endl;
+	cout << "memory budget: " << (trainingMemory >> 20) << " MB per training task, " << (cacheMemory >> 20) << " MB for feature pyramids" << endl;
+#ifdef _OPENMP
+	int ompThreadCount = std::max(1, omp_get_max_threads() / threadCount); // libSVM must not oversubscribe the cores
+#endif
+
+	size_t taskCount = gridPoints.size() * subsets.size();
+	size_t nextTask = 0;
+	size_t finishedTaskCount = 0;
+	vector<DetectorTester> testers(gridPoints.size(), DetectorTester(getDetectionParams(detectionConfig).minWindowSizeInPixels));
+	std::exception_ptr error;
+	std::mutex mutex;
+	auto work = [&]() {
+#ifdef _OPENMP
+		omp_set_num_threads(ompThreadCount);
+#endif
+		while (true) {
+			size_t task;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (nextTask == taskCount || error)
+					return;
+				task = nextTask++;
+			}
+			size_t gridIndex = task / subsets.size();
+			int testSetIndex = static_cast<int>(task % subsets.size());
+			const GridPoint& point = gridPoints[gridIndex];
+			try {
+				DetectorTester tester = trainAndTest(point, caches.at(std::make_pair(point.type, point.octaveLayerCount)), subsets, testSetIndex);
+				std::lock_guard<std::mutex> lock(mutex);
+				testers[gridIndex].merge(tester);
+				++finishedTaskCount;
+				cout << "  [" << finishedTaskCount << "/" << taskCount << "] finished subset " << (testSetIndex + 1)
+						<< " of type " << point.type << ", " << point.octaveLayerCount << " layers per octave, C " << point.C << endl;
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!error)
+					error = std::current_exception();
+			}
+		}
+	};
+	vector<thread> threads;
+	for (int i = 0; i < threadCount; ++i)
+		threads.emplace_back(work);
+	for (thread& worker : threads)
+		worker.join();
+	if (error)
+		std::rethrow_exception(error);
+
+	cout << "=== Search summary ===" << endl;
+	writeSearchSummary(cout, gridPoints, testers);
+	if (!exists(directory))
+		create_directories(directory);
+	std::ofstream summaryFileStream((directory / "search_summary").string());
+	writeSearchSummary(summaryFileStream, gridPoints, testers);
+	summaryFileStream.close();
+}
+
 void printUsageInformation(string applicationName) {
 	cout << "call: " << applicationName << " action directory images setcount configs" << endl;
 	cout << "action: what the program should do" << endl;
 	cout << "  train: train detector(s)" << endl;
 	cout << "  test: test detector(s)" << endl;
 	cout << "  show: show detection results of detector(s)" << endl;
+	cout << "  search: train and test detectors of a parameter grid using parallel cross-validation" << endl;
+	cout << "  index: convert the DLib XML file into an annotation index (call: " << applicationName << " index indexfile images)" << endl;
 	cout << "directory: directory to create or use for loading and storing SVM and evaluation data" << endl;
-	cout << "images: DLib XML file of annotated images" << endl;
+	cout << "images: DLib XML file or annotation index of annotated images" << endl;
 	cout << "setcount: number of subsets for cross-validation (1 to use all images at once)" << endl;
 	cout << "configs: configuration file(s) for features, training and detection, depends on action" << endl;
 	cout << "  train: [featureconfig trainingconfig] (only necessary if detector directory does not exist)" << endl;
@@ -285,26 +714,45 @@ void printUsageInformation(string applicationName) {
 	cout << "  show: detectionconfig [threshold]" << endl;
 	cout << "    detectionconfig: configuration file containing detection parameters" << endl;
 	cout << "    threshold: SVM score threshold (optional, defaults to 0.0)" << endl;
+	cout << "  search: featureconfig trainingconfig detectionconfig gridconfig" << endl;
+	cout << "    gridconfig: configuration file containing the parameter values to search" << endl;
 	cout << endl;
 	cout << "Examples:" << endl;
 	cout << "Create four detectors for cross-validation:" << endl << "  " << applicationName << " train mydetector images.xml 4 featureconfig trainingconfig" << endl;
 	cout << "Train single detector in existing directory, re-using configs: " << endl << "  " << applicationName << " train mydetector images.xml 1" << endl;
 	cout << "Evaluate detectors using cross-validation: " << endl << "  " << applicationName << " test mydetector images.xml 4 detectorconfig" << endl;
 	cout << "Show detections using cross-validation: " << endl << "  " << applicationName << " show mydetector images.xml 4 detectorconfig 0.5" << endl;
+	cout << "Search parameters using cross-validation: " << endl << "  " << applicationName << " search mysearch images.xml 4 featureconfig trainingconfig detectorconfig gridconfig" << endl;
+	cout << "Create annotation index that is faster to read than the XML file: " << endl << "  " << applicationName << " index images.index images.xml" << endl;
 }
 
 int main(int argc, char** argv) {
-	if (argc < 5 || argc > 7) {
+	if (argc == 4 && string(argv[1]) == "index") {
+		DlibImageSource source(argv[3]);
+		size_t imageCount = AnnotationIndex::write(source, argv[2]);
+		cout << "indexed " << imageCount << " images in '" << argv[2] << "'" << endl;
+		return 0;
+	}
+	if (argc < 5 || argc > 9) {
 		printUsageInformation(argv[0]);
 		return 0;
 	}
 	TaskType taskType = getTaskType(argv[1]);
 	path directory = argv[2];
-	auto imageSource = make_shared<DlibImageSource>(argv[3]);
+	string imageFile = argv[3];
 	int setCount = std::stoi(argv[4]);
-	ptree featureConfig, trainingConfig, detectionConfig;
+	ptree featureConfig, trainingConfig, detectionConfig, gridConfig;
 
-	if (taskType == TaskType::TRAIN) {
+	if (taskType == TaskType::SEARCH) {
+		if (argc != 9 || setCount < 2) {
+			printUsageInformation(argv[0]);
+			return 0;
+		}
+		read_info(argv[5], featureConfig);
+		read_info(argv[6], trainingConfig);
+		read_info(argv[7], detectionConfig);
+		read_info(argv[8], gridConfig);
+	} else if (taskType == TaskType::TRAIN) {
 		if (argc == 5) { // re-use directory, read training and feature config contained in directory
 			if (exists(directory)) {
 				cout << "using existing directory '" << directory.string() << "'" << endl;
@@ -334,7 +782,7 @@ int main(int argc, char** argv) {
 		}
 	} else {
 		if ((taskType == TaskType::TEST && argc != 6)
-				|| (taskType == TaskType::SHOW && argc < 6)) {
+				|| (taskType == TaskType::SHOW && (argc < 6 || argc > 7))) {
 			printUsageInformation(argv[0]);
 			return 0;
 		}
@@ -347,14 +795,31 @@ int main(int argc, char** argv) {
 		read_info(argv[5], detectionConfig);
 	}
 	shared_ptr<Features> features = getFeatures(featureConfig);
-	vector<AnnotatedImage> imageSet = getAnnotatedImages(imageSource, *features);
+	bool streaming = taskType == TaskType::TRAIN && trainingConfig.get<bool>("streaming", false);
+	vector<AnnotatedImage> imageSet;
+	if (!streaming) // streaming training reads the images once per round instead of keeping them in memory
+		imageSet = getAnnotatedImages(createImageSource(imageFile), *features);
 
-	if (taskType == TaskType::TRAIN) {
+	if (taskType == TaskType::SEARCH) {
+		steady_clock::time_point start = steady_clock::now();
+		search(directory, imageSet, setCount, featureConfig, trainingConfig, detectionConfig, gridConfig);
+		steady_clock::time_point end = steady_clock::now();
+		cout << "search finished after " << duration_cast<seconds>(end - start).count() << " sec" << endl;
+	}
+	else if (taskType == TaskType::TRAIN) {
 		DetectorTrainer detectorTrainer;
 		detectorTrainer.printProgressInformation = true;
 		detectorTrainer.printPrefix = "  ";
-		detectorTrainer.setFeatureExtractor(features->createFeatureExtractor());
+		shared_ptr<AggregatedFeaturesExtractor> featureExtractor = features->createFeatureExtractor();
+		string pyramidCache = trainingConfig.get<string>("pyramidCache", "");
+		if (!pyramidCache.empty()) {
+			setPersistentPyramidCache(*featureExtractor, pyramidCache, "training\n" + features->description, [features]() {
+				return features->createFeatureExtractor()->getFeaturePyramid();
+			});
+		}
+		detectorTrainer.setFeatureExtractor(featureExtractor);
 		setTrainingParams(detectorTrainer, trainingConfig);
+		bool binaryModel = trainingConfig.get<bool>("binaryModel", false);
 		steady_clock::time_point start = steady_clock::now();
 		cout << "train detector '" << directory.string() << "' on ";
 		if (setCount == 1) { // train on all images
@@ -363,20 +828,26 @@ int main(int argc, char** argv) {
 			if (exists(svmFile)) {
 				cout << "  SVM file '" << svmFile.string() << "' already exists, skipping training" << endl;
 			} else {
-				detectorTrainer.train(imageSet);
-				detectorTrainer.storeClassifier(svmFile.string());
+				if (streaming)
+					detectorTrainer.train(*createTrainingImageSource(imageFile, trainingConfig));
+				else
+					detectorTrainer.train(imageSet);
+				detectorTrainer.storeClassifier(svmFile.string(), binaryModel);
 			}
 		} else { // train on subsets for cross-validation
 			cout << setCount << " sets" << endl;
 			vector<vector<AnnotatedImage>> subsets = getSubsets(imageSet, setCount);
-			for (int testSetIndex = 0; testSetIndex < subsets.size(); ++testSetIndex) {
+			for (int testSetIndex = 0; testSetIndex < setCount; ++testSetIndex) {
 				cout << "training on subset " << (testSetIndex + 1) << endl;
 				path svmFile = directory / ("svm" + std::to_string(testSetIndex + 1));
 				if (exists(svmFile)) {
 					cout << "  SVM file '" << svmFile.string() << "' already exists, skipping training" << endl;
 				} else {
-					detectorTrainer.train(getTrainingSet(subsets, testSetIndex));
-					detectorTrainer.storeClassifier(svmFile.string());
+					if (streaming)
+						detectorTrainer.train(*createTrainingImageSource(imageFile, trainingConfig, setCount, testSetIndex));
+					else
+						detectorTrainer.train(getTrainingSet(subsets, testSetIndex));
+					detectorTrainer.storeClassifier(svmFile.string(), binaryModel);
 				}
 			}
 		}
@@ -418,7 +889,7 @@ int main(int argc, char** argv) {
 			if (setCount == 1) { // no cross-validation, test on all images at once
 				path svmFile = directory / "svm";
 				shared_ptr<AggregatedFeaturesDetector> detector = loadDetector(
-						svmFile.string(), *features, detectionParams, -1.0f);
+						svmFile.string(), features, detectionParams, -1.0f);
 				tester.evaluate(*detector, imageSet);
 			} else { // cross-validation, test on subsets
 				vector<vector<AnnotatedImage>> subsets = getSubsets(imageSet, setCount);
@@ -426,7 +897,7 @@ int main(int argc, char** argv) {
 					cout << "testing on subset " << (testSetIndex + 1) << endl;
 					path svmFile = directory / ("svm" + std::to_string(testSetIndex + 1));
 					shared_ptr<AggregatedFeaturesDetector> detector = loadDetector(
-							svmFile.string(), *features, detectionParams, -1.0f);
+							svmFile.string(), features, detectionParams, -1.0f);
 					tester.evaluate(*detector, subsets[testSetIndex]);
 				}
 			}
@@ -449,7 +920,7 @@ int main(int argc, char** argv) {
 		if (setCount == 1) { // no cross-validation, show same detector on all images
 			path svmFile = directory / "svm";
 			shared_ptr<AggregatedFeaturesDetector> detector = loadDetector(
-					svmFile.string(), *features, detectionParams, threshold);
+					svmFile.string(), features, detectionParams, threshold);
 			if (showDetections(tester, *detector, imageSet)) {
 				cout << "press any key to exit" << endl;
 				cv::waitKey(0);
@@ -459,7 +930,7 @@ int main(int argc, char** argv) {
 			for (int testSetIndex = 0; testSetIndex < subsets.size(); ++testSetIndex) {
 				path svmFile = directory / ("svm" + std::to_string(testSetIndex + 1));
 				shared_ptr<AggregatedFeaturesDetector> detector = loadDetector(
-						svmFile.string(), *features, detectionParams, threshold);
+						svmFile.string(), features, detectionParams, threshold);
 				if (!showDetections(tester, *detector, subsets[testSetIndex]))
 					break;
 			}
@@ -8,25 +8,34 @@
 #include "classification/ProbabilisticSupportVectorMachine.hpp"
 #include "detection/AggregatedFeaturesDetector.hpp"
 #include "detection/NonMaximumSuppression.hpp"
-#include "imageio/CameraImageSource.hpp"
+#include "imageio/AsyncImageSink.hpp"
+#include "imageio/DirectoryImageSink.hpp"
 #include "imageio/VideoImageSource.hpp"
 #include "imageio/DirectoryImageSource.hpp"
 #include "imageio/DlibImageSource.hpp"
+#include "imageio/PrefetchingImageSource.hpp"
+#include "imageio/ThreadedCameraImageSource.hpp"
+#include "imageio/VideoImageSink.hpp"
+#include "imageprocessing/FrameAllocator.hpp"
+#include "imageprocessing/Instrumentation.hpp"
 #include "imageprocessing/extraction/ExactFhogExtractor.hpp"
 #include "imageprocessing/filtering/FhogFilter.hpp"
 #include "imageprocessing/filtering/GrayscaleFilter.hpp"
 #include "tracking/MultiTracker.hpp"
 #include "tracking/filtering/RandomWalkModel.hpp"
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <thread>
 
 using namespace classification;
 using namespace cv;
 using namespace detection;
 using namespace imageio;
+using namespace imageprocessing;
 using namespace imageprocessing::extraction;
 using namespace imageprocessing::filtering;
 using namespace std;
@@ -35,21 +44,23 @@ using namespace tracking;
 using namespace tracking::filtering;
 
 shared_ptr<ImageSource> loadImages(const string& video);
+shared_ptr<AsyncImageSink> createOutput(const string& output, double fps);
 shared_ptr<ProbabilisticSupportVectorMachine> loadSvm(const string& filename, float threshold = 0);
 shared_ptr<FhogFilter> createFhogFilter(int binCount, int cellSize);
 shared_ptr<AggregatedFeaturesDetector> createDetector(
 		shared_ptr<FhogFilter> fhogFilter, shared_ptr<SupportVectorMachine> svm, int cellSize, int minWidth, int maxWidth);
-void run(MultiTracker& tracker, ImageSource& images);
+void run(MultiTracker& tracker, ImageSource& images, AsyncImageSink* recording, FrameAllocator& allocator);
 void drawParticles(Mat& output, vector<Particle> particles);
 
 int main(int argc, char **argv) {
-	if (argc != 6) {
-		cout << "usage: " << argv[0] << " video svm cellsize detectionThreshold visibilityThreshold" << endl;
+	if (argc < 6 || argc > 7) {
+		cout << "usage: " << argv[0] << " video svm cellsize detectionThreshold visibilityThreshold [output]" << endl;
 		cout << "  video: camera device ID, video file, dlib annotation XML-file, or image directory" << endl;
 		cout << "  svm: text file that contains SVM data (e.g. created by DetectorTrainer)" << endl;
 		cout << "  cellsize: size of the square FHOG cells in pixels" << endl;
 		cout << "  detectionThreshold: SVM score threshold for detections to be reported" << endl;
 		cout << "  visibilityThreshold: SVM score threshold for tracks to be regarded visible" << endl;
+		cout << "  output: directory or video file (.avi) that the annotated frames are written into (optional)" << endl;
 		return EXIT_FAILURE;
 	}
 	string video = argv[1];
@@ -60,6 +71,7 @@ int main(int argc, char **argv) {
 	int minWidth = 0;
 	int maxWidth = 0;
 
+	FrameAllocator allocator; // must outlive the images and the tracker, as they keep matrices allocated by it
 	shared_ptr<ImageSource> images = loadImages(video);
 	shared_ptr<ProbabilisticSupportVectorMachine> svm = loadSvm(svmFile, detectionThreshold);
 	int binCount = (svm->getSvm()->getSupportVectors()[0].channels() - 4) / 3;
@@ -79,28 +91,60 @@ int main(int argc, char **argv) {
 	tracker->negativeOverlapThreshold = 0.5;
 	tracker->targetSvmC = 10;
 	tracker->learnRate = 0.5;
-	run(*tracker, *images);
+	shared_ptr<AsyncImageSink> output = argc > 6 ? createOutput(argv[6], 25) : shared_ptr<AsyncImageSink>();
+#ifdef INSTRUMENTATION
+	imageprocessing::Instrumentation::getInstance().setTracing(true);
+#endif
+	run(*tracker, *images, output.get(), allocator);
+	if (output) {
+		output->flush();
+		if (output->getDroppedCount() > 0)
+			cout << output->getDroppedCount() << " frames were not written, as writing was too slow" << endl;
+	}
+#ifdef INSTRUMENTATION
+	ofstream statisticsStream("instrumentation.json");
+	imageprocessing::Instrumentation::getInstance().writeJson(statisticsStream);
+	ofstream traceStream("trace.json");
+	imageprocessing::Instrumentation::getInstance().writeChromeTrace(traceStream);
+	cout << "stage timings were written to instrumentation.json and trace.json" << endl;
+#endif
 
 	return EXIT_SUCCESS;
 }
 
 shared_ptr<ImageSource> loadImages(const string& s) {
 	if (s.length() == 1 && isdigit(s[0]))
-		return make_shared<CameraImageSource>(stoi(s));
+		return make_shared<ThreadedCameraImageSource>(stoi(s), 4, true);
 	path p(s);
 	if (!exists(p))
 		throw invalid_argument(s + " is not a valid file or directory");
 	if (is_directory(p))
-		return make_shared<DirectoryImageSource>(p.string());
+		return make_shared<PrefetchingImageSource>(make_shared<DirectoryImageSource>(p.string()));
 	if (".xml" == p.extension().string())
-		return make_shared<DlibImageSource>(p.string());
+		return make_shared<PrefetchingImageSource>(make_shared<DlibImageSource>(p.string()));
 	return make_shared<VideoImageSource>(p.string());
 }
 
+shared_ptr<AsyncImageSink> createOutput(const string& output, double fps) {
+	shared_ptr<ImageSink> sink;
+	if (".avi" == path(output).extension().string())
+		sink = make_shared<VideoImageSink>(output, fps);
+	else
+		sink = make_shared<DirectoryImageSink>(output);
+	// frames are dropped instead of waiting, so recording does not slow down the tracking
+	int threadCount = std::max(1, static_cast<int>(thread::hardware_concurrency()) / 2);
+	return make_shared<AsyncImageSink>(sink, 4 * threadCount, threadCount, AsyncImageSink::OverflowPolicy::DROP_OLDEST);
+}
+
 shared_ptr<ProbabilisticSupportVectorMachine> loadSvm(const string& filename, float threshold) {
-	ifstream stream(filename);
-	shared_ptr<ProbabilisticSupportVectorMachine> svm = ProbabilisticSupportVectorMachine::load(stream);
-	stream.close();
+	shared_ptr<ProbabilisticSupportVectorMachine> svm;
+	if (SupportVectorMachine::isBinary(filename)) {
+		svm = ProbabilisticSupportVectorMachine::loadBinary(filename);
+	} else {
+		ifstream stream(filename);
+		svm = ProbabilisticSupportVectorMachine::load(stream);
+		stream.close();
+	}
 	svm->getSvm()->setThreshold(threshold);
 	svm->setLogisticB(0.0);
 	return svm;
@@ -120,8 +164,9 @@ shared_ptr<AggregatedFeaturesDetector> createDetector(
 			fhogFilter, cellSize, Size(windowWidth, windowHeight), 5, svm, nms, 1.0, 1.0, minWidth, maxWidth);
 }
 
-void run(MultiTracker& tracker, ImageSource& images) {
+void run(MultiTracker& tracker, ImageSource& images, AsyncImageSink* recording, FrameAllocator& allocator) {
 	GrayscaleFilter grayscaleFilter;
+	ThreadedCameraImageSource* camera = dynamic_cast<ThreadedCameraImageSource*>(&images);
 	Scalar colorUnconfirmed(0, 0, 0);
 	vector<Scalar> colors = {
 			Scalar(234, 82, 1), // blue
@@ -149,8 +194,15 @@ void run(MultiTracker& tracker, ImageSource& images) {
 		++frameCount;
 		Mat frame = images.getImage();
 		steady_clock::time_point iterationStart = steady_clock::now();
-		vector<pair<int, Rect>> targets = tracker.update(grayscaleFilter.applyTo(frame));
+		Mat grayscaleFrame = camera ? camera->getGrayscaleImage() : grayscaleFilter.applyTo(frame);
+		vector<pair<int, Rect>> targets;
+		{
+			FrameAllocator::Scope allocatorScope(allocator);
+			targets = tracker.update(grayscaleFrame);
+		}
 		steady_clock::time_point iterationEnd = steady_clock::now();
+		allocator.finishFrame();
+		INSTRUMENT_FRAME();
 		milliseconds iterationTime = duration_cast<milliseconds>(iterationEnd - iterationStart);
 		frame.copyTo(output);
 		if (debug) {
@@ -166,13 +218,23 @@ void run(MultiTracker& tracker, ImageSource& images) {
 		for (const pair<int, Rect>& target : targets)
 			rectangle(output, target.second, colors[target.first % colors.size()], thickness);
 		imshow("Frame", output);
+		if (recording)
+			recording->add(output);
 
 		iterationTimeSum += iterationTime;
 		double iterationFps = static_cast<double>(frameCount) / iterationTimeSum.count();
 		cout << fixed << setprecision(1);
 		cout << frameCount << ": ";
 		cout << iterationTime.count() << " ms -> ";
-		cout << iterationFps << " fps" << endl;
+		cout << iterationFps << " fps";
+#if CV_MAJOR_VERSION >= 3
+		cout << ", " << allocator.getLastFrameTotal().heapAllocations << " heap allocations";
+#else
+		cout << ", n/a heap allocations"; // the matrices do not use the allocator without a default allocator
+#endif
+		if (camera)
+			cout << " (" << camera->getDroppedCount() << " frames dropped)";
+		cout << endl;
 		char c = static_cast<char>(waitKey(pause ? 0 : 2));
 		if (c == 'q')
 			run = false;
@@ -9,6 +9,7 @@
 #include "detection/AggregatedFeaturesDetector.hpp"
 #include "detection/NonMaximumSuppression.hpp"
 #include "imageio/DlibImageSource.hpp"
+#include "imageio/PrefetchingImageSource.hpp"
 #include "imageprocessing/extraction/ExactFhogExtractor.hpp"
 #include "imageprocessing/filtering/FhogFilter.hpp"
 #include "imageprocessing/filtering/GrayscaleFilter.hpp"
@@ -66,7 +67,7 @@ int main(int argc, char **argv) {
 	int maxWidth = 0;
 	int repetitions = 25;
 
-	shared_ptr<DlibImageSource> images = make_shared<DlibImageSource>(annotationFile);
+	shared_ptr<AnnotatedImageSource> images = make_shared<PrefetchingImageSource>(make_shared<DlibImageSource>(annotationFile));
 	shared_ptr<ProbabilisticSupportVectorMachine> svm = loadSvm(svmFile, detectionThreshold);
 	int binCount = (svm->getSvm()->getSupportVectors()[0].channels() - 4) / 3;
 	int windowWidth = svm->getSvm()->getSupportVectors()[0].cols;
@@ -104,9 +105,14 @@ int main(int argc, char **argv) {
 }
 
 shared_ptr<ProbabilisticSupportVectorMachine> loadSvm(const string& filename, float threshold) {
-	ifstream stream(filename);
-	shared_ptr<ProbabilisticSupportVectorMachine> svm = ProbabilisticSupportVectorMachine::load(stream);
-	stream.close();
+	shared_ptr<ProbabilisticSupportVectorMachine> svm;
+	if (SupportVectorMachine::isBinary(filename)) {
+		svm = ProbabilisticSupportVectorMachine::loadBinary(filename);
+	} else {
+		ifstream stream(filename);
+		svm = ProbabilisticSupportVectorMachine::load(stream);
+		stream.close();
+	}
 	svm->getSvm()->setThreshold(threshold);
 	svm->setLogisticB(0.0);
 	return svm;
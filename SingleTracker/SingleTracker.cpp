@@ -19,14 +19,15 @@ using namespace std;
 using namespace std::chrono;
 
 int main(int argc, char **argv) {
-	if (argc != 7) {
-		cout << "usage: " << argv[0] << " annotations bins cellsize targetsize padding adaptation" << endl;
+	if (argc != 7 && argc != 8) {
+		cout << "usage: " << argv[0] << " annotations bins cellsize targetsize padding adaptation [scalesteps]" << endl;
 		cout << "  annotation: XML-file that contains image paths and annotations in dlib format" << endl;
 		cout << "  bins: number of bins in unsigned orientation histogram" << endl;
 		cout << "  cellsize: size of the square FHOG cells in pixels" << endl;
 		cout << "  targetsize: size of the target in FHOG cells (larger one of width or height)" << endl;
 		cout << "  padding: number of cells around the previous target position that is searched for the new position" << endl;
 		cout << "  adaptation: weight of the new SVM parameters (between zero and one)" << endl;
+		cout << "  scalesteps: number of scales searched in each direction using a single shared feature window per frame (optional)" << endl;
 		return EXIT_FAILURE;
 	}
 	string annotationFile = argv[1];
@@ -36,6 +37,8 @@ int main(int argc, char **argv) {
 	int padding = stoi(argv[5]);
 	double adaptationRate = stof(argv[6]);
 	tracking::SingleTracker tracker(binCount, cellSize, targetSize, padding, 1.05, 10, adaptationRate);
+	if (argc == 8)
+		tracker.setSharedFeatureWindow(true, stoi(argv[7]));
 	Scalar color(0, 255, 0);
 	int thickness = 2;
 
@@ -10,6 +10,7 @@
 
 #include "opencv2/core/core.hpp"
 #include <utility>
+#include <vector>
 
 namespace classification {
 
@@ -38,6 +39,21 @@ public:
 	 * @return A pair containing the binary classification result and the confidence of the classification.
 	 */
 	virtual std::pair<bool, double> getConfidence(const cv::Mat& featureVector) const = 0;
+
+	/**
+	 * Computes the classification confidences of several feature vectors. Classifiers that can process several
+	 * feature vectors more efficiently at once should override this function.
+	 *
+	 * @param[in] featureVectors The feature vectors.
+	 * @return Pairs containing the binary classification result and the confidence of the classification.
+	 */
+	virtual std::vector<std::pair<bool, double>> getConfidences(const std::vector<cv::Mat>& featureVectors) const {
+		std::vector<std::pair<bool, double>> confidences;
+		confidences.reserve(featureVectors.size());
+		for (const cv::Mat& featureVector : featureVectors)
+			confidences.push_back(getConfidence(featureVector));
+		return confidences;
+	}
 };
 
 } /* namespace classification */
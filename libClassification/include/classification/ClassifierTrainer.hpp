@@ -8,6 +8,7 @@
 #ifndef CLASSIFICATION_CLASSIFIERTRAINER_HPP_
 #define CLASSIFICATION_CLASSIFIERTRAINER_HPP_
 
+#include "classification/ExampleStore.hpp"
 #include "opencv2/core/core.hpp"
 #include <vector>
 
@@ -30,6 +31,19 @@ public:
 	 * @param[in] negatives Negative training examples.
 	 */
 	virtual void train(T& classifier, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const = 0;
+
+	/**
+	 * Trains the classifier with the positive and negative training examples of compact example stores. By default,
+	 * the examples are retrieved as matrices, which refer to the stored data in case of single-precision stores.
+	 * Trainers that can operate on the stores directly should override this function.
+	 *
+	 * @param[in] classifier Classifier to train.
+	 * @param[in] positives Positive training examples.
+	 * @param[in] negatives Negative training examples.
+	 */
+	virtual void train(T& classifier, const ExampleStore& positives, const ExampleStore& negatives) const {
+		train(classifier, positives.getExamples(), negatives.getExamples());
+	}
 };
 
 } /* namespace classification */
@@ -8,6 +8,7 @@
 #ifndef CLASSIFICATION_EXAMPLEMANAGEMENT_HPP_
 #define CLASSIFICATION_EXAMPLEMANAGEMENT_HPP_
 
+#include "classification/ExampleStore.hpp"
 #include "opencv2/core/core.hpp"
 #include <vector>
 #include <memory>
@@ -17,6 +18,10 @@ namespace classification {
 /**
  * Stores and manages examples for training a classifier. Typically, the amount of training examples is budgeted,
  * meaning that there is a maximum amount of training examples that may be stored at a time.
+ *
+ * By default, the examples are kept as separate matrices in a vector. If an example store is set, then the examples
+ * are copied into the compact store instead and the vector remains empty. Subclasses should therefore access the
+ * examples via size(), get(size_t), append(const cv::Mat&), and replace(size_t, const cv::Mat&).
  */
 class ExampleManagement {
 public:
@@ -26,7 +31,7 @@ public:
 	 *
 	 * @param[in] capacity Maximum amount of stored training examples.
 	 */
-	explicit ExampleManagement(size_t capacity) {
+	explicit ExampleManagement(size_t capacity) : capacity(capacity) {
 		examples.reserve(capacity);
 	}
 
@@ -44,9 +49,87 @@ public:
 	 */
 	virtual void clear()  {
 		examples.clear();
+		if (store)
+			store->clear();
+	}
+
+	/**
+	 * Changes the storage of the training examples. Existing training examples are moved into the new store.
+	 *
+	 * @param[in] store Compact storage of the training examples; null to keep them as separate matrices.
+	 */
+	void setStore(std::shared_ptr<ExampleStore> store) {
+		if (store) {
+			store->clear();
+			for (size_t i = 0; i < size(); ++i)
+				store->add(get(i));
+			examples.clear();
+		} else if (this->store) {
+			examples = this->store->getExamples();
+		}
+		this->store = store;
+	}
+
+	/**
+	 * @return Compact storage of the training examples; null if they are kept as separate matrices.
+	 */
+	const std::shared_ptr<ExampleStore>& getStore() const {
+		return store;
+	}
+
+	/**
+	 * @return Number of stored training examples.
+	 */
+	size_t size() const {
+		return store ? store->size() : examples.size();
+	}
+
+	/**
+	 * @param[in] index Index of the training example.
+	 * @return Training example (might be a decoded copy if the store uses reduced precision).
+	 */
+	cv::Mat get(size_t index) const {
+		return store ? store->get(index) : examples[index];
+	}
+
+	/**
+	 * @return All training examples (might be decoded copies if the store uses reduced precision).
+	 */
+	std::vector<cv::Mat> getExamples() const {
+		return store ? store->getExamples() : examples;
+	}
+
+	std::vector<cv::Mat> examples; ///< Stored training examples (empty if there is an example store).
+
+protected:
+
+	/**
+	 * Appends a training example.
+	 *
+	 * @param[in] example Training example to add.
+	 */
+	void append(const cv::Mat& example) {
+		if (store)
+			store->add(example);
+		else
+			examples.push_back(example);
+	}
+
+	/**
+	 * Replaces an existing training example.
+	 *
+	 * @param[in] index Index of the training example to replace.
+	 * @param[in] example New training example.
+	 */
+	void replace(size_t index, const cv::Mat& example) {
+		if (store)
+			store->set(index, example);
+		else
+			examples[index] = example;
 	}
 
-	std::vector<cv::Mat> examples; ///< Stored training examples.
+	size_t capacity; ///< Maximum amount of stored training examples.
+	std::shared_ptr<ExampleStore> store; ///< Compact storage of the training examples (null if not used).
 };
 
 } /* namespace classification */
@@ -0,0 +1,198 @@
+/*
+ * ExampleStore.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef CLASSIFICATION_EXAMPLESTORE_HPP_
+#define CLASSIFICATION_EXAMPLESTORE_HPP_
+
+#include "opencv2/core/core.hpp"
+#include <vector>
+
+namespace classification {
+
+/**
+ * Compact storage of training examples of equal size.
+ *
+ * The examples are stored as rows of large matrices (chunks) instead of separately allocated matrices, so there is
+ * no per-example overhead and consecutive examples are adjacent in memory. Because full chunks are never moved,
+ * the rows stay at the same memory location until they are replaced or the store is cleared.
+ *
+ * Each row has a generation that changes whenever an example is written to it, so examples can be identified by
+ * their data pointer and generation across changes of the store (e.g. by warm-started trainers).
+ *
+ * Optionally, the values are stored with reduced precision, either as half-precision floating point numbers or as
+ * 8-bit integers with a separate scale factor per example and channel. The linear algebra operations work on the
+ * stored values directly, so trainers can stream through the examples without decoding them first.
+ */
+class ExampleStore {
+public:
+
+	/**
+	 * Precision of the stored values.
+	 */
+	enum class Precision {
+		FLOAT32, ///< Single-precision floating point numbers (exact, examples can be accessed without copying).
+		FLOAT16, ///< Half-precision floating point numbers (half the memory, about three significant digits).
+		INT8 ///< 8-bit integers scaled per example and channel (a quarter of the memory, 1/127 of the maximum value per channel).
+	};
+
+	/**
+	 * Constructs a new empty example store.
+	 *
+	 * @param[in] precision Precision of the stored values.
+	 * @param[in] rowsPerChunk Number of examples per allocated chunk of memory.
+	 */
+	explicit ExampleStore(Precision precision = Precision::FLOAT32, int rowsPerChunk = 4096);
+
+	/**
+	 * Appends an example. The first example determines the size, type, and number of channels of all examples.
+	 *
+	 * @param[in] example Example that is converted to the store's precision.
+	 * @return Index of the new example.
+	 */
+	size_t add(const cv::Mat& example);
+
+	/**
+	 * Replaces an existing example.
+	 *
+	 * @param[in] index Index of the example to replace.
+	 * @param[in] example Example that is converted to the store's precision.
+	 */
+	void set(size_t index, const cv::Mat& example);
+
+	/**
+	 * Removes all examples and frees the memory.
+	 */
+	void clear();
+
+	/**
+	 * Retrieves an example with its original size and number of channels. In case of single-precision storage, the
+	 * returned matrix refers to the stored data, otherwise it is a decoded copy.
+	 *
+	 * @param[in] index Index of the example.
+	 * @return Example of depth CV_32F.
+	 */
+	cv::Mat get(size_t index) const;
+
+	/**
+	 * @return All examples, see get(size_t).
+	 */
+	std::vector<cv::Mat> getExamples() const;
+
+	/**
+	 * Decodes the values of an example.
+	 *
+	 * @param[in] index Index of the example.
+	 * @param[out] values Array of at least getDimensions() elements that receives the values.
+	 */
+	void decode(size_t index, float* values) const;
+
+	/**
+	 * Computes the dot product of an example and a vector.
+	 *
+	 * @param[in] index Index of the example.
+	 * @param[in] vector Array of getDimensions() elements.
+	 * @return Dot product.
+	 */
+	float dot(size_t index, const float* vector) const;
+
+	/**
+	 * Adds a multiple of an example to a vector.
+	 *
+	 * @param[in] index Index of the example.
+	 * @param[in] factor Factor that the example is multiplied with.
+	 * @param[in,out] vector Array of getDimensions() elements that the scaled example is added to.
+	 */
+	void addScaled(size_t index, float factor, float* vector) const;
+
+	/**
+	 * @param[in] index Index of the example.
+	 * @return Squared euclidean norm of the example.
+	 */
+	float squaredNorm(size_t index) const;
+
+	/**
+	 * @param[in] index Index of the example.
+	 * @return Pointer to the stored data of the example, which identifies it together with its generation.
+	 */
+	const uchar* data(size_t index) const;
+
+	/**
+	 * @param[in] index Index of the example.
+	 * @return Generation of the example, which is unique among all examples that were written to the store.
+	 */
+	size_t getGeneration(size_t index) const {
+		return generations[index];
+	}
+
+	/**
+	 * @return Number of stored examples.
+	 */
+	size_t size() const {
+		return count;
+	}
+
+	/**
+	 * @return True if there are no examples, false otherwise.
+	 */
+	bool empty() const {
+		return count == 0;
+	}
+
+	/**
+	 * @return Number of values per example.
+	 */
+	int getDimensions() const {
+		return dimensions;
+	}
+
+	/**
+	 * @return Precision of the stored values.
+	 */
+	Precision getPrecision() const {
+		return precision;
+	}
+
+private:
+
+	/**
+	 * Converts an example to a continuous single-precision row vector, checking its size.
+	 *
+	 * @param[in] example Example to convert.
+	 * @return Continuous row vector of type CV_32FC1 (may refer to the example's data).
+	 */
+	cv::Mat toRow(const cv::Mat& example) const;
+
+	/**
+	 * Encodes the values of an example into its storage row.
+	 *
+	 * @param[in] index Index of the example.
+	 * @param[in] values Continuous row vector of type CV_32FC1.
+	 */
+	void encode(size_t index, const cv::Mat& values);
+
+	/**
+	 * @param[in] index Index of the example.
+	 * @return Per-channel scale factors of the example (only valid for INT8 precision).
+	 */
+	const float* scales(size_t index) const;
+
+	Precision precision; ///< Precision of the stored values.
+	int rowsPerChunk; ///< Number of examples per chunk.
+	int exampleRows; ///< Number of rows of the examples.
+	int exampleCols; ///< Number of columns of the examples.
+	int channels; ///< Number of channels of the examples.
+	int dimensions; ///< Number of values per example.
+	size_t count; ///< Number of stored examples.
+	size_t nextGeneration; ///< Generation of the next written example (not reset when clearing the store).
+	std::vector<size_t> generations; ///< Generations of the stored examples.
+	std::vector<cv::Mat> chunks; ///< Matrices containing the encoded examples as rows.
+	std::vector<cv::Mat> scaleChunks; ///< Matrices containing the per-channel scale factors (INT8 precision only).
+};
+
+} /* namespace classification */
+
+#endif /* CLASSIFICATION_EXAMPLESTORE_HPP_ */
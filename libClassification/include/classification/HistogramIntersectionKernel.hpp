@@ -26,12 +26,12 @@ public:
 	HistogramIntersectionKernel() {}
 
 	double compute(const cv::Mat& lhs, const cv::Mat& rhs) const {
-		if (!lhs.isContinuous() || !rhs.isContinuous())
-			throw std::invalid_argument("HistogramIntersectionKernel: arguments have to be continuous");
-		if (lhs.flags != rhs.flags)
+		if (lhs.type() != rhs.type())
 			throw std::invalid_argument("HistogramIntersectionKernel: arguments have to have the same type");
 		if (lhs.rows * lhs.cols != rhs.rows * rhs.cols)
 			throw std::invalid_argument("HistogramIntersectionKernel: arguments have to have the same length");
+		if ((!lhs.isContinuous() || !rhs.isContinuous()) && (lhs.rows != rhs.rows || lhs.cols != rhs.cols))
+			throw std::invalid_argument("HistogramIntersectionKernel: arguments that are not continuous have to have the same size");
 		return computeSumOfMinimums(lhs, rhs);
 	}
 
@@ -65,12 +65,15 @@ private:
 	 * @return The sum of the minimums.
 	 */
 	int computeSumOfMinimums_uchar(const cv::Mat& lhs, const cv::Mat& rhs) const {
-		const uchar* lvalues = lhs.ptr<uchar>();
-		const uchar* rvalues = rhs.ptr<uchar>();
+		int rows = getRowCount(lhs, rhs);
+		size_t size = lhs.total() * lhs.channels() / rows;
 		int sum = 0;
-		size_t size = lhs.total() * lhs.channels();
-		for (size_t i = 0; i < size; ++i)
-			sum += std::min(lvalues[i], rvalues[i]);
+		for (int row = 0; row < rows; ++row) {
+			const uchar* lvalues = lhs.ptr<uchar>(row);
+			const uchar* rvalues = rhs.ptr<uchar>(row);
+			for (size_t i = 0; i < size; ++i)
+				sum += std::min(lvalues[i], rvalues[i]);
+		}
 		return sum;
 	}
 
@@ -83,12 +86,15 @@ private:
 	 */
 	template<class T>
 	float computeSumOfMinimums_any(const cv::Mat& lhs, const cv::Mat& rhs) const {
-		const T* lvalues = lhs.ptr<T>();
-		const T* rvalues = rhs.ptr<T>();
+		int rows = getRowCount(lhs, rhs);
+		size_t size = lhs.total() * lhs.channels() / rows;
 		float sum = 0;
-		size_t size = lhs.total() * lhs.channels();
-		for (size_t i = 0; i < size; ++i)
-			sum += std::min(lvalues[i], rvalues[i]);
+		for (int row = 0; row < rows; ++row) {
+			const T* lvalues = lhs.ptr<T>(row);
+			const T* rvalues = rhs.ptr<T>(row);
+			for (size_t i = 0; i < size; ++i)
+				sum += std::min(lvalues[i], rvalues[i]);
+		}
 		return sum;
 	}
 };
@@ -0,0 +1,101 @@
+/*
+ * HistogramIntersectionLookupTable.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef CLASSIFICATION_HISTOGRAMINTERSECTIONLOOKUPTABLE_HPP_
+#define CLASSIFICATION_HISTOGRAMINTERSECTIONLOOKUPTABLE_HPP_
+
+#include "classification/KernelEvaluator.hpp"
+#include "opencv2/core/core.hpp"
+#include <vector>
+
+namespace classification {
+
+/**
+ * Piecewise-linear approximation of the decision function of an SVM with histogram intersection kernel, following
+ * Maji et al., "Classification using Intersection Kernel Support Vector Machines is Efficient" (CVPR 2008).
+ *
+ * The sum over the weighted kernel values decomposes into one function per dimension,
+ * h_d(s) = sum_i coefficient_i * min(s, supportVector_i[d]), which is sampled at equally spaced points between the
+ * smallest and largest support vector value of the dimension. Evaluating a feature vector interpolates linearly
+ * between the two nearest samples of each dimension, so the costs are independent of the number of support vectors.
+ * Below the smallest and above the largest support vector value, the function is linear or constant, respectively,
+ * and is extrapolated exactly.
+ */
+class HistogramIntersectionLookupTable : public KernelEvaluator {
+public:
+
+	/**
+	 * Constructs a new lookup table.
+	 *
+	 * @param[in] supportVectors Support vectors of equal size and of depth CV_8U, CV_32S, or CV_32F.
+	 * @param[in] coefficients Coefficients of the support vectors.
+	 * @param[in] binCount Number of samples per dimension (at least two).
+	 */
+	HistogramIntersectionLookupTable(const std::vector<cv::Mat>& supportVectors,
+			const std::vector<float>& coefficients, int binCount = 100);
+
+	double compute(const cv::Mat& featureVector) const override;
+
+private:
+
+	/**
+	 * Computes the approximated sum over the weighted kernel values row by row, so feature vectors that are not
+	 * continuous (e.g. views into a feature pyramid) do not have to be copied.
+	 *
+	 * @param[in] featureVector Feature vector of the same size as the support vectors.
+	 * @return Sum over the interpolated per-dimension functions.
+	 */
+	template <typename T>
+	double computeByRows(const cv::Mat& featureVector) const {
+		int rowSize = featureVector.cols * featureVector.channels();
+		double sum = 0;
+		for (int row = 0; row < featureVector.rows; ++row)
+			sum += compute(featureVector.ptr<T>(row), row * rowSize, rowSize);
+		return sum;
+	}
+
+	/**
+	 * Computes the approximated sum over the weighted kernel values of a feature vector or a part of it.
+	 *
+	 * @param[in] values Values of the feature vector, starting at the first dimension.
+	 * @param[in] first Index of the first dimension.
+	 * @param[in] count Number of dimensions.
+	 * @return Sum over the interpolated per-dimension functions.
+	 */
+	template <typename T>
+	double compute(const T* values, int first, int count) const {
+		double sum = 0;
+		for (int d = first, i = 0; i < count; ++d, ++i) {
+			const float* samples = table.ptr<float>(d);
+			if (values[i] <= minimums[d]) {
+				sum += values[i] * coefficientSum;
+				continue;
+			}
+			double position = (values[i] - minimums[d]) * inverseSteps[d];
+			if (position >= binCount - 1) {
+				sum += samples[binCount - 1];
+			} else {
+				int bin = static_cast<int>(position);
+				double weight = position - bin;
+				sum += (1 - weight) * samples[bin] + weight * samples[bin + 1];
+			}
+		}
+		return sum;
+	}
+
+	int binCount; ///< Number of samples per dimension.
+	int dimensions; ///< Number of values per feature vector.
+	int type; ///< Type of the feature vectors.
+	double coefficientSum; ///< Sum over the coefficients of the support vectors (slope below the smallest value).
+	std::vector<float> minimums; ///< Smallest support vector value per dimension (position of the first sample).
+	std::vector<float> inverseSteps; ///< Inverse distance between two samples per dimension (infinite if all values are equal).
+	cv::Mat table; ///< Samples of the per-dimension functions, one row per dimension.
+};
+
+} /* namespace classification */
+
+#endif /* CLASSIFICATION_HISTOGRAMINTERSECTIONLOOKUPTABLE_HPP_ */
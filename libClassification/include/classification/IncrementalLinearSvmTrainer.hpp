@@ -35,17 +35,26 @@ public:
 			throw std::invalid_argument("IncrementalLinearSvmTrainer: the learn rate must be between zero (inclusive) and one (inclusive)");
 	}
 
+	using ClassifierTrainer<SupportVectorMachine>::train;
+
 	void train(SupportVectorMachine& svm, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const override {
 		if (!dynamic_cast<LinearKernel*>(svm.getKernel().get()))
 			throw std::invalid_argument("IncrementalLinearSvmTrainer: the SVM must use a LinearKernel");
 		batchTrainer->train(batchSvm, positives, negatives);
 	  cv::Mat weight = batchSvm.getSupportVectors()[0];
 	  double bias = batchSvm.getBias();
-		svm.setSupportVectors(std::vector<cv::Mat>{weight});
-		svm.setCoefficients(std::vector<float>{1});
+		svm.setSupportVectorsAndCoefficients(std::vector<cv::Mat>{weight}, std::vector<float>{1});
 		svm.setBias(bias);
 	}
 
+	void train(SupportVectorMachine& svm, const ExampleStore& positives, const ExampleStore& negatives) const override {
+		if (!dynamic_cast<LinearKernel*>(svm.getKernel().get()))
+			throw std::invalid_argument("IncrementalLinearSvmTrainer: the SVM must use a LinearKernel");
+		batchTrainer->train(batchSvm, positives, negatives);
+		svm.setSupportVectorsAndCoefficients(std::vector<cv::Mat>{batchSvm.getSupportVectors()[0]}, std::vector<float>{1});
+		svm.setBias(batchSvm.getBias());
+	}
+
 	void retrain(SupportVectorMachine& svm, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const override {
 		if (!dynamic_cast<LinearKernel*>(svm.getKernel().get()))
 			throw std::invalid_argument("IncrementalLinearSvmTrainer: the SVM must use a LinearKernel");
@@ -54,8 +63,7 @@ public:
 		batchTrainer->train(batchSvm, positives, negatives);
 		cv::Mat weight = (1 - learnRate) * svm.getSupportVectors()[0] + learnRate * batchSvm.getSupportVectors()[0];
 		double bias = (1 - learnRate) * svm.getBias() + learnRate * batchSvm.getBias();
-		svm.setSupportVectors(std::vector<cv::Mat>{weight});
-		svm.setCoefficients(std::vector<float>{1});
+		svm.setSupportVectorsAndCoefficients(std::vector<cv::Mat>{weight}, std::vector<float>{1});
 		svm.setBias(bias);
 	}
 
@@ -37,6 +37,20 @@ public:
 	 * @param[in] visitor The visitor.
 	 */
 	virtual void accept(KernelVisitor& visitor) const = 0;
+
+protected:
+
+	/**
+	 * Determines the number of rows that two vectors of equal length are processed in. Continuous vectors are processed
+	 * as a single row, others (e.g. views into a larger matrix) row by row, which requires them to have the same size.
+	 *
+	 * @param[in] lhs The first vector.
+	 * @param[in] rhs The second vector.
+	 * @return The number of rows.
+	 */
+	static int getRowCount(const cv::Mat& lhs, const cv::Mat& rhs) {
+		return lhs.isContinuous() && rhs.isContinuous() ? 1 : lhs.rows;
+	}
 };
 
 } /* namespace classification */
@@ -0,0 +1,58 @@
+/*
+ * KernelEvaluator.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef CLASSIFICATION_KERNELEVALUATOR_HPP_
+#define CLASSIFICATION_KERNELEVALUATOR_HPP_
+
+#include "classification/Kernel.hpp"
+#include "opencv2/core/core.hpp"
+#include <memory>
+#include <vector>
+
+namespace classification {
+
+/**
+ * Computes the sum over the weighted kernel values of a feature vector and the support vectors of an SVM.
+ *
+ * The implementations are specialized for the kernel type and the depth of the values at compile time and use AVX2
+ * instructions if the CPU supports them. The matching implementation is selected once on creation, so there is
+ * neither a switch over the depth nor a virtual kernel call per support vector when evaluating feature vectors.
+ */
+class KernelEvaluator {
+public:
+
+	virtual ~KernelEvaluator() {}
+
+	/**
+	 * Computes the sum over the weighted kernel values of a feature vector and all support vectors.
+	 *
+	 * @param[in] featureVector Feature vector of the same size and depth as the support vectors.
+	 * @return Sum over the kernel values multiplied by the coefficients of the support vectors.
+	 */
+	virtual double compute(const cv::Mat& featureVector) const = 0;
+
+	/**
+	 * Creates the kernel evaluator that is specialized for the given kernel and support vectors.
+	 *
+	 * @param[in] kernel Kernel function.
+	 * @param[in] supportVectors Support vectors of equal size and of depth CV_8U, CV_32S, or CV_32F.
+	 * @param[in] coefficients Coefficients of the support vectors.
+	 * @return Kernel evaluator that holds a copy of the support vectors (or refers to them if they are adjacent in memory,
+	 *         like memory-mapped ones), null if there is no implementation for the depth.
+	 */
+	static std::unique_ptr<KernelEvaluator> create(const Kernel& kernel,
+			const std::vector<cv::Mat>& supportVectors, const std::vector<float>& coefficients);
+
+	/**
+	 * @return True if the AVX2 implementations are used, false otherwise.
+	 */
+	static bool isAvx2Supported();
+};
+
+} /* namespace classification */
+
+#endif /* CLASSIFICATION_KERNELEVALUATOR_HPP_ */
@@ -0,0 +1,207 @@
+/*
+ * LinearSvmTrainer.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef CLASSIFICATION_LINEARSVMTRAINER_HPP_
+#define CLASSIFICATION_LINEARSVMTRAINER_HPP_
+
+#include "classification/ClassifierTrainer.hpp"
+#include "classification/ExampleStore.hpp"
+#include "classification/ProbabilisticSupportVectorMachine.hpp"
+#include "classification/SupportVectorMachine.hpp"
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <utility>
+
+namespace classification {
+
+/**
+ * Batch trainer of linear SVMs that solves the dual problem by coordinate descent with shrinking, as done by
+ * LIBLINEAR. In contrast to kernelized solvers, the cost of each pass over the data is linear in the number of
+ * training examples and the weight vector is updated directly, so there are no support vectors to collapse.
+ *
+ * The bias is learned by appending a constant feature of one to the feature vectors (and is regularized as well).
+ * Probabilistic SVMs get their logistic parameters by Platt scaling of cross-validated SVM scores. The optimization
+ * operates on compact example stores, so stores of reduced precision are used without decoding them first.
+ *
+ * With warm start enabled, the dual variables of the previous training are kept and used to initialize the next
+ * training for all examples that were already part of it (identified by their data pointer, so the examples must
+ * not be copied in between, and by the generation of their row in case of example stores, so replaced rows count as
+ * new examples). Initially, only the support vectors and new examples are optimized, the remaining ones are checked
+ * before stopping. This makes repeated training on a slowly growing set of examples, as done by
+ * bootstrapping, almost as cheap as training on the new examples only.
+ */
+class LinearSvmTrainer :
+		public ClassifierTrainer<SupportVectorMachine>,
+		public ClassifierTrainer<ProbabilisticSupportVectorMachine> {
+public:
+
+	/**
+	 * Constructs a new linear SVM trainer.
+	 *
+	 * @param[in] c Penalty multiplier C of the misclassification losses.
+	 * @param[in] compensateImbalance Flag that indicates whether to adjust class weights to compensate for unbalanced data.
+	 * @param[in] maxIterations Maximum number of passes over the training examples.
+	 * @param[in] epsilon Tolerance of the stopping criterion based on the projected gradient.
+	 * @param[in] warmStart Flag that indicates whether to initialize each training with the result of the previous one.
+	 */
+	LinearSvmTrainer(double c, bool compensateImbalance, int maxIterations = 1000, double epsilon = 0.1, bool warmStart = false);
+
+	void train(SupportVectorMachine& svm, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const override;
+
+	void train(ProbabilisticSupportVectorMachine& svm,
+			const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const override;
+
+	void train(SupportVectorMachine& svm, const ExampleStore& positives, const ExampleStore& negatives) const override;
+
+	void train(ProbabilisticSupportVectorMachine& svm, const ExampleStore& positives, const ExampleStore& negatives) const override;
+
+private:
+
+	/**
+	 * Key that identifies a training example across trainings, consisting of its data pointer and the generation of
+	 * its example store row (zero for examples given as matrices).
+	 */
+	typedef std::pair<const uchar*, size_t> ExampleKey;
+
+	/**
+	 * Hash function of example keys.
+	 */
+	struct ExampleKeyHash {
+		size_t operator()(const ExampleKey& key) const {
+			return std::hash<const uchar*>()(key.first) ^ (std::hash<size_t>()(key.second) * 31);
+		}
+	};
+
+	/**
+	 * Positive and negative training examples that are indexed consecutively, starting with the positive ones. The
+	 * examples are extended by a trailing constant feature of one, so weight vectors contain the bias as last element.
+	 */
+	struct TrainingSet {
+		const ExampleStore& positives; ///< Positive training examples.
+		const ExampleStore& negatives; ///< Negative training examples.
+		size_t size() const;
+		float label(size_t index) const;
+		float dot(size_t index, const float* weights) const;
+		void addScaled(size_t index, float factor, float* weights) const;
+		float squaredNorm(size_t index) const;
+	};
+
+	/**
+	 * Sets the logistic parameters of a probabilistic SVM by Platt scaling.
+	 *
+	 * @param[in] svm Probabilistic SVM whose logistic parameters are set.
+	 * @param[in] examples Training examples.
+	 */
+	void setLogisticParameters(ProbabilisticSupportVectorMachine& svm, const TrainingSet& examples) const;
+
+	/**
+	 * Computes the weight vector of all training examples, warm-started from the previous training if enabled.
+	 *
+	 * @param[in] examples Training examples.
+	 * @param[in] keys Keys that identify the training examples across trainings.
+	 * @return Row vector containing the weights followed by the bias term.
+	 */
+	cv::Mat optimize(const TrainingSet& examples, const std::vector<ExampleKey>& keys) const;
+
+	/**
+	 * Computes the weight vector of a subset of the training examples.
+	 *
+	 * @param[in] examples Training examples.
+	 * @param[in] indices Indices of the training examples to use.
+	 * @return Row vector containing the weights followed by the bias term.
+	 */
+	cv::Mat optimize(const TrainingSet& examples, const std::vector<int>& indices) const;
+
+	/**
+	 * Computes the weight vector of a subset of the training examples, starting from the given dual variables.
+	 *
+	 * @param[in] examples Training examples.
+	 * @param[in] indices Indices of the training examples to use.
+	 * @param[in,out] alphas Initial dual variables of the indexed training examples, replaced by the optimized ones.
+	 * @param[in] known Flags that indicate which dual variables were initialized by a previous training (may be empty).
+	 * @return Row vector containing the weights followed by the bias term.
+	 */
+	cv::Mat optimize(const TrainingSet& examples, const std::vector<int>& indices,
+			std::vector<float>& alphas, const std::vector<bool>& known) const;
+
+	/**
+	 * Computes the SVM scores of all training examples using cross-validation.
+	 *
+	 * @param[in] examples Training examples.
+	 * @return SVM scores of the training examples, each computed by an SVM that was not trained on it.
+	 */
+	std::vector<double> computeCrossValidatedScores(const TrainingSet& examples) const;
+
+	/**
+	 * Fits the parameters of the logistic function 1 / (1 + exp(a * score + b)) to the SVM scores using Platt's
+	 * method with the improvements of Lin et al. (Newton's method with backtracking line search).
+	 *
+	 * @param[in] scores SVM scores of the training examples.
+	 * @param[in] labels Labels of the training examples (+1 or -1).
+	 * @return Pair of the logistic parameters a and b.
+	 */
+	std::pair<double, double> fitLogisticParameters(const std::vector<double>& scores, const std::vector<float>& labels) const;
+
+	/**
+	 * Copies the training examples into single-precision example stores.
+	 *
+	 * @param[out] positiveStore Store that receives the positive training examples.
+	 * @param[out] negativeStore Store that receives the negative training examples.
+	 * @param[in] positives Positive training examples.
+	 * @param[in] negatives Negative training examples.
+	 * @return Training set that refers to the stores.
+	 */
+	TrainingSet createTrainingSet(ExampleStore& positiveStore, ExampleStore& negativeStore,
+			const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const;
+
+	/**
+	 * Creates a training set from example stores, checking their dimensions.
+	 *
+	 * @param[in] positives Positive training examples.
+	 * @param[in] negatives Negative training examples.
+	 * @return Training set that refers to the stores.
+	 */
+	TrainingSet createTrainingSet(const ExampleStore& positives, const ExampleStore& negatives) const;
+
+	/**
+	 * @param[in] positives Positive training examples.
+	 * @param[in] negatives Negative training examples.
+	 * @return Keys of the training examples.
+	 */
+	std::vector<ExampleKey> getExampleKeys(const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const;
+
+	/**
+	 * @param[in] positives Positive training examples.
+	 * @param[in] negatives Negative training examples.
+	 * @return Keys of the stored training examples.
+	 */
+	std::vector<ExampleKey> getExampleKeys(const ExampleStore& positives, const ExampleStore& negatives) const;
+
+	/**
+	 * Sets the SVM parameters from a row vector with the bias as last element.
+	 *
+	 * @param[in] svm Linear SVM whose parameters are set.
+	 * @param[in] weights Row vector containing the weights followed by the bias term.
+	 * @param[in] example Training example that determines the shape of the support vector.
+	 */
+	void setWeights(SupportVectorMachine& svm, const cv::Mat& weights, const cv::Mat& example) const;
+
+	double c; ///< Penalty multiplier C of the misclassification losses.
+	bool compensateImbalance; ///< Flag that indicates whether to adjust class weights to compensate for unbalanced data.
+	int maxIterations; ///< Maximum number of passes over the training examples.
+	double epsilon; ///< Tolerance of the stopping criterion based on the projected gradient.
+	int foldCount; ///< Number of folds of the cross-validation that computes the scores for Platt scaling.
+	bool warmStart; ///< Flag that indicates whether to initialize each training with the result of the previous one.
+	mutable int previousDimensions; ///< Dimensionality of the examples of the previous training.
+	mutable std::unordered_map<ExampleKey, float, ExampleKeyHash> previousAlphas; ///< Dual variables of the previous training by example key.
+	mutable std::default_random_engine generator; ///< Random number generator that determines the order of the coordinates.
+};
+
+} /* namespace classification */
+
+#endif /* CLASSIFICATION_LINEARSVMTRAINER_HPP_ */
@@ -0,0 +1,95 @@
+/*
+ * OnlineLinearSvmTrainer.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef CLASSIFICATION_ONLINELINEARSVMTRAINER_HPP_
+#define CLASSIFICATION_ONLINELINEARSVMTRAINER_HPP_
+
+#include "classification/IncrementalClassifierTrainer.hpp"
+#include "classification/SupportVectorMachine.hpp"
+#include <random>
+
+namespace classification {
+
+/**
+ * Trainer of linear SVMs that solves the dual problem by coordinate descent directly on the single-precision
+ * feature data, without the need of a separate batch trainer.
+ *
+ * Retraining keeps the SVM close to its current weight vector by minimizing
+ * 0.5 * |w|^2 + 0.5 * r * |w - w_old|^2 + C * sum(hinge losses) with r = (1 - learnRate) / learnRate,
+ * whose solution is w = (1 - learnRate) * w_old + learnRate * sum(alpha_i * y_i * x_i). This resembles the
+ * weighted average of IncrementalLinearSvmTrainer, but the losses are computed using the combined weight vector.
+ * The bias is learned by appending a constant feature of one to the feature vectors.
+ */
+class OnlineLinearSvmTrainer : public IncrementalClassifierTrainer<SupportVectorMachine> {
+public:
+
+	/**
+	 * Constructs a new online linear SVM trainer.
+	 *
+	 * @param[in] c Penalty multiplier C of the misclassification losses.
+	 * @param[in] compensateImbalance Flag that indicates whether to adjust class weights to compensate for unbalanced data.
+	 * @param[in] learnRate Weight of the new training examples compared to the current weight vector (between zero and one, where zero disables retraining).
+	 * @param[in] maxIterations Maximum number of passes over the training examples.
+	 * @param[in] epsilon Tolerance of the stopping criterion based on the projected gradient.
+	 */
+	OnlineLinearSvmTrainer(double c, bool compensateImbalance, double learnRate, int maxIterations = 100, double epsilon = 1e-3);
+
+	using ClassifierTrainer<SupportVectorMachine>::train;
+
+	void train(SupportVectorMachine& svm, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const override;
+
+	void retrain(SupportVectorMachine& svm, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const override;
+
+private:
+
+	/**
+	 * Optimizes the weight vector given the training examples.
+	 *
+	 * @param[in,out] weights Row vector of the weights and the bias as last element, initialized with the current weights.
+	 * @param[in] scale Weight of the new solution compared to the initial weights (between zero and one).
+	 * @param[in] positives Positive training examples.
+	 * @param[in] negatives Negative training examples.
+	 */
+	void optimize(cv::Mat& weights, float scale, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const;
+
+	/**
+	 * Creates a matrix containing the training examples as rows with a trailing constant feature of one.
+	 *
+	 * @param[in] positives Positive training examples.
+	 * @param[in] negatives Negative training examples.
+	 * @return Matrix of type CV_32FC1 with one row per training example.
+	 */
+	cv::Mat createExampleMatrix(const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const;
+
+	/**
+	 * Copies the SVM parameters into a single-precision row vector with the bias as last element.
+	 *
+	 * @param[in] svm Linear SVM with a single support vector.
+	 * @return Row vector containing the weights followed by the bias term.
+	 */
+	cv::Mat getWeights(const SupportVectorMachine& svm) const;
+
+	/**
+	 * Sets the SVM parameters from a row vector with the bias as last element.
+	 *
+	 * @param[in] svm Linear SVM whose parameters are set.
+	 * @param[in] weights Row vector containing the weights followed by the bias term.
+	 * @param[in] example Training example that determines the shape of the support vector.
+	 */
+	void setWeights(SupportVectorMachine& svm, const cv::Mat& weights, const cv::Mat& example) const;
+
+	double c; ///< Penalty multiplier C of the misclassification losses.
+	bool compensateImbalance; ///< Flag that indicates whether to adjust class weights to compensate for unbalanced data.
+	double learnRate; ///< Weight of the new training examples compared to the current weight vector (between zero and one).
+	int maxIterations; ///< Maximum number of passes over the training examples.
+	double epsilon; ///< Tolerance of the stopping criterion based on the projected gradient.
+	mutable std::default_random_engine generator; ///< Random number generator that determines the order of the coordinates.
+};
+
+} /* namespace classification */
+
+#endif /* CLASSIFICATION_ONLINELINEARSVMTRAINER_HPP_ */
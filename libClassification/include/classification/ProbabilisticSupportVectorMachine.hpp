@@ -45,6 +45,8 @@ public:
 
 	std::pair<bool, double> getConfidence(const cv::Mat& featureVector) const;
 
+	std::vector<std::pair<bool, double>> getConfidences(const std::vector<cv::Mat>& featureVectors) const;
+
 	std::pair<bool, double> getProbability(const cv::Mat& featureVector) const;
 
 	/**
@@ -71,7 +73,7 @@ public:
 
 	/**
 	 * Creates a new probabilistic support vector machine from parameters (kernel, bias, coefficients, support vectors,
-	 * logistic) given in a text file.
+	 * logistic) given in a text file. If the file does not contain logistic parameters, the default ones are used.
 	 *
 	 * @param[in] file The file input stream to load the parameters from.
 	 * @return The newly created probabilistic support vector machine.
@@ -85,6 +87,22 @@ public:
 	 */
 	void store(std::ofstream& file);
 
+	/**
+	 * Creates a new probabilistic support vector machine from parameters given in a binary file, see
+	 * SupportVectorMachine::loadBinary. If the file does not contain logistic parameters, the default ones are used.
+	 *
+	 * @param[in] filename The name of the file to load the parameters from.
+	 * @return The newly created probabilistic support vector machine.
+	 */
+	static std::shared_ptr<ProbabilisticSupportVectorMachine> loadBinary(const std::string& filename);
+
+	/**
+	 * Stores the logistic and SVM parameters into a binary file, see SupportVectorMachine::storeBinary.
+	 *
+	 * @param[in] filename The name of the file to store the parameters into.
+	 */
+	void storeBinary(const std::string& filename) const;
+
 	/**
 	 * @return The wrapped support vector machine.
 	 */
@@ -28,6 +28,8 @@ public:
 			positiveExamples(std::make_unique<UnlimitedExampleManagement>()),
 			negativeExamples(std::make_unique<UnlimitedExampleManagement>()) {}
 
+	using ClassifierTrainer<T>::train;
+
 	void train(T& classifier, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const override {
 		positiveExamples->clear();
 		negativeExamples->clear();
@@ -38,7 +40,10 @@ public:
 		if (!positives.empty() || !negatives.empty()) {
 			positiveExamples->add(positives);
 			negativeExamples->add(negatives);
-			batchTrainer->train(classifier, positiveExamples->examples, negativeExamples->examples);
+			if (positiveExamples->getStore() && negativeExamples->getStore())
+				batchTrainer->train(classifier, *positiveExamples->getStore(), *negativeExamples->getStore());
+			else
+				batchTrainer->train(classifier, positiveExamples->getExamples(), negativeExamples->getExamples());
 		}
 	}
 
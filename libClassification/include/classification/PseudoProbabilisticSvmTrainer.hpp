@@ -48,12 +48,20 @@ public:
 			logisticA((std::log((1 - negProb) / negProb) - std::log((1 - posProb) / posProb)) / (meanNegOutput - meanPosOutput)),
 			logisticB(std::log((1 - posProb) / posProb) - logisticA * meanPosOutput) {}
 
+	using ClassifierTrainer<ProbabilisticSupportVectorMachine>::train;
+
 	void train(ProbabilisticSupportVectorMachine& svm, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const {
 		svmTrainer->train(*svm.getSvm(), positives, negatives);
 		svm.setLogisticA(logisticA);
 		svm.setLogisticB(logisticB);
 	}
 
+	void train(ProbabilisticSupportVectorMachine& svm, const ExampleStore& positives, const ExampleStore& negatives) const override {
+		svmTrainer->train(*svm.getSvm(), positives, negatives);
+		svm.setLogisticA(logisticA);
+		svm.setLogisticB(logisticB);
+	}
+
 	void retrain(ProbabilisticSupportVectorMachine& svm, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const {
 		svmTrainer->retrain(*svm.getSvm(), positives, negatives);
 		svm.setLogisticA(logisticA);
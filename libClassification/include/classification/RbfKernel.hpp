@@ -28,12 +28,12 @@ public:
 	explicit RbfKernel(double gamma) : gamma(gamma) {}
 
 	double compute(const cv::Mat& lhs, const cv::Mat& rhs) const {
-		if (!lhs.isContinuous() || !rhs.isContinuous())
-			throw std::invalid_argument("RbfKernel: arguments have to be continuous");
-		if (lhs.flags != rhs.flags)
+		if (lhs.type() != rhs.type())
 			throw std::invalid_argument("RbfKernel: arguments have to have the same type");
 		if (lhs.total() != rhs.total())
 			throw std::invalid_argument("RbfKernel: arguments have to have the same length");
+		if ((!lhs.isContinuous() || !rhs.isContinuous()) && (lhs.rows != rhs.rows || lhs.cols != rhs.cols))
+			throw std::invalid_argument("RbfKernel: arguments that are not continuous have to have the same size");
 		return exp(-gamma * computeSumOfSquaredDifferences(lhs, rhs));
 	}
 
@@ -74,13 +74,16 @@ private:
 	 * @return The sum of the squared differences.
 	 */
 	int computeSumOfSquaredDifferences_uchar(const cv::Mat& lhs, const cv::Mat& rhs) const {
-		const uchar* lvalues = lhs.ptr<uchar>();
-		const uchar* rvalues = rhs.ptr<uchar>();
+		int rows = getRowCount(lhs, rhs);
+		size_t size = lhs.total() * lhs.channels() / rows;
 		int sum = 0;
-		size_t size = lhs.total() * lhs.channels();
-		for (size_t i = 0; i < size; ++i) {
-			int diff = lvalues[i] - rvalues[i];
-			sum += diff * diff;
+		for (int row = 0; row < rows; ++row) {
+			const uchar* lvalues = lhs.ptr<uchar>(row);
+			const uchar* rvalues = rhs.ptr<uchar>(row);
+			for (size_t i = 0; i < size; ++i) {
+				int diff = lvalues[i] - rvalues[i];
+				sum += diff * diff;
+			}
 		}
 		return sum;
 	}
@@ -94,13 +97,16 @@ private:
 	 */
 	template<class T>
 	float computeSumOfSquaredDifferences_any(const cv::Mat& lhs, const cv::Mat& rhs) const {
-		const T* lvalues = lhs.ptr<T>();
-		const T* rvalues = rhs.ptr<T>();
+		int rows = getRowCount(lhs, rhs);
+		size_t size = lhs.total() * lhs.channels() / rows;
 		float sum = 0;
-		size_t size = lhs.total() * lhs.channels();
-		for (size_t i = 0; i < size; ++i) {
-			float diff = lvalues[i] - rvalues[i];
-			sum += diff * diff;
+		for (int row = 0; row < rows; ++row) {
+			const T* lvalues = lhs.ptr<T>(row);
+			const T* rvalues = rhs.ptr<T>(row);
+			for (size_t i = 0; i < size; ++i) {
+				float diff = lvalues[i] - rvalues[i];
+				sum += diff * diff;
+			}
 		}
 		return sum;
 	}
@@ -0,0 +1,70 @@
+/*
+ * ReducedSetApproximator.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef CLASSIFICATION_REDUCEDSETAPPROXIMATOR_HPP_
+#define CLASSIFICATION_REDUCEDSETAPPROXIMATOR_HPP_
+
+#include "classification/SupportVectorMachine.hpp"
+#include "opencv2/core/core.hpp"
+#include <memory>
+#include <vector>
+
+namespace classification {
+
+/**
+ * Approximates trained SVMs by SVMs with fewer support vectors (reduced set method of Burges and Schölkopf).
+ *
+ * The weight vector w = sum_i coefficient_i * phi(supportVector_i) in the feature space of the kernel is approximated
+ * by w' = sum_j beta_j * phi(z_j) with a user-chosen number of vectors z_j. These are added greedily: each new vector
+ * is the support vector with the largest normalized projection onto the residual w - w'. For RBF kernels and
+ * single-precision support vectors, the vector is refined by fixed-point iteration afterwards, so it is synthetic and
+ * not necessarily one of the original support vectors. After each addition, the coefficients beta are re-computed by
+ * least squares in feature space. Bias and threshold remain unchanged.
+ *
+ * Linear SVMs with single-precision support vectors are collapsed exactly into a single weight vector.
+ */
+class ReducedSetApproximator {
+public:
+
+	/**
+	 * Constructs a new reduced set approximator.
+	 *
+	 * @param[in] supportVectorCount Number of support vectors of the approximated SVMs.
+	 * @param[in] fixedPointIterations Maximum number of fixed-point iterations for refining a vector (RBF kernel only).
+	 */
+	explicit ReducedSetApproximator(int supportVectorCount, int fixedPointIterations = 20);
+
+	/**
+	 * Approximates an SVM. SVMs that do not have more support vectors than requested are copied.
+	 *
+	 * @param[in] svm Trained SVM.
+	 * @return New SVM with the same kernel, bias, and threshold, but at most the requested number of support vectors.
+	 */
+	std::shared_ptr<SupportVectorMachine> approximate(const SupportVectorMachine& svm) const;
+
+private:
+
+	/**
+	 * Refines a vector by the fixed-point iteration for RBF kernels, z = sum_k w_k K(y_k, z) y_k / sum_k w_k K(y_k, z),
+	 * that finds a local maximum of the projection onto the expansion sum_k w_k phi(y_k).
+	 *
+	 * @param[in] kernel Kernel function.
+	 * @param[in] vectors Vectors y_k of the expansion.
+	 * @param[in] weights Weights w_k of the expansion.
+	 * @param[in] initialVector Initial value of z.
+	 * @return Refined vector.
+	 */
+	cv::Mat refine(const Kernel& kernel, const std::vector<cv::Mat>& vectors, const std::vector<double>& weights,
+			const cv::Mat& initialVector) const;
+
+	int supportVectorCount; ///< Number of support vectors of the approximated SVMs.
+	int fixedPointIterations; ///< Maximum number of fixed-point iterations for refining a vector.
+};
+
+} /* namespace classification */
+
+#endif /* CLASSIFICATION_REDUCEDSETAPPROXIMATOR_HPP_ */
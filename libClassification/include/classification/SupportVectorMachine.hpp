@@ -10,11 +10,19 @@
 
 #include "classification/BinaryClassifier.hpp"
 #include "classification/Kernel.hpp"
+#include "classification/KernelEvaluator.hpp"
 #include "opencv2/core/core.hpp"
 #include <fstream>
 #include <memory>
+#include <string>
 #include <vector>
 
+namespace filemapping {
+
+class MappedFile;
+
+} /* namespace filemapping */
+
 namespace classification {
 
 /**
@@ -59,6 +67,27 @@ public:
 	 */
 	double computeHyperplaneDistance(const cv::Mat& featureVector) const;
 
+	/**
+	 * Computes the distances of several feature vectors to the decision hyperplane at once. The kernel type is
+	 * resolved only once, linear SVMs collapse their support vectors into a single weight vector that is multiplied
+	 * with all feature vectors, and other kernels are evaluated block-wise using matrix products where possible.
+	 *
+	 * @param[in] featureVectors The feature vectors.
+	 * @return The distances of the feature vectors to the decision hyperplane.
+	 */
+	std::vector<double> computeHyperplaneDistances(const std::vector<cv::Mat>& featureVectors) const;
+
+	/**
+	 * Computes the distances of several feature vectors to the decision hyperplane at once, see
+	 * computeHyperplaneDistances(const std::vector<cv::Mat>&).
+	 *
+	 * @param[in] featureVectors Matrix containing one feature vector per row (with as many values as the support vectors).
+	 * @return The distances of the feature vectors to the decision hyperplane.
+	 */
+	std::vector<double> computeHyperplaneDistances(const cv::Mat& featureVectors) const;
+
+	std::vector<std::pair<bool, double>> getConfidences(const std::vector<cv::Mat>& featureVectors) const;
+
 	/**
 	 * Stores the SVM parameters (kernel, bias, coefficients, support vectors) into a text file.
 	 *
@@ -74,6 +103,38 @@ public:
 	 */
 	static std::shared_ptr<SupportVectorMachine> load(std::ifstream& file);
 
+	/**
+	 * Stores the SVM parameters (kernel, bias, coefficients, support vectors) into a binary file.
+	 *
+	 * The file starts with a header containing a magic number, the format version, and the byte order, followed by
+	 * the additional parameters, the coefficients, and the support vectors. The sections start at multiples of 64
+	 * bytes, the support vectors are stored one after the other without gaps.
+	 *
+	 * @param[in] filename The name of the file to store the parameters into.
+	 * @param[in] parameters Additional parameters of derived models (e.g. the logistic function).
+	 */
+	void storeBinary(const std::string& filename, const std::vector<double>& parameters = std::vector<double>()) const;
+
+	/**
+	 * Creates a new SVM from parameters given in a binary file (see storeBinary) by mapping the file into memory.
+	 *
+	 * The support vectors are not copied, but refer to the read-only mapped pages, which are shared among all
+	 * processes that load the same file. They must not be modified and stay valid as long as the SVM exists, so
+	 * they have to be cloned when used beyond the lifetime of the SVM.
+	 *
+	 * @param[in] filename The name of the file to load the parameters from.
+	 * @param[out] parameters Additional parameters of derived models, may be null.
+	 * @return The newly created support vector machine.
+	 */
+	static std::shared_ptr<SupportVectorMachine> loadBinary(const std::string& filename,
+			std::vector<double>* parameters = nullptr);
+
+	/**
+	 * @param[in] filename The name of the file.
+	 * @return True if the file contains SVM parameters in the binary format, false otherwise.
+	 */
+	static bool isBinary(const std::string& filename);
+
 	/**
 	 * @return The kernel function.
 	 */
@@ -105,9 +166,7 @@ public:
 	/**
 	 * @param[in] The new support vectors.
 	 */
-	void setSupportVectors(std::vector<cv::Mat> supportVectors) {
-		this->supportVectors = std::move(supportVectors);
-	}
+	void setSupportVectors(std::vector<cv::Mat> supportVectors);
 
 	/**
 	 * @return The coefficients of the support vectors.
@@ -126,8 +185,24 @@ public:
 	/**
 	 * @param[in] coefficients The new coefficients of the support vectors.
 	 */
-	void setCoefficients(std::vector<float> coefficients) {
-		this->coefficients = std::move(coefficients);
+	void setCoefficients(std::vector<float> coefficients);
+
+	/**
+	 * Replaces the support vectors and their coefficients at once, so the kernel evaluator is re-created only once.
+	 *
+	 * @param[in] supportVectors The new support vectors.
+	 * @param[in] coefficients The new coefficients of the support vectors.
+	 */
+	void setSupportVectorsAndCoefficients(std::vector<cv::Mat> supportVectors, std::vector<float> coefficients);
+
+	/**
+	 * Replaces the evaluator of the sum over the weighted kernel values, e.g. by an approximation that is faster to
+	 * compute. The evaluator is re-created from the kernel when the support vectors or coefficients change.
+	 *
+	 * @param[in] evaluator The new evaluator, null to use the kernel function directly.
+	 */
+	void setEvaluator(std::shared_ptr<KernelEvaluator> evaluator) {
+		this->evaluator = evaluator;
 	}
 
 	/**
@@ -160,6 +235,18 @@ public:
 
 private:
 
+	/**
+	 * Re-creates the specialized kernel evaluator after the support vectors or coefficients changed.
+	 */
+	void updateEvaluator();
+
+	/**
+	 * Copies the support vectors into the rows of a single-precision matrix.
+	 *
+	 * @return Matrix of type CV_32FC1 with one support vector per row.
+	 */
+	cv::Mat createSupportVectorMatrix() const;
+
 	/**
 	 * Stores the values of support vectors one after the other into a file stream. The vectors are seperated by
 	 * newlines, while values are seperated by whitespaces.
@@ -212,6 +299,8 @@ private:
 	std::vector<float> coefficients; ///< The coefficients of the support vectors.
 	float bias; ///< The bias that is subtracted from the sum over all scaled kernel values.
 	float threshold; ///< The threshold to compare the hyperplane distance against for determining the label.
+	std::shared_ptr<KernelEvaluator> evaluator; ///< Evaluator that is specialized for the kernel and support vectors (may be null).
+	std::shared_ptr<const filemapping::MappedFile> mapping; ///< Mapped file that the support vectors refer to (may be null).
 };
 
 } /* namespace classification */
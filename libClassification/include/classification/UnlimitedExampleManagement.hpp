@@ -25,7 +25,7 @@ public:
 
 	void add(const std::vector<cv::Mat>& newExamples) {
 		for (const cv::Mat& example : newExamples)
-			examples.push_back(example);
+			append(example);
 	}
 };
 
@@ -18,13 +18,13 @@ AgeBasedExampleManagement::AgeBasedExampleManagement(size_t capacity) :
 void AgeBasedExampleManagement::add(const vector<Mat>& newExamples) {
 	// add new training examples as long as there is space available
 	auto example = newExamples.cbegin();
-	for (; examples.size() < examples.capacity() && example != newExamples.cend(); ++example)
-		examples.push_back(*example);
+	for (; size() < capacity && example != newExamples.cend(); ++example)
+		append(*example);
 	// replace the oldest training examples by new ones
 	for (; example != newExamples.cend(); ++example) {
-		examples[insertPosition] = *example;
+		replace(insertPosition, *example);
 		++insertPosition;
-		if (insertPosition == examples.size())
+		if (insertPosition == size())
 			insertPosition = 0;
 	}
 }
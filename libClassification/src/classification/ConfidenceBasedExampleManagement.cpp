@@ -27,21 +27,25 @@ void ConfidenceBasedExampleManagement::setFirstExamplesToKeep(size_t keep) {
 
 void ConfidenceBasedExampleManagement::add(const vector<Mat>& newExamples) {
 	// compute confidences of existing and new training examples and sort
+	vector<Mat> existingExamples;
+	existingExamples.reserve(size());
+	for (size_t i = keep; i < size(); ++i)
+		existingExamples.push_back(get(i));
+	vector<pair<bool, double>> existingResults = classifier->getConfidences(existingExamples);
 	vector<pair<size_t, double>> existingConfidences;
-	existingConfidences.reserve(examples.size());
-	for (size_t i = keep; i < examples.size(); ++i) {
-		pair<bool, double> result = classifier->getConfidence(examples[i]);
-		double score = result.second;
-		if (positive ^ result.first)
+	existingConfidences.reserve(existingResults.size());
+	for (size_t i = 0; i < existingResults.size(); ++i) {
+		double score = existingResults[i].second;
+		if (positive ^ existingResults[i].first)
 			score = -score;
-		existingConfidences.push_back(make_pair(i, score));
+		existingConfidences.push_back(make_pair(keep + i, score));
 	}
+	vector<pair<bool, double>> newResults = classifier->getConfidences(newExamples);
 	vector<pair<size_t, double>> newConfidences;
 	newConfidences.reserve(newExamples.size());
-	for (size_t i = 0; i < newExamples.size(); ++i) {
-		pair<bool, double> result = classifier->getConfidence(newExamples[i]);
-		double score = result.second;
-		if (positive ^ result.first)
+	for (size_t i = 0; i < newResults.size(); ++i) {
+		double score = newResults[i].second;
+		if (positive ^ newResults[i].first)
 			score = -score;
 		newConfidences.push_back(make_pair(i, score));
 	}
@@ -53,15 +57,15 @@ void ConfidenceBasedExampleManagement::add(const vector<Mat>& newExamples) {
 	});
 	// add new examples until there is no more space, then replace existing examples that have higher confidence than new examples
 	auto newConfidence = newConfidences.cbegin();
-	while (examples.size() < examples.capacity() && newConfidence != newConfidences.cend()) {
-		examples.push_back(newExamples[newConfidence->first]);
+	while (size() < capacity && newConfidence != newConfidences.cend()) {
+		append(newExamples[newConfidence->first]);
 		++newConfidence;
 	}
 	auto existingConfidence = existingConfidences.cbegin();
 	while (existingConfidence != existingConfidences.cend()
 			&& newConfidence != newConfidences.cend()
 			&& newConfidence->second < existingConfidence->second) {
-		examples[existingConfidence->first] = newExamples[newConfidence->first];
+		replace(existingConfidence->first, newExamples[newConfidence->first]);
 		++existingConfidence;
 		++newConfidence;
 	}
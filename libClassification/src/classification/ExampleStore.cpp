@@ -0,0 +1,267 @@
+/*
+ * ExampleStore.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "classification/ExampleStore.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+using cv::Mat;
+using std::invalid_argument;
+using std::out_of_range;
+using std::vector;
+
+namespace classification {
+
+namespace {
+
+uint16_t floatToHalf(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	uint32_t sign = (bits >> 16) & 0x8000u;
+	int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+	uint32_t mantissa = bits & 0x007FFFFFu;
+	if (exponent <= 0) { // subnormal or zero
+		if (exponent < -10)
+			return static_cast<uint16_t>(sign);
+		mantissa |= 0x00800000u;
+		uint32_t shift = static_cast<uint32_t>(14 - exponent);
+		uint32_t halfMantissa = mantissa >> shift;
+		if ((mantissa >> (shift - 1)) & 1u) // round half up
+			++halfMantissa;
+		return static_cast<uint16_t>(sign | halfMantissa);
+	}
+	if (exponent >= 31) { // overflow, infinity, or NaN
+		if (((bits >> 23) & 0xFFu) == 0xFFu && mantissa != 0)
+			return static_cast<uint16_t>(sign | 0x7E00u);
+		return static_cast<uint16_t>(sign | 0x7C00u);
+	}
+	uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+	if (mantissa & 0x00001000u) // round half up, may carry into the exponent
+		++half;
+	return static_cast<uint16_t>(half);
+}
+
+float halfToFloat(uint16_t half) {
+	uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+	uint32_t exponent = (half >> 10) & 0x1Fu;
+	uint32_t mantissa = half & 0x03FFu;
+	uint32_t bits;
+	if (exponent == 0) {
+		if (mantissa == 0) {
+			bits = sign;
+		} else { // subnormal, normalize
+			exponent = 127 - 15 + 1;
+			while ((mantissa & 0x0400u) == 0) {
+				mantissa <<= 1;
+				--exponent;
+			}
+			bits = sign | (exponent << 23) | ((mantissa & 0x03FFu) << 13);
+		}
+	} else if (exponent == 31) {
+		bits = sign | 0x7F800000u | (mantissa << 13);
+	} else {
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+} // namespace
+
+ExampleStore::ExampleStore(Precision precision, int rowsPerChunk) :
+		precision(precision), rowsPerChunk(rowsPerChunk), exampleRows(0), exampleCols(0), channels(0), dimensions(0),
+		count(0), nextGeneration(0), generations(), chunks(), scaleChunks() {
+	if (rowsPerChunk <= 0)
+		throw invalid_argument("ExampleStore: the number of rows per chunk must be greater than zero");
+}
+
+size_t ExampleStore::add(const Mat& example) {
+	if (count == 0) {
+		exampleRows = example.rows;
+		exampleCols = example.cols;
+		channels = example.channels();
+		dimensions = example.total() * example.channels();
+	}
+	Mat values = toRow(example);
+	if (count == chunks.size() * rowsPerChunk) {
+		int type = precision == Precision::FLOAT32 ? CV_32FC1 : precision == Precision::FLOAT16 ? CV_16UC1 : CV_8SC1;
+		chunks.emplace_back(rowsPerChunk, dimensions, type);
+		if (precision == Precision::INT8)
+			scaleChunks.emplace_back(rowsPerChunk, channels, CV_32FC1);
+	}
+	size_t index = count++;
+	encode(index, values);
+	generations.push_back(nextGeneration++);
+	return index;
+}
+
+void ExampleStore::set(size_t index, const Mat& example) {
+	if (index >= count)
+		throw out_of_range("ExampleStore: index out of range");
+	encode(index, toRow(example));
+	generations[index] = nextGeneration++;
+}
+
+void ExampleStore::clear() {
+	count = 0;
+	generations.clear();
+	chunks.clear();
+	scaleChunks.clear();
+}
+
+Mat ExampleStore::get(size_t index) const {
+	if (index >= count)
+		throw out_of_range("ExampleStore: index out of range");
+	if (precision == Precision::FLOAT32)
+		return chunks[index / rowsPerChunk].row(index % rowsPerChunk).reshape(channels, exampleRows);
+	Mat example(exampleRows, exampleCols, CV_MAKETYPE(CV_32F, channels));
+	decode(index, example.ptr<float>());
+	return example;
+}
+
+vector<Mat> ExampleStore::getExamples() const {
+	vector<Mat> examples;
+	examples.reserve(count);
+	for (size_t index = 0; index < count; ++index)
+		examples.push_back(get(index));
+	return examples;
+}
+
+void ExampleStore::decode(size_t index, float* values) const {
+	const uchar* row = data(index);
+	if (precision == Precision::FLOAT32) {
+		std::copy_n(reinterpret_cast<const float*>(row), dimensions, values);
+	} else if (precision == Precision::FLOAT16) {
+		const uint16_t* halfs = reinterpret_cast<const uint16_t*>(row);
+		for (int d = 0; d < dimensions; ++d)
+			values[d] = halfToFloat(halfs[d]);
+	} else {
+		const schar* quantized = reinterpret_cast<const schar*>(row);
+		const float* scale = scales(index);
+		for (int d = 0; d < dimensions; ++d)
+			values[d] = scale[d % channels] * quantized[d];
+	}
+}
+
+float ExampleStore::dot(size_t index, const float* vector) const {
+	const uchar* row = data(index);
+	float sum = 0;
+	if (precision == Precision::FLOAT32) {
+		const float* values = reinterpret_cast<const float*>(row);
+		for (int d = 0; d < dimensions; ++d)
+			sum += values[d] * vector[d];
+	} else if (precision == Precision::FLOAT16) {
+		const uint16_t* halfs = reinterpret_cast<const uint16_t*>(row);
+		for (int d = 0; d < dimensions; ++d)
+			sum += halfToFloat(halfs[d]) * vector[d];
+	} else {
+		const schar* quantized = reinterpret_cast<const schar*>(row);
+		const float* scale = scales(index);
+		for (int c = 0; c < channels; ++c) {
+			float channelSum = 0;
+			for (int d = c; d < dimensions; d += channels)
+				channelSum += quantized[d] * vector[d];
+			sum += scale[c] * channelSum;
+		}
+	}
+	return sum;
+}
+
+void ExampleStore::addScaled(size_t index, float factor, float* vector) const {
+	const uchar* row = data(index);
+	if (precision == Precision::FLOAT32) {
+		const float* values = reinterpret_cast<const float*>(row);
+		for (int d = 0; d < dimensions; ++d)
+			vector[d] += factor * values[d];
+	} else if (precision == Precision::FLOAT16) {
+		const uint16_t* halfs = reinterpret_cast<const uint16_t*>(row);
+		for (int d = 0; d < dimensions; ++d)
+			vector[d] += factor * halfToFloat(halfs[d]);
+	} else {
+		const schar* quantized = reinterpret_cast<const schar*>(row);
+		const float* scale = scales(index);
+		for (int c = 0; c < channels; ++c) {
+			float channelFactor = factor * scale[c];
+			for (int d = c; d < dimensions; d += channels)
+				vector[d] += channelFactor * quantized[d];
+		}
+	}
+}
+
+float ExampleStore::squaredNorm(size_t index) const {
+	const uchar* row = data(index);
+	float sum = 0;
+	if (precision == Precision::FLOAT32) {
+		const float* values = reinterpret_cast<const float*>(row);
+		for (int d = 0; d < dimensions; ++d)
+			sum += values[d] * values[d];
+	} else if (precision == Precision::FLOAT16) {
+		const uint16_t* halfs = reinterpret_cast<const uint16_t*>(row);
+		for (int d = 0; d < dimensions; ++d) {
+			float value = halfToFloat(halfs[d]);
+			sum += value * value;
+		}
+	} else {
+		const schar* quantized = reinterpret_cast<const schar*>(row);
+		const float* scale = scales(index);
+		for (int c = 0; c < channels; ++c) {
+			float channelSum = 0;
+			for (int d = c; d < dimensions; d += channels)
+				channelSum += quantized[d] * quantized[d];
+			sum += scale[c] * scale[c] * channelSum;
+		}
+	}
+	return sum;
+}
+
+const uchar* ExampleStore::data(size_t index) const {
+	return chunks[index / rowsPerChunk].ptr(static_cast<int>(index % rowsPerChunk));
+}
+
+Mat ExampleStore::toRow(const Mat& example) const {
+	if (example.total() * example.channels() != static_cast<size_t>(dimensions) || example.channels() != channels)
+		throw invalid_argument("ExampleStore: all examples must have the same size and number of channels");
+	Mat continuousExample = example.isContinuous() ? example : example.clone();
+	Mat values = continuousExample.reshape(1, 1);
+	if (values.depth() != CV_32F)
+		values.convertTo(values, CV_32F);
+	return values;
+}
+
+void ExampleStore::encode(size_t index, const Mat& values) {
+	uchar* row = chunks[index / rowsPerChunk].ptr(static_cast<int>(index % rowsPerChunk));
+	const float* source = values.ptr<float>();
+	if (precision == Precision::FLOAT32) {
+		std::copy_n(source, dimensions, reinterpret_cast<float*>(row));
+	} else if (precision == Precision::FLOAT16) {
+		uint16_t* halfs = reinterpret_cast<uint16_t*>(row);
+		for (int d = 0; d < dimensions; ++d)
+			halfs[d] = floatToHalf(source[d]);
+	} else {
+		schar* quantized = reinterpret_cast<schar*>(row);
+		float* scale = scaleChunks[index / rowsPerChunk].ptr<float>(static_cast<int>(index % rowsPerChunk));
+		for (int c = 0; c < channels; ++c) {
+			float maxAbsValue = 0;
+			for (int d = c; d < dimensions; d += channels)
+				maxAbsValue = std::max(maxAbsValue, std::abs(source[d]));
+			scale[c] = maxAbsValue / 127.0f;
+			float inverseScale = maxAbsValue > 0 ? 127.0f / maxAbsValue : 0.0f;
+			for (int d = c; d < dimensions; d += channels)
+				quantized[d] = static_cast<schar>(std::lround(std::min(127.0f, std::max(-127.0f, source[d] * inverseScale))));
+		}
+	}
+}
+
+const float* ExampleStore::scales(size_t index) const {
+	return scaleChunks[index / rowsPerChunk].ptr<float>(static_cast<int>(index % rowsPerChunk));
+}
+
+} /* namespace classification */
@@ -0,0 +1,91 @@
+/*
+ * HistogramIntersectionLookupTable.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "classification/HistogramIntersectionLookupTable.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+using cv::Mat;
+using std::invalid_argument;
+using std::pair;
+using std::vector;
+
+namespace classification {
+
+HistogramIntersectionLookupTable::HistogramIntersectionLookupTable(const vector<Mat>& supportVectors,
+		const vector<float>& coefficients, int binCount) :
+				binCount(binCount), dimensions(0), type(0), coefficientSum(0), minimums(), inverseSteps(), table() {
+	if (binCount < 2)
+		throw invalid_argument("HistogramIntersectionLookupTable: the number of bins must be at least two");
+	if (supportVectors.empty() || supportVectors.size() != coefficients.size())
+		throw invalid_argument("HistogramIntersectionLookupTable: there must be as many coefficients as support vectors (and at least one)");
+	type = supportVectors.front().type();
+	int depth = supportVectors.front().depth();
+	if (depth != CV_8U && depth != CV_32S && depth != CV_32F)
+		throw invalid_argument("HistogramIntersectionLookupTable: support vectors have to be of depth CV_8U, CV_32S or CV_32F");
+	dimensions = supportVectors.front().total() * supportVectors.front().channels();
+	Mat values(static_cast<int>(supportVectors.size()), dimensions, CV_32FC1);
+	for (size_t i = 0; i < supportVectors.size(); ++i) {
+		const Mat& supportVector = supportVectors[i];
+		if (supportVector.type() != type || supportVector.total() * supportVector.channels() != static_cast<size_t>(dimensions))
+			throw invalid_argument("HistogramIntersectionLookupTable: all support vectors must have the same size and type");
+		Mat continuousSupportVector = supportVector.isContinuous() ? supportVector : supportVector.clone();
+		Mat row = values.row(static_cast<int>(i));
+		continuousSupportVector.reshape(1, 1).convertTo(row, CV_32F);
+	}
+	for (float coefficient : coefficients)
+		coefficientSum += coefficient;
+
+	minimums.resize(dimensions);
+	inverseSteps.resize(dimensions);
+	table.create(dimensions, binCount, CV_32FC1);
+	vector<pair<float, float>> column(supportVectors.size()); // support vector values of one dimension and coefficients
+	for (int d = 0; d < dimensions; ++d) {
+		for (size_t i = 0; i < column.size(); ++i)
+			column[i] = std::make_pair(values.at<float>(static_cast<int>(i), d), coefficients[i]);
+		std::sort(column.begin(), column.end());
+		float minimum = column.front().first;
+		float maximum = column.back().first;
+		double step = static_cast<double>(maximum - minimum) / (binCount - 1);
+		minimums[d] = minimum;
+		inverseSteps[d] = step > 0 ? static_cast<float>(1 / step) : std::numeric_limits<float>::infinity();
+		// h(s) = sum of coefficient * value over the values below s plus s times the sum of the remaining coefficients
+		float* samples = table.ptr<float>(d);
+		double lowerSum = 0;
+		double upperCoefficientSum = coefficientSum;
+		size_t i = 0;
+		for (int bin = 0; bin < binCount; ++bin) {
+			double s = bin == binCount - 1 ? maximum : minimum + bin * step;
+			for (; i < column.size() && column[i].first < s; ++i) {
+				lowerSum += static_cast<double>(column[i].second) * column[i].first;
+				upperCoefficientSum -= column[i].second;
+			}
+			samples[bin] = static_cast<float>(lowerSum + s * upperCoefficientSum);
+		}
+	}
+}
+
+double HistogramIntersectionLookupTable::compute(const Mat& featureVector) const {
+	if (featureVector.type() != type || featureVector.total() * featureVector.channels() != static_cast<size_t>(dimensions))
+		throw invalid_argument("HistogramIntersectionLookupTable: the feature vector must have the same size and type as the support vectors");
+	if (!featureVector.isContinuous()) {
+		switch (featureVector.depth()) {
+			case CV_8U: return computeByRows<uchar>(featureVector);
+			case CV_32S: return computeByRows<int>(featureVector);
+			default: return computeByRows<float>(featureVector);
+		}
+	}
+	switch (featureVector.depth()) {
+		case CV_8U: return compute(featureVector.ptr<uchar>(), 0, dimensions);
+		case CV_32S: return compute(featureVector.ptr<int>(), 0, dimensions);
+		default: return compute(featureVector.ptr<float>(), 0, dimensions);
+	}
+}
+
+} /* namespace classification */
@@ -0,0 +1,462 @@
+/*
+ * KernelEvaluator.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "classification/HistogramIntersectionKernel.hpp"
+#include "classification/KernelEvaluator.hpp"
+#include "classification/KernelVisitor.hpp"
+#include "classification/LinearKernel.hpp"
+#include "classification/PolynomialKernel.hpp"
+#include "classification/RbfKernel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CLASSIFICATION_KERNELEVALUATOR_AVX2
+#include <immintrin.h>
+#endif
+
+using cv::Mat;
+using std::invalid_argument;
+using std::unique_ptr;
+using std::vector;
+
+namespace classification {
+
+namespace {
+
+/**
+ * Accumulator type of sums over values of type T (exact for integral values).
+ */
+template <typename T>
+using Sum = typename std::conditional<std::is_integral<T>::value, int64_t, double>::type;
+
+/**
+ * Dot product of two vectors.
+ */
+struct DotProduct {
+
+	template <typename T>
+	static double scalar(const T* a, const T* b, int n) {
+		Sum<T> sum = 0;
+		for (int i = 0; i < n; ++i)
+			sum += static_cast<Sum<T>>(a[i]) * b[i];
+		return static_cast<double>(sum);
+	}
+
+	static double avx2(const float* a, const float* b, int n);
+	static double avx2(const int* a, const int* b, int n);
+	static double avx2(const uchar* a, const uchar* b, int n);
+};
+
+/**
+ * Sum of the squared differences of two vectors.
+ */
+struct SquaredDistance {
+
+	template <typename T>
+	static double scalar(const T* a, const T* b, int n) {
+		Sum<T> sum = 0;
+		for (int i = 0; i < n; ++i) {
+			Sum<T> difference = static_cast<Sum<T>>(a[i]) - b[i];
+			sum += difference * difference;
+		}
+		return static_cast<double>(sum);
+	}
+
+	static double avx2(const float* a, const float* b, int n);
+	static double avx2(const int* a, const int* b, int n);
+	static double avx2(const uchar* a, const uchar* b, int n);
+};
+
+/**
+ * Sum over the element-wise minimums of two vectors.
+ */
+struct MinimumSum {
+
+	template <typename T>
+	static double scalar(const T* a, const T* b, int n) {
+		Sum<T> sum = 0;
+		for (int i = 0; i < n; ++i)
+			sum += std::min(a[i], b[i]);
+		return static_cast<double>(sum);
+	}
+
+	static double avx2(const float* a, const float* b, int n);
+	static double avx2(const int* a, const int* b, int n);
+	static double avx2(const uchar* a, const uchar* b, int n);
+};
+
+#ifdef CLASSIFICATION_KERNELEVALUATOR_AVX2
+
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+
+AVX2_TARGET inline double horizontalSum(__m256 values) {
+	alignas(32) float lanes[8];
+	_mm256_store_ps(lanes, values);
+	double sum = 0;
+	for (float lane : lanes)
+		sum += lane;
+	return sum;
+}
+
+AVX2_TARGET inline double horizontalSum(__m256d values) {
+	alignas(32) double lanes[4];
+	_mm256_store_pd(lanes, values);
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+AVX2_TARGET inline int64_t horizontalSum32(__m256i values) {
+	alignas(32) int32_t lanes[8];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), values);
+	int64_t sum = 0;
+	for (int32_t lane : lanes)
+		sum += lane;
+	return sum;
+}
+
+AVX2_TARGET inline int64_t horizontalSum64(__m256i values) {
+	alignas(32) int64_t lanes[4];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), values);
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+AVX2_TARGET inline __m256i loadWidened(const uchar* values) {
+	return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values)));
+}
+
+AVX2_TARGET inline __m256d loadWidened(const int* values) {
+	return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values)));
+}
+
+// 32-bit lanes of products of 8-bit values are flushed into 64 bits before they might overflow
+const int uchar32BitBlockIterations = 8192;
+
+AVX2_TARGET double DotProduct::avx2(const float* a, const float* b, int n) {
+	__m256 sum = _mm256_setzero_ps();
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+		sum = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum);
+	return horizontalSum(sum) + scalar(a + i, b + i, n - i);
+}
+
+AVX2_TARGET double DotProduct::avx2(const int* a, const int* b, int n) {
+	__m256d sum = _mm256_setzero_pd();
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+		sum = _mm256_fmadd_pd(loadWidened(a + i), loadWidened(b + i), sum);
+	return horizontalSum(sum) + scalar(a + i, b + i, n - i);
+}
+
+AVX2_TARGET double DotProduct::avx2(const uchar* a, const uchar* b, int n) {
+	int64_t sum = 0;
+	int i = 0;
+	while (i + 16 <= n) {
+		__m256i blockSum = _mm256_setzero_si256();
+		for (int iteration = 0; iteration < uchar32BitBlockIterations && i + 16 <= n; ++iteration, i += 16)
+			blockSum = _mm256_add_epi32(blockSum, _mm256_madd_epi16(loadWidened(a + i), loadWidened(b + i)));
+		sum += horizontalSum32(blockSum);
+	}
+	return static_cast<double>(sum) + scalar(a + i, b + i, n - i);
+}
+
+AVX2_TARGET double SquaredDistance::avx2(const float* a, const float* b, int n) {
+	__m256 sum = _mm256_setzero_ps();
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256 difference = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+		sum = _mm256_fmadd_ps(difference, difference, sum);
+	}
+	return horizontalSum(sum) + scalar(a + i, b + i, n - i);
+}
+
+AVX2_TARGET double SquaredDistance::avx2(const int* a, const int* b, int n) {
+	__m256d sum = _mm256_setzero_pd();
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256d difference = _mm256_sub_pd(loadWidened(a + i), loadWidened(b + i));
+		sum = _mm256_fmadd_pd(difference, difference, sum);
+	}
+	return horizontalSum(sum) + scalar(a + i, b + i, n - i);
+}
+
+AVX2_TARGET double SquaredDistance::avx2(const uchar* a, const uchar* b, int n) {
+	int64_t sum = 0;
+	int i = 0;
+	while (i + 16 <= n) {
+		__m256i blockSum = _mm256_setzero_si256();
+		for (int iteration = 0; iteration < uchar32BitBlockIterations && i + 16 <= n; ++iteration, i += 16) {
+			__m256i difference = _mm256_sub_epi16(loadWidened(a + i), loadWidened(b + i));
+			blockSum = _mm256_add_epi32(blockSum, _mm256_madd_epi16(difference, difference));
+		}
+		sum += horizontalSum32(blockSum);
+	}
+	return static_cast<double>(sum) + scalar(a + i, b + i, n - i);
+}
+
+AVX2_TARGET double MinimumSum::avx2(const float* a, const float* b, int n) {
+	__m256 sum = _mm256_setzero_ps();
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+		sum = _mm256_add_ps(sum, _mm256_min_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+	return horizontalSum(sum) + scalar(a + i, b + i, n - i);
+}
+
+AVX2_TARGET double MinimumSum::avx2(const int* a, const int* b, int n) {
+	__m256d sum = _mm256_setzero_pd();
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i minimums = _mm256_min_epi32(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+		sum = _mm256_add_pd(sum, _mm256_cvtepi32_pd(_mm256_castsi256_si128(minimums)));
+		sum = _mm256_add_pd(sum, _mm256_cvtepi32_pd(_mm256_extracti128_si256(minimums, 1)));
+	}
+	return horizontalSum(sum) + scalar(a + i, b + i, n - i);
+}
+
+AVX2_TARGET double MinimumSum::avx2(const uchar* a, const uchar* b, int n) {
+	__m256i sum = _mm256_setzero_si256();
+	int i = 0;
+	for (; i + 32 <= n; i += 32) {
+		__m256i minimums = _mm256_min_epu8(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+		sum = _mm256_add_epi64(sum, _mm256_sad_epu8(minimums, _mm256_setzero_si256()));
+	}
+	return static_cast<double>(horizontalSum64(sum)) + scalar(a + i, b + i, n - i);
+}
+
+#undef AVX2_TARGET
+
+bool detectAvx2() {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+#else
+
+double DotProduct::avx2(const float* a, const float* b, int n) { return scalar(a, b, n); }
+double DotProduct::avx2(const int* a, const int* b, int n) { return scalar(a, b, n); }
+double DotProduct::avx2(const uchar* a, const uchar* b, int n) { return scalar(a, b, n); }
+double SquaredDistance::avx2(const float* a, const float* b, int n) { return scalar(a, b, n); }
+double SquaredDistance::avx2(const int* a, const int* b, int n) { return scalar(a, b, n); }
+double SquaredDistance::avx2(const uchar* a, const uchar* b, int n) { return scalar(a, b, n); }
+double MinimumSum::avx2(const float* a, const float* b, int n) { return scalar(a, b, n); }
+double MinimumSum::avx2(const int* a, const int* b, int n) { return scalar(a, b, n); }
+double MinimumSum::avx2(const uchar* a, const uchar* b, int n) { return scalar(a, b, n); }
+
+bool detectAvx2() {
+	return false;
+}
+
+#endif
+
+/**
+ * Kernel value given the result of the underlying measure (dot product, distance, or minimum sum).
+ */
+struct Identity {
+	double operator()(double value) const {
+		return value;
+	}
+};
+
+struct Polynomial {
+	double operator()(double dotProduct) const {
+		double base = alpha * dotProduct + constant, result = 1.0;
+		for (int exponent = degree; exponent > 0; exponent /= 2) {
+			if (exponent % 2 == 1)
+				result *= base;
+			base *= base;
+		}
+		return result;
+	}
+	double alpha;
+	double constant;
+	int degree;
+};
+
+struct RadialBasisFunction {
+	double operator()(double squaredDistance) const {
+		return std::exp(-gamma * squaredDistance);
+	}
+	double gamma;
+};
+
+/**
+ * Kernel evaluator that is specialized for the value type, the measure, the kernel function, and the instruction set.
+ */
+template <typename T, typename Measure, typename Function, bool Avx2>
+class SpecializedKernelEvaluator : public KernelEvaluator {
+public:
+
+	SpecializedKernelEvaluator(const vector<Mat>& supportVectors, const vector<float>& coefficients, Function function) :
+			dimensions(supportVectors.front().total() * supportVectors.front().channels()),
+			type(supportVectors.front().type()),
+			sharedSupportVectors(),
+			supportVectors(),
+			coefficients(coefficients.begin(), coefficients.end()),
+			function(function) {
+		for (const Mat& supportVector : supportVectors) {
+			if (supportVector.type() != type || supportVector.total() * supportVector.channels() != static_cast<size_t>(dimensions))
+				throw invalid_argument("KernelEvaluator: all support vectors must have the same size and type");
+		}
+		int count = static_cast<int>(supportVectors.size());
+		if (areRowsOfSingleMatrix(supportVectors)) { // e.g. memory-mapped, refer to them instead of copying
+			sharedSupportVectors = supportVectors;
+			this->supportVectors = Mat(count, dimensions, cv::DataType<T>::depth, supportVectors.front().data);
+		} else {
+			this->supportVectors.create(count, dimensions, cv::DataType<T>::depth);
+			for (int i = 0; i < count; ++i) {
+				const Mat& supportVector = supportVectors[i];
+				Mat continuousSupportVector = supportVector.isContinuous() ? supportVector : supportVector.clone();
+				Mat row = this->supportVectors.row(i);
+				continuousSupportVector.reshape(1, 1).copyTo(row);
+			}
+		}
+	}
+
+	double compute(const Mat& featureVector) const override {
+		if (featureVector.type() != type || featureVector.total() * featureVector.channels() != static_cast<size_t>(dimensions))
+			throw invalid_argument("KernelEvaluator: the feature vector must have the same size and type as the support vectors");
+		if (!featureVector.isContinuous())
+			return computeByRows(featureVector);
+		const T* values = featureVector.ptr<T>();
+		double sum = 0;
+		for (int i = 0; i < supportVectors.rows; ++i)
+			sum += coefficients[i] * function(measure(values, supportVectors.ptr<T>(i), dimensions));
+		return sum;
+	}
+
+private:
+
+	/**
+	 * @param[in] supportVectors Support vectors of equal size and type.
+	 * @return True if the support vectors are continuous and follow each other in memory without gaps.
+	 */
+	bool areRowsOfSingleMatrix(const vector<Mat>& supportVectors) const {
+		size_t size = dimensions * sizeof(T);
+		for (size_t i = 0; i < supportVectors.size(); ++i) {
+			if (!supportVectors[i].isContinuous() || supportVectors[i].data != supportVectors.front().data + i * size)
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Computes the kernel sum of a feature vector that is not continuous (e.g. a view into a feature pyramid) without
+	 * copying it. The measures are sums over the dimensions, so they are accumulated row by row.
+	 *
+	 * @param[in] featureVector Feature vector of the same size and type as the support vectors.
+	 * @return Sum over the weighted kernel values.
+	 */
+	double computeByRows(const Mat& featureVector) const {
+		int rowSize = featureVector.cols * featureVector.channels();
+		double sum = 0;
+		for (int i = 0; i < supportVectors.rows; ++i) {
+			const T* supportVector = supportVectors.ptr<T>(i);
+			double measure = 0;
+			for (int row = 0; row < featureVector.rows; ++row)
+				measure += this->measure(featureVector.ptr<T>(row), supportVector + row * rowSize, rowSize);
+			sum += coefficients[i] * function(measure);
+		}
+		return sum;
+	}
+
+	double measure(const T* a, const T* b, int n) const {
+		return Avx2 ? Measure::avx2(a, b, n) : Measure::template scalar<T>(a, b, n);
+	}
+
+	int dimensions; ///< Number of values per support vector.
+	int type; ///< Type of the support vectors.
+	vector<Mat> sharedSupportVectors; ///< Support vectors whose data is referred to instead of copied (may be empty).
+	Mat supportVectors; ///< Support vectors as rows of a single matrix.
+	vector<double> coefficients; ///< Coefficients of the support vectors.
+	Function function; ///< Kernel function given the measure.
+};
+
+/**
+ * Kernel visitor that creates the specialized kernel evaluator.
+ */
+class KernelEvaluatorFactory : public KernelVisitor {
+public:
+
+	KernelEvaluatorFactory(const vector<Mat>& supportVectors, const vector<float>& coefficients) :
+			supportVectors(supportVectors), coefficients(coefficients), evaluator() {}
+
+	void visit(const LinearKernel& kernel) override {
+		if (supportVectors.front().depth() == CV_32F && supportVectors.size() > 1) {
+			// the weighted sum of dot products equals the dot product with the weighted sum of support vectors
+			Mat weightVector = Mat::zeros(supportVectors.front().size(), supportVectors.front().type());
+			for (size_t i = 0; i < supportVectors.size(); ++i)
+				weightVector += coefficients[i] * supportVectors[i];
+			supportVectors = vector<Mat>{weightVector};
+			coefficients = vector<float>{1};
+		}
+		create<DotProduct>(Identity());
+	}
+
+	void visit(const PolynomialKernel& kernel) override {
+		create<DotProduct>(Polynomial{kernel.getAlpha(), kernel.getConstant(), kernel.getDegree()});
+	}
+
+	void visit(const RbfKernel& kernel) override {
+		create<SquaredDistance>(RadialBasisFunction{kernel.getGamma()});
+	}
+
+	void visit(const HistogramIntersectionKernel& kernel) override {
+		create<MinimumSum>(Identity());
+	}
+
+	unique_ptr<KernelEvaluator> getEvaluator() {
+		return std::move(evaluator);
+	}
+
+private:
+
+	template <typename Measure, typename Function>
+	void create(Function function) {
+		switch (supportVectors.front().depth()) {
+			case CV_8U: create<uchar, Measure>(function); break;
+			case CV_32S: create<int, Measure>(function); break;
+			case CV_32F: create<float, Measure>(function); break;
+			default: evaluator.reset(); // no specialized implementation, SupportVectorMachine falls back to the kernel
+		}
+	}
+
+	template <typename T, typename Measure, typename Function>
+	void create(Function function) {
+		if (KernelEvaluator::isAvx2Supported())
+			evaluator.reset(new SpecializedKernelEvaluator<T, Measure, Function, true>(supportVectors, coefficients, function));
+		else
+			evaluator.reset(new SpecializedKernelEvaluator<T, Measure, Function, false>(supportVectors, coefficients, function));
+	}
+
+	vector<Mat> supportVectors; ///< Support vectors.
+	vector<float> coefficients; ///< Coefficients of the support vectors.
+	unique_ptr<KernelEvaluator> evaluator; ///< Created kernel evaluator.
+};
+
+} // namespace
+
+unique_ptr<KernelEvaluator> KernelEvaluator::create(const Kernel& kernel,
+		const vector<Mat>& supportVectors, const vector<float>& coefficients) {
+	if (supportVectors.empty() || supportVectors.size() != coefficients.size())
+		throw invalid_argument("KernelEvaluator: there must be as many coefficients as support vectors (and at least one)");
+	KernelEvaluatorFactory factory(supportVectors, coefficients);
+	kernel.accept(factory);
+	return factory.getEvaluator();
+}
+
+bool KernelEvaluator::isAvx2Supported() {
+	static const bool supported = detectAvx2();
+	return supported;
+}
+
+} /* namespace classification */
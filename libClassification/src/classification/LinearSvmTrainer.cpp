@@ -0,0 +1,382 @@
+/*
+ * LinearSvmTrainer.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "classification/LinearKernel.hpp"
+#include "classification/LinearSvmTrainer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+using cv::Mat;
+using std::invalid_argument;
+using std::pair;
+using std::vector;
+
+namespace classification {
+
+size_t LinearSvmTrainer::TrainingSet::size() const {
+	return positives.size() + negatives.size();
+}
+
+float LinearSvmTrainer::TrainingSet::label(size_t index) const {
+	return index < positives.size() ? 1.0f : -1.0f;
+}
+
+float LinearSvmTrainer::TrainingSet::dot(size_t index, const float* weights) const {
+	int dimensions = positives.getDimensions();
+	if (index < positives.size())
+		return positives.dot(index, weights) + weights[dimensions];
+	return negatives.dot(index - positives.size(), weights) + weights[dimensions];
+}
+
+void LinearSvmTrainer::TrainingSet::addScaled(size_t index, float factor, float* weights) const {
+	int dimensions = positives.getDimensions();
+	if (index < positives.size())
+		positives.addScaled(index, factor, weights);
+	else
+		negatives.addScaled(index - positives.size(), factor, weights);
+	weights[dimensions] += factor;
+}
+
+float LinearSvmTrainer::TrainingSet::squaredNorm(size_t index) const {
+	if (index < positives.size())
+		return positives.squaredNorm(index) + 1.0f;
+	return negatives.squaredNorm(index - positives.size()) + 1.0f;
+}
+
+LinearSvmTrainer::LinearSvmTrainer(double c, bool compensateImbalance, int maxIterations, double epsilon, bool warmStart) :
+		c(c), compensateImbalance(compensateImbalance), maxIterations(maxIterations), epsilon(epsilon), foldCount(5),
+		warmStart(warmStart), previousDimensions(0), previousAlphas(), generator() {
+	if (c <= 0)
+		throw invalid_argument("LinearSvmTrainer: C must be greater than zero");
+	if (maxIterations <= 0)
+		throw invalid_argument("LinearSvmTrainer: the maximum number of iterations must be greater than zero");
+	if (epsilon <= 0)
+		throw invalid_argument("LinearSvmTrainer: epsilon must be greater than zero");
+}
+
+void LinearSvmTrainer::train(SupportVectorMachine& svm, const vector<Mat>& positives, const vector<Mat>& negatives) const {
+	if (!dynamic_cast<LinearKernel*>(svm.getKernel().get()))
+		throw invalid_argument("LinearSvmTrainer: the SVM must use a LinearKernel");
+	if (positives.empty() || negatives.empty())
+		throw invalid_argument("LinearSvmTrainer: there must be at least one positive and one negative training example");
+	ExampleStore positiveStore, negativeStore;
+	TrainingSet examples = createTrainingSet(positiveStore, negativeStore, positives, negatives);
+	setWeights(svm, optimize(examples, getExampleKeys(positives, negatives)), positives.front());
+}
+
+void LinearSvmTrainer::train(ProbabilisticSupportVectorMachine& svm, const vector<Mat>& positives, const vector<Mat>& negatives) const {
+	if (!dynamic_cast<LinearKernel*>(svm.getSvm()->getKernel().get()))
+		throw invalid_argument("LinearSvmTrainer: the SVM must use a LinearKernel");
+	if (positives.empty() || negatives.empty())
+		throw invalid_argument("LinearSvmTrainer: there must be at least one positive and one negative training example");
+	ExampleStore positiveStore, negativeStore;
+	TrainingSet examples = createTrainingSet(positiveStore, negativeStore, positives, negatives);
+	setWeights(*svm.getSvm(), optimize(examples, getExampleKeys(positives, negatives)), positives.front());
+	setLogisticParameters(svm, examples);
+}
+
+void LinearSvmTrainer::train(SupportVectorMachine& svm, const ExampleStore& positives, const ExampleStore& negatives) const {
+	if (!dynamic_cast<LinearKernel*>(svm.getKernel().get()))
+		throw invalid_argument("LinearSvmTrainer: the SVM must use a LinearKernel");
+	TrainingSet examples = createTrainingSet(positives, negatives);
+	setWeights(svm, optimize(examples, getExampleKeys(positives, negatives)), positives.get(0));
+}
+
+void LinearSvmTrainer::train(ProbabilisticSupportVectorMachine& svm, const ExampleStore& positives, const ExampleStore& negatives) const {
+	if (!dynamic_cast<LinearKernel*>(svm.getSvm()->getKernel().get()))
+		throw invalid_argument("LinearSvmTrainer: the SVM must use a LinearKernel");
+	TrainingSet examples = createTrainingSet(positives, negatives);
+	setWeights(*svm.getSvm(), optimize(examples, getExampleKeys(positives, negatives)), positives.get(0));
+	setLogisticParameters(svm, examples);
+}
+
+void LinearSvmTrainer::setLogisticParameters(ProbabilisticSupportVectorMachine& svm, const TrainingSet& examples) const {
+	vector<float> labels(examples.size());
+	for (size_t i = 0; i < examples.size(); ++i)
+		labels[i] = examples.label(i);
+	pair<double, double> logisticParameters = fitLogisticParameters(computeCrossValidatedScores(examples), labels);
+	svm.setLogisticA(logisticParameters.first);
+	svm.setLogisticB(logisticParameters.second);
+}
+
+Mat LinearSvmTrainer::optimize(const TrainingSet& examples, const vector<ExampleKey>& keys) const {
+	vector<int> indices(examples.size());
+	std::iota(indices.begin(), indices.end(), 0);
+	vector<float> alphas(examples.size(), 0.0f);
+	vector<bool> known;
+	int dimensions = examples.positives.getDimensions();
+	if (!warmStart)
+		return optimize(examples, indices, alphas, known);
+	if (previousDimensions == dimensions) {
+		known.resize(examples.size(), false);
+		for (size_t i = 0; i < examples.size(); ++i) {
+			auto previousAlpha = previousAlphas.find(keys[i]);
+			if (previousAlpha != previousAlphas.end()) {
+				alphas[i] = previousAlpha->second;
+				known[i] = true;
+			}
+		}
+	}
+	Mat weights = optimize(examples, indices, alphas, known);
+	// the data of matrices that were removed in the meantime might be re-used by new matrices, which then start
+	// from a stale dual variable; this only delays their optimization until all coordinates are checked
+	previousDimensions = dimensions;
+	previousAlphas.clear();
+	previousAlphas.reserve(examples.size());
+	for (size_t i = 0; i < examples.size(); ++i)
+		previousAlphas[keys[i]] = alphas[i];
+	return weights;
+}
+
+Mat LinearSvmTrainer::optimize(const TrainingSet& examples, const vector<int>& indices) const {
+	vector<float> alphas(indices.size(), 0.0f);
+	vector<bool> known;
+	return optimize(examples, indices, alphas, known);
+}
+
+Mat LinearSvmTrainer::optimize(const TrainingSet& examples, const vector<int>& indices,
+		vector<float>& alphas, const vector<bool>& known) const {
+	int exampleCount = indices.size();
+	double positiveCount = std::count_if(indices.begin(), indices.end(), [&](int i) { return examples.label(i) > 0; });
+	double negativeCount = exampleCount - positiveCount;
+	double positiveC = c;
+	double negativeC = c;
+	if (compensateImbalance && positiveCount > 0 && negativeCount > 0) {
+		positiveC *= negativeCount / positiveCount;
+		negativeC *= positiveCount / negativeCount;
+	}
+	Mat weights = Mat::zeros(1, examples.positives.getDimensions() + 1, CV_32FC1);
+	float* w = weights.ptr<float>();
+	vector<float> diagonal(exampleCount);
+	for (int s = 0; s < exampleCount; ++s) {
+		diagonal[s] = examples.squaredNorm(indices[s]);
+		// the upper bounds may have changed since the dual variables were computed
+		float label = examples.label(indices[s]);
+		alphas[s] = std::min(alphas[s], static_cast<float>(label > 0 ? positiveC : negativeC));
+		if (alphas[s] > 0)
+			examples.addScaled(indices[s], alphas[s] * label, w);
+	}
+	// coordinates are referred to by their position within indices, the first activeCount of them are not shrunk
+	vector<int> order(exampleCount);
+	std::iota(order.begin(), order.end(), 0);
+	int activeCount = exampleCount;
+	if (!known.empty()) { // known examples that are no support vectors start out shrunk
+		auto firstShrunk = std::stable_partition(order.begin(), order.end(), [&](int s) { return !known[s] || alphas[s] > 0; });
+		activeCount = firstShrunk - order.begin();
+	}
+	double maxProjectedGradientOld = std::numeric_limits<double>::infinity();
+	double minProjectedGradientOld = -std::numeric_limits<double>::infinity();
+	for (int iteration = 0; iteration < maxIterations; ++iteration) {
+		std::shuffle(order.begin(), order.begin() + activeCount, generator);
+		double maxProjectedGradient = -std::numeric_limits<double>::infinity();
+		double minProjectedGradient = std::numeric_limits<double>::infinity();
+		for (int k = 0; k < activeCount; ++k) {
+			int s = order[k];
+			float label = examples.label(indices[s]);
+			float upperBound = static_cast<float>(label > 0 ? positiveC : negativeC);
+			float gradient = label * examples.dot(indices[s], w) - 1.0f;
+			float projectedGradient = 0;
+			if (alphas[s] == 0) {
+				if (gradient > maxProjectedGradientOld) { // will most likely remain at the lower bound
+					--activeCount;
+					std::swap(order[k], order[activeCount]);
+					--k;
+					continue;
+				}
+				projectedGradient = std::min(gradient, 0.0f);
+			} else if (alphas[s] == upperBound) {
+				if (gradient < minProjectedGradientOld) { // will most likely remain at the upper bound
+					--activeCount;
+					std::swap(order[k], order[activeCount]);
+					--k;
+					continue;
+				}
+				projectedGradient = std::max(gradient, 0.0f);
+			} else {
+				projectedGradient = gradient;
+			}
+			maxProjectedGradient = std::max(maxProjectedGradient, static_cast<double>(projectedGradient));
+			minProjectedGradient = std::min(minProjectedGradient, static_cast<double>(projectedGradient));
+			if (std::abs(projectedGradient) > 1e-12f && diagonal[s] > 0) {
+				float oldAlpha = alphas[s];
+				alphas[s] = std::min(std::max(oldAlpha - gradient / diagonal[s], 0.0f), upperBound);
+				examples.addScaled(indices[s], (alphas[s] - oldAlpha) * label, w);
+			}
+		}
+		if (maxProjectedGradient - minProjectedGradient <= epsilon) {
+			if (activeCount == exampleCount)
+				break;
+			// verify the solution on all coordinates before stopping
+			activeCount = exampleCount;
+			maxProjectedGradientOld = std::numeric_limits<double>::infinity();
+			minProjectedGradientOld = -std::numeric_limits<double>::infinity();
+			continue;
+		}
+		maxProjectedGradientOld = maxProjectedGradient > 0 ? maxProjectedGradient : std::numeric_limits<double>::infinity();
+		minProjectedGradientOld = minProjectedGradient < 0 ? minProjectedGradient : -std::numeric_limits<double>::infinity();
+	}
+	return weights;
+}
+
+vector<double> LinearSvmTrainer::computeCrossValidatedScores(const TrainingSet& examples) const {
+	int exampleCount = examples.size();
+	vector<int> positiveIndices, negativeIndices;
+	for (int i = 0; i < exampleCount; ++i)
+		(examples.label(i) > 0 ? positiveIndices : negativeIndices).push_back(i);
+	vector<double> scores(exampleCount);
+	if (positiveIndices.size() < static_cast<size_t>(foldCount) || negativeIndices.size() < static_cast<size_t>(foldCount)) {
+		// too few examples for cross-validation, so the scores are computed by the SVM trained on all of them
+		vector<int> indices(exampleCount);
+		std::iota(indices.begin(), indices.end(), 0);
+		Mat weights = optimize(examples, indices);
+		for (int i = 0; i < exampleCount; ++i)
+			scores[i] = examples.dot(i, weights.ptr<float>());
+		return scores;
+	}
+	std::shuffle(positiveIndices.begin(), positiveIndices.end(), generator);
+	std::shuffle(negativeIndices.begin(), negativeIndices.end(), generator);
+	vector<int> folds(exampleCount);
+	for (size_t k = 0; k < positiveIndices.size(); ++k)
+		folds[positiveIndices[k]] = k % foldCount;
+	for (size_t k = 0; k < negativeIndices.size(); ++k)
+		folds[negativeIndices[k]] = k % foldCount;
+	for (int fold = 0; fold < foldCount; ++fold) {
+		vector<int> trainingIndices;
+		trainingIndices.reserve(exampleCount);
+		for (int i = 0; i < exampleCount; ++i) {
+			if (folds[i] != fold)
+				trainingIndices.push_back(i);
+		}
+		Mat weights = optimize(examples, trainingIndices);
+		for (int i = 0; i < exampleCount; ++i) {
+			if (folds[i] == fold)
+				scores[i] = examples.dot(i, weights.ptr<float>());
+		}
+	}
+	return scores;
+}
+
+pair<double, double> LinearSvmTrainer::fitLogisticParameters(const vector<double>& scores, const vector<float>& labels) const {
+	const int maxNewtonIterations = 100;
+	const double minStepSize = 1e-10;
+	const double sigma = 1e-12; // ensures the Hessian to be positive definite
+	const double tolerance = 1e-5;
+	double positiveCount = std::count_if(labels.begin(), labels.end(), [](float label) { return label > 0; });
+	double negativeCount = labels.size() - positiveCount;
+	// regularized targets to prevent overfitting
+	double positiveTarget = (positiveCount + 1.0) / (positiveCount + 2.0);
+	double negativeTarget = 1.0 / (negativeCount + 2.0);
+	vector<double> targets(labels.size());
+	for (size_t i = 0; i < labels.size(); ++i)
+		targets[i] = labels[i] > 0 ? positiveTarget : negativeTarget;
+	auto computeObjective = [&](double a, double b) {
+		double objective = 0;
+		for (size_t i = 0; i < scores.size(); ++i) {
+			double f = scores[i] * a + b;
+			if (f >= 0)
+				objective += targets[i] * f + std::log1p(std::exp(-f));
+			else
+				objective += (targets[i] - 1) * f + std::log1p(std::exp(f));
+		}
+		return objective;
+	};
+	double a = 0;
+	double b = std::log((negativeCount + 1.0) / (positiveCount + 1.0));
+	double objective = computeObjective(a, b);
+	for (int iteration = 0; iteration < maxNewtonIterations; ++iteration) {
+		double h11 = sigma, h22 = sigma, h21 = 0, g1 = 0, g2 = 0;
+		for (size_t i = 0; i < scores.size(); ++i) {
+			double f = scores[i] * a + b;
+			double p, q;
+			if (f >= 0) {
+				p = std::exp(-f) / (1.0 + std::exp(-f));
+				q = 1.0 / (1.0 + std::exp(-f));
+			} else {
+				p = 1.0 / (1.0 + std::exp(f));
+				q = std::exp(f) / (1.0 + std::exp(f));
+			}
+			double d2 = p * q;
+			h11 += scores[i] * scores[i] * d2;
+			h22 += d2;
+			h21 += scores[i] * d2;
+			double d1 = targets[i] - p;
+			g1 += scores[i] * d1;
+			g2 += d1;
+		}
+		if (std::abs(g1) < tolerance && std::abs(g2) < tolerance)
+			break;
+		double determinant = h11 * h22 - h21 * h21;
+		double deltaA = -(h22 * g1 - h21 * g2) / determinant;
+		double deltaB = -(-h21 * g1 + h11 * g2) / determinant;
+		double gradientDirection = g1 * deltaA + g2 * deltaB;
+		double stepSize = 1;
+		while (stepSize >= minStepSize) {
+			double newA = a + stepSize * deltaA;
+			double newB = b + stepSize * deltaB;
+			double newObjective = computeObjective(newA, newB);
+			if (newObjective < objective + 0.0001 * stepSize * gradientDirection) {
+				a = newA;
+				b = newB;
+				objective = newObjective;
+				break;
+			}
+			stepSize /= 2;
+		}
+		if (stepSize < minStepSize)
+			break;
+	}
+	return std::make_pair(a, b);
+}
+
+LinearSvmTrainer::TrainingSet LinearSvmTrainer::createTrainingSet(ExampleStore& positiveStore, ExampleStore& negativeStore,
+		const vector<Mat>& positives, const vector<Mat>& negatives) const {
+	for (const Mat& example : positives)
+		positiveStore.add(example);
+	for (const Mat& example : negatives)
+		negativeStore.add(example);
+	return createTrainingSet(positiveStore, negativeStore);
+}
+
+LinearSvmTrainer::TrainingSet LinearSvmTrainer::createTrainingSet(const ExampleStore& positives, const ExampleStore& negatives) const {
+	if (positives.empty() || negatives.empty())
+		throw invalid_argument("LinearSvmTrainer: there must be at least one positive and one negative training example");
+	if (positives.getDimensions() != negatives.getDimensions())
+		throw invalid_argument("LinearSvmTrainer: all training examples must have the same dimensions");
+	return TrainingSet{positives, negatives};
+}
+
+vector<LinearSvmTrainer::ExampleKey> LinearSvmTrainer::getExampleKeys(const vector<Mat>& positives, const vector<Mat>& negatives) const {
+	vector<ExampleKey> keys;
+	keys.reserve(positives.size() + negatives.size());
+	for (const Mat& example : positives)
+		keys.emplace_back(example.data, 0);
+	for (const Mat& example : negatives)
+		keys.emplace_back(example.data, 0);
+	return keys;
+}
+
+vector<LinearSvmTrainer::ExampleKey> LinearSvmTrainer::getExampleKeys(const ExampleStore& positives, const ExampleStore& negatives) const {
+	vector<ExampleKey> keys;
+	keys.reserve(positives.size() + negatives.size());
+	for (size_t i = 0; i < positives.size(); ++i)
+		keys.emplace_back(positives.data(i), positives.getGeneration(i));
+	for (size_t i = 0; i < negatives.size(); ++i)
+		keys.emplace_back(negatives.data(i), negatives.getGeneration(i));
+	return keys;
+}
+
+void LinearSvmTrainer::setWeights(SupportVectorMachine& svm, const Mat& weights, const Mat& example) const {
+	int dimensions = weights.cols - 1;
+	Mat supportVector = weights.colRange(0, dimensions).clone().reshape(example.channels(), example.rows);
+	svm.setSupportVectorsAndCoefficients(vector<Mat>{supportVector}, vector<float>{1});
+	svm.setBias(-weights.at<float>(0, dimensions));
+}
+
+} /* namespace classification */
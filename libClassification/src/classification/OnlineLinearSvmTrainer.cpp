@@ -0,0 +1,141 @@
+/*
+ * OnlineLinearSvmTrainer.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "classification/LinearKernel.hpp"
+#include "classification/OnlineLinearSvmTrainer.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+using cv::Mat;
+using std::invalid_argument;
+using std::vector;
+
+namespace classification {
+
+OnlineLinearSvmTrainer::OnlineLinearSvmTrainer(double c, bool compensateImbalance, double learnRate, int maxIterations, double epsilon) :
+		c(c), compensateImbalance(compensateImbalance), learnRate(learnRate), maxIterations(maxIterations), epsilon(epsilon), generator() {
+	if (c <= 0)
+		throw invalid_argument("OnlineLinearSvmTrainer: C must be greater than zero");
+	if (learnRate < 0 || learnRate > 1)
+		throw invalid_argument("OnlineLinearSvmTrainer: the learn rate must be between zero (inclusive) and one (inclusive)");
+	if (maxIterations <= 0)
+		throw invalid_argument("OnlineLinearSvmTrainer: the maximum number of iterations must be greater than zero");
+}
+
+void OnlineLinearSvmTrainer::train(SupportVectorMachine& svm, const vector<Mat>& positives, const vector<Mat>& negatives) const {
+	if (!dynamic_cast<LinearKernel*>(svm.getKernel().get()))
+		throw invalid_argument("OnlineLinearSvmTrainer: the SVM must use a LinearKernel");
+	if (positives.empty() || negatives.empty())
+		throw invalid_argument("OnlineLinearSvmTrainer: there must be at least one positive and one negative training example");
+	const Mat& example = positives.front();
+	Mat weights = Mat::zeros(1, example.total() * example.channels() + 1, CV_32FC1);
+	optimize(weights, 1.0f, positives, negatives);
+	setWeights(svm, weights, example);
+}
+
+void OnlineLinearSvmTrainer::retrain(SupportVectorMachine& svm, const vector<Mat>& positives, const vector<Mat>& negatives) const {
+	if (!dynamic_cast<LinearKernel*>(svm.getKernel().get()))
+		throw invalid_argument("OnlineLinearSvmTrainer: the SVM must use a LinearKernel");
+	if (svm.getSupportVectors().size() != 1)
+		throw invalid_argument("OnlineLinearSvmTrainer: the SVM must have been trained before and have exactly one support vector");
+	if (learnRate == 0 || (positives.empty() && negatives.empty()))
+		return;
+	const Mat& example = positives.empty() ? negatives.front() : positives.front();
+	Mat weights = getWeights(svm);
+	if (weights.cols != example.total() * example.channels() + 1)
+		throw invalid_argument("OnlineLinearSvmTrainer: the dimensions of the training examples and the SVM do not match");
+	weights *= 1 - learnRate;
+	optimize(weights, static_cast<float>(learnRate), positives, negatives);
+	setWeights(svm, weights, example);
+}
+
+void OnlineLinearSvmTrainer::optimize(Mat& weights, float scale, const vector<Mat>& positives, const vector<Mat>& negatives) const {
+	Mat examples = createExampleMatrix(positives, negatives);
+	int exampleCount = examples.rows;
+	int dimensions = examples.cols;
+	double positiveC = c;
+	double negativeC = c;
+	if (compensateImbalance && !positives.empty() && !negatives.empty()) {
+		positiveC *= static_cast<double>(negatives.size()) / static_cast<double>(positives.size());
+		negativeC *= static_cast<double>(positives.size()) / static_cast<double>(negatives.size());
+	}
+	vector<float> alphas(exampleCount, 0.0f);
+	vector<float> diagonal(exampleCount);
+	for (int i = 0; i < exampleCount; ++i) {
+		const float* x = examples.ptr<float>(i);
+		diagonal[i] = scale * std::inner_product(x, x + dimensions, x, 0.0f);
+	}
+	vector<int> order(exampleCount);
+	std::iota(order.begin(), order.end(), 0);
+	float* w = weights.ptr<float>();
+	for (int iteration = 0; iteration < maxIterations; ++iteration) {
+		std::shuffle(order.begin(), order.end(), generator);
+		double maxProjectedGradient = -std::numeric_limits<double>::infinity();
+		double minProjectedGradient = std::numeric_limits<double>::infinity();
+		for (int i : order) {
+			const float* x = examples.ptr<float>(i);
+			float label = i < positives.size() ? 1.0f : -1.0f;
+			float upperBound = static_cast<float>(label > 0 ? positiveC : negativeC);
+			float gradient = label * std::inner_product(x, x + dimensions, w, 0.0f) - 1.0f;
+			float projectedGradient = gradient;
+			if (alphas[i] == 0)
+				projectedGradient = std::min(gradient, 0.0f);
+			else if (alphas[i] == upperBound)
+				projectedGradient = std::max(gradient, 0.0f);
+			maxProjectedGradient = std::max(maxProjectedGradient, static_cast<double>(projectedGradient));
+			minProjectedGradient = std::min(minProjectedGradient, static_cast<double>(projectedGradient));
+			if (std::abs(projectedGradient) > 1e-12f && diagonal[i] > 0) {
+				float oldAlpha = alphas[i];
+				alphas[i] = std::min(std::max(oldAlpha - gradient / diagonal[i], 0.0f), upperBound);
+				float delta = (alphas[i] - oldAlpha) * label * scale;
+				for (int d = 0; d < dimensions; ++d)
+					w[d] += delta * x[d];
+			}
+		}
+		if (maxProjectedGradient - minProjectedGradient <= epsilon)
+			break;
+	}
+}
+
+Mat OnlineLinearSvmTrainer::createExampleMatrix(const vector<Mat>& positives, const vector<Mat>& negatives) const {
+	const Mat& firstExample = positives.empty() ? negatives.front() : positives.front();
+	int dimensions = firstExample.total() * firstExample.channels();
+	Mat examples(positives.size() + negatives.size(), dimensions + 1, CV_32FC1);
+	int row = 0;
+	for (const vector<Mat>* exampleSet : { &positives, &negatives }) {
+		for (const Mat& example : *exampleSet) {
+			if (example.total() * example.channels() != dimensions)
+				throw invalid_argument("OnlineLinearSvmTrainer: all training examples must have the same dimensions");
+			Mat features(example.rows, example.cols, CV_MAKETYPE(CV_32F, example.channels()), examples.ptr<float>(row));
+			example.convertTo(features, features.type());
+			examples.at<float>(row, dimensions) = 1.0f;
+			++row;
+		}
+	}
+	return examples;
+}
+
+Mat OnlineLinearSvmTrainer::getWeights(const SupportVectorMachine& svm) const {
+	const Mat& supportVector = svm.getSupportVectors().front();
+	int dimensions = supportVector.total() * supportVector.channels();
+	Mat weights(1, dimensions + 1, CV_32FC1);
+	Mat weightVector(supportVector.rows, supportVector.cols, CV_MAKETYPE(CV_32F, supportVector.channels()), weights.ptr<float>());
+	supportVector.convertTo(weightVector, weightVector.type(), svm.getCoefficients().front());
+	weights.at<float>(0, dimensions) = -svm.getBias();
+	return weights;
+}
+
+void OnlineLinearSvmTrainer::setWeights(SupportVectorMachine& svm, const Mat& weights, const Mat& example) const {
+	int dimensions = weights.cols - 1;
+	Mat supportVector = weights.colRange(0, dimensions).clone().reshape(example.channels(), example.rows);
+	svm.setSupportVectorsAndCoefficients(vector<Mat>{supportVector}, vector<float>{1});
+	svm.setBias(-weights.at<float>(0, dimensions));
+}
+
+} /* namespace classification */
@@ -15,6 +15,8 @@ using std::string;
 using std::make_pair;
 using std::shared_ptr;
 using std::make_shared;
+using std::vector;
+using std::runtime_error;
 
 namespace classification {
 
@@ -32,6 +34,10 @@ pair<bool, double> ProbabilisticSupportVectorMachine::getConfidence(const Mat& f
 	return svm->getConfidence(featureVector);
 }
 
+vector<pair<bool, double>> ProbabilisticSupportVectorMachine::getConfidences(const vector<Mat>& featureVectors) const {
+	return svm->getConfidences(featureVectors);
+}
+
 pair<bool, double> ProbabilisticSupportVectorMachine::getProbability(const Mat& featureVector) const {
 	return getProbability(svm->computeHyperplaneDistance(featureVector));
 }
@@ -62,7 +68,21 @@ std::shared_ptr<ProbabilisticSupportVectorMachine> ProbabilisticSupportVectorMac
 	file >> tmp; // "Logistic"
 	file >> logisticB;
 	file >> logisticA;
+	if (!file || tmp != "Logistic") // SVM without logistic parameters
+		return make_shared<ProbabilisticSupportVectorMachine>(svm);
 	return make_shared<ProbabilisticSupportVectorMachine>(svm, logisticA, logisticB);
 }
 
+shared_ptr<ProbabilisticSupportVectorMachine> ProbabilisticSupportVectorMachine::loadBinary(const string& filename) {
+	vector<double> parameters;
+	shared_ptr<SupportVectorMachine> svm = SupportVectorMachine::loadBinary(filename, &parameters);
+	if (parameters.size() < 2) // SVM without logistic parameters
+		return make_shared<ProbabilisticSupportVectorMachine>(svm);
+	return make_shared<ProbabilisticSupportVectorMachine>(svm, parameters[0], parameters[1]);
+}
+
+void ProbabilisticSupportVectorMachine::storeBinary(const string& filename) const {
+	svm->storeBinary(filename, vector<double>{logisticA, logisticB});
+}
+
 } /* namespace classification */
@@ -0,0 +1,164 @@
+/*
+ * ReducedSetApproximator.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "classification/LinearKernel.hpp"
+#include "classification/RbfKernel.hpp"
+#include "classification/ReducedSetApproximator.hpp"
+#include <cmath>
+#include <stdexcept>
+
+using cv::Mat;
+using std::invalid_argument;
+using std::make_shared;
+using std::shared_ptr;
+using std::vector;
+
+namespace classification {
+
+ReducedSetApproximator::ReducedSetApproximator(int supportVectorCount, int fixedPointIterations) :
+		supportVectorCount(supportVectorCount), fixedPointIterations(fixedPointIterations) {
+	if (supportVectorCount <= 0)
+		throw invalid_argument("ReducedSetApproximator: the number of support vectors must be greater than zero");
+	if (fixedPointIterations < 0)
+		throw invalid_argument("ReducedSetApproximator: the number of fixed-point iterations must not be negative");
+}
+
+shared_ptr<SupportVectorMachine> ReducedSetApproximator::approximate(const SupportVectorMachine& svm) const {
+	const Kernel& kernel = *svm.getKernel();
+	const vector<Mat>& supportVectors = svm.getSupportVectors();
+	const vector<float>& coefficients = svm.getCoefficients();
+	shared_ptr<SupportVectorMachine> approximation = make_shared<SupportVectorMachine>(svm.getKernel());
+	approximation->setBias(svm.getBias());
+	approximation->setThreshold(svm.getThreshold());
+	if (supportVectors.size() <= static_cast<size_t>(supportVectorCount)) {
+		vector<Mat> copiedSupportVectors;
+		for (const Mat& supportVector : supportVectors)
+			copiedSupportVectors.push_back(supportVector.clone()); // might refer to a memory-mapped file
+		approximation->setSupportVectorsAndCoefficients(copiedSupportVectors, coefficients);
+		return approximation;
+	}
+	bool singlePrecision = supportVectors.front().depth() == CV_32F;
+	if (singlePrecision && dynamic_cast<const LinearKernel*>(&kernel)) {
+		Mat weightVector = Mat::zeros(supportVectors.front().size(), supportVectors.front().type());
+		for (size_t i = 0; i < supportVectors.size(); ++i)
+			weightVector += coefficients[i] * supportVectors[i];
+		approximation->setSupportVectorsAndCoefficients(vector<Mat>{weightVector}, vector<float>{1});
+		return approximation;
+	}
+	bool refinable = singlePrecision && fixedPointIterations > 0 && dynamic_cast<const RbfKernel*>(&kernel);
+
+	// projections of the support vectors onto the original weight vector
+	int n = static_cast<int>(supportVectors.size());
+	vector<double> projections(n, 0.0);
+	vector<double> squaredNorms(n);
+	for (int i = 0; i < n; ++i) {
+		squaredNorms[i] = kernel.compute(supportVectors[i], supportVectors[i]);
+		projections[i] += coefficients[i] * squaredNorms[i];
+		for (int k = i + 1; k < n; ++k) {
+			double value = kernel.compute(supportVectors[i], supportVectors[k]);
+			projections[i] += coefficients[k] * value;
+			projections[k] += coefficients[i] * value;
+		}
+	}
+
+	vector<Mat> reducedVectors;
+	vector<double> betas;
+	Mat reducedKernelValues(0, n, CV_64FC1); // kernel values of reduced vectors (rows) and support vectors (columns)
+	Mat reducedGram(supportVectorCount, supportVectorCount, CV_64FC1); // kernel values among the reduced vectors
+	Mat reducedProjections(supportVectorCount, 1, CV_64FC1); // projections of the reduced vectors onto the weight vector
+	vector<bool> selected(n, false);
+	while (reducedVectors.size() < static_cast<size_t>(supportVectorCount)) {
+		// support vector with the largest normalized projection onto the residual
+		int best = -1;
+		double bestScore = 0;
+		for (int i = 0; i < n; ++i) {
+			if (selected[i] || squaredNorms[i] <= 0)
+				continue;
+			double residualProjection = projections[i];
+			for (size_t j = 0; j < reducedVectors.size(); ++j)
+				residualProjection -= betas[j] * reducedKernelValues.at<double>(static_cast<int>(j), i);
+			double score = residualProjection * residualProjection / squaredNorms[i];
+			if (best < 0 || score > bestScore) {
+				best = i;
+				bestScore = score;
+			}
+		}
+		if (best < 0)
+			break;
+		selected[best] = true;
+		Mat reducedVector = supportVectors[best].clone();
+		if (refinable) {
+			vector<Mat> expansionVectors(supportVectors);
+			vector<double> expansionWeights(coefficients.begin(), coefficients.end());
+			for (size_t j = 0; j < reducedVectors.size(); ++j) {
+				expansionVectors.push_back(reducedVectors[j]);
+				expansionWeights.push_back(-betas[j]);
+			}
+			reducedVector = refine(kernel, expansionVectors, expansionWeights, reducedVector);
+		}
+
+		int m = static_cast<int>(reducedVectors.size());
+		Mat kernelValues(1, n, CV_64FC1);
+		double projection = 0;
+		for (int i = 0; i < n; ++i) {
+			kernelValues.at<double>(0, i) = kernel.compute(reducedVector, supportVectors[i]);
+			projection += coefficients[i] * kernelValues.at<double>(0, i);
+		}
+		reducedKernelValues.push_back(kernelValues);
+		for (int j = 0; j < m; ++j) {
+			double value = kernel.compute(reducedVector, reducedVectors[j]);
+			reducedGram.at<double>(m, j) = value;
+			reducedGram.at<double>(j, m) = value;
+		}
+		reducedGram.at<double>(m, m) = kernel.compute(reducedVector, reducedVector);
+		reducedProjections.at<double>(m) = projection;
+		reducedVectors.push_back(reducedVector);
+
+		// least-squares coefficients: gram * beta = projections
+		Mat solution;
+		cv::solve(reducedGram(cv::Rect(0, 0, m + 1, m + 1)), reducedProjections.rowRange(0, m + 1), solution, cv::DECOMP_SVD);
+		betas.assign(solution.begin<double>(), solution.end<double>());
+	}
+
+	approximation->setSupportVectorsAndCoefficients(reducedVectors, vector<float>(betas.begin(), betas.end()));
+	return approximation;
+}
+
+Mat ReducedSetApproximator::refine(const Kernel& kernel, const vector<Mat>& vectors, const vector<double>& weights,
+		const Mat& initialVector) const {
+	auto computeProjection = [&](const Mat& candidate) {
+		double projection = 0;
+		for (size_t k = 0; k < vectors.size(); ++k)
+			projection += weights[k] * kernel.compute(vectors[k], candidate);
+		return projection;
+	};
+	Mat refinedVector = initialVector.clone();
+	double projection = computeProjection(refinedVector);
+	Mat convertedVector;
+	for (int iteration = 0; iteration < fixedPointIterations; ++iteration) {
+		Mat numerator = Mat::zeros(refinedVector.size(), CV_MAKETYPE(CV_64F, refinedVector.channels()));
+		double denominator = 0;
+		for (size_t k = 0; k < vectors.size(); ++k) {
+			double factor = weights[k] * kernel.compute(vectors[k], refinedVector);
+			vectors[k].convertTo(convertedVector, CV_64F);
+			cv::scaleAdd(convertedVector, factor, numerator, numerator);
+			denominator += factor;
+		}
+		if (std::abs(denominator) < 1e-12)
+			break;
+		Mat candidate;
+		numerator.convertTo(candidate, refinedVector.type(), 1 / denominator);
+		double candidateProjection = computeProjection(candidate);
+		if (std::abs(candidateProjection) <= std::abs(projection) * (1 + 1e-6))
+			break;
+		refinedVector = candidate;
+		projection = candidateProjection;
+	}
+	return refinedVector;
+}
+
+} /* namespace classification */
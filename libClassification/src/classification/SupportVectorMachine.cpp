@@ -6,25 +6,225 @@
  */
 
 #include "classification/HistogramIntersectionKernel.hpp"
+#include "classification/KernelVisitor.hpp"
 #include "classification/LinearKernel.hpp"
 #include "classification/PolynomialKernel.hpp"
 #include "classification/RbfKernel.hpp"
 #include "classification/SupportVectorMachine.hpp"
+#include "filemapping/MappedFile.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 
 using cv::Mat;
+using filemapping::MappedFile;
 using std::pair;
 using std::string;
 using std::vector;
 using std::shared_ptr;
 using std::make_shared;
 using std::make_pair;
+using std::invalid_argument;
 using std::runtime_error;
 
 namespace classification {
 
+namespace {
+
+const char binaryMagic[8] = {'S', 'V', 'M', 'M', 'O', 'D', 'E', 'L'}; ///< First bytes of binary SVM files.
+const uint32_t binaryVersion = 1; ///< Current version of the binary format.
+const uint32_t binaryByteOrder = 0x01020304; ///< Marker for detecting files with a different byte order.
+const uint64_t binaryAlignment = 64; ///< Alignment of the sections of binary files.
+
+enum BinaryKernelType : int32_t { BINARY_LINEAR = 0, BINARY_POLYNOMIAL = 1, BINARY_RBF = 2, BINARY_HIK = 3 };
+
+/**
+ * Header of binary SVM files.
+ */
+struct BinaryHeader {
+	char magic[8]; ///< Magic number, see binaryMagic.
+	uint32_t version; ///< Version of the format.
+	uint32_t byteOrder; ///< Byte order marker, see binaryByteOrder.
+	int32_t kernelType; ///< Type of the kernel, see BinaryKernelType.
+	int32_t degree; ///< Degree of the polynomial kernel.
+	double constant; ///< Constant of the polynomial kernel.
+	double alpha; ///< Scale of the polynomial kernel.
+	double gamma; ///< Parameter gamma of the RBF kernel.
+	float bias; ///< Bias of the SVM.
+	uint32_t count; ///< Number of support vectors and coefficients.
+	int32_t rows; ///< Row count of the support vectors.
+	int32_t cols; ///< Column count of the support vectors.
+	int32_t channels; ///< Channel count of the support vectors.
+	int32_t depth; ///< Depth of the support vectors.
+	uint32_t parameterCount; ///< Number of additional parameters.
+	uint32_t reserved; ///< Unused, zero.
+	uint64_t parametersOffset; ///< Offset of the additional parameters (double) in bytes.
+	uint64_t coefficientsOffset; ///< Offset of the coefficients (float) in bytes.
+	uint64_t supportVectorsOffset; ///< Offset of the support vectors in bytes.
+	uint64_t fileSize; ///< Size of the whole file in bytes.
+};
+
+uint64_t alignOffset(uint64_t offset) {
+	return (offset + binaryAlignment - 1) / binaryAlignment * binaryAlignment;
+}
+
+/**
+ * Checks whether a section of a binary file lies within the given range without overflowing.
+ *
+ * @param[in] offset Offset of the section in bytes.
+ * @param[in] count Number of elements of the section.
+ * @param[in] elementSize Size of each element in bytes.
+ * @param[in] begin Offset of the range in bytes.
+ * @param[in] end Offset behind the range in bytes.
+ * @return True if the section is aligned and lies completely within the range, false otherwise.
+ */
+bool isWithin(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t begin, uint64_t end) {
+	return offset % binaryAlignment == 0 && offset >= begin && offset <= end && count <= (end - offset) / elementSize;
+}
+
+/**
+ * Computes the hyperplane distances of feature vectors given as rows of a matrix. The kernel type is resolved once
+ * by visiting the kernel, so there is no virtual call per pair of feature vector and support vector.
+ */
+class HyperplaneDistanceComputation : public KernelVisitor {
+public:
+
+	/**
+	 * @param[in] featureVectors Matrix of type CV_32FC1 with one feature vector per row.
+	 * @param[in] supportVectors Matrix of type CV_32FC1 with one support vector per row.
+	 * @param[in] coefficients Column vector of type CV_32FC1 with the coefficients of the support vectors.
+	 * @param[in] bias The bias that is subtracted from the sum over all scaled kernel values.
+	 */
+	HyperplaneDistanceComputation(const Mat& featureVectors, const Mat& supportVectors, const Mat& coefficients, float bias) :
+			featureVectors(featureVectors), supportVectors(supportVectors), coefficients(coefficients), bias(bias), distances() {}
+
+	void visit(const LinearKernel& kernel) override {
+		Mat weights = coefficients.t() * supportVectors;
+		cv::gemm(featureVectors, weights, 1.0, cv::noArray(), 0.0, distances, cv::GEMM_2_T);
+		distances -= bias;
+	}
+
+	void visit(const PolynomialKernel& kernel) override {
+		computeBlockwise([&](const Mat& block, Mat& kernelValues) {
+			cv::gemm(block, supportVectors, kernel.getAlpha(), cv::noArray(), 0.0, kernelValues, cv::GEMM_2_T);
+			kernelValues += kernel.getConstant();
+			cv::pow(kernelValues, kernel.getDegree(), kernelValues);
+		});
+	}
+
+	void visit(const RbfKernel& kernel) override {
+		Mat supportVectorNorms = computeSquaredNorms(supportVectors).t();
+		computeBlockwise([&](const Mat& block, Mat& kernelValues) {
+			// |u - v|² = |u|² + |v|² - 2 * u * v
+			Mat featureVectorNorms = computeSquaredNorms(block);
+			cv::gemm(block, supportVectors, -2.0, cv::noArray(), 0.0, kernelValues, cv::GEMM_2_T);
+			for (int row = 0; row < kernelValues.rows; ++row) {
+				float* values = kernelValues.ptr<float>(row);
+				const float* svNorms = supportVectorNorms.ptr<float>();
+				float fvNorm = featureVectorNorms.at<float>(row);
+				for (int col = 0; col < kernelValues.cols; ++col)
+					values[col] = static_cast<float>(-kernel.getGamma()) * std::max(0.0f, values[col] + fvNorm + svNorms[col]);
+			}
+			cv::exp(kernelValues, kernelValues);
+		});
+	}
+
+	void visit(const HistogramIntersectionKernel& kernel) override {
+		const int supportVectorBlockSize = 64;
+		int dimensions = supportVectors.cols;
+		computeBlockwise([&](const Mat& block, Mat& kernelValues) {
+			kernelValues.create(block.rows, supportVectors.rows, CV_32FC1);
+			for (int svStart = 0; svStart < supportVectors.rows; svStart += supportVectorBlockSize) {
+				int svEnd = std::min(svStart + supportVectorBlockSize, supportVectors.rows);
+				for (int row = 0; row < block.rows; ++row) {
+					const float* featureVector = block.ptr<float>(row);
+					float* values = kernelValues.ptr<float>(row);
+					for (int sv = svStart; sv < svEnd; ++sv) {
+						const float* supportVector = supportVectors.ptr<float>(sv);
+						float sum = 0;
+						for (int d = 0; d < dimensions; ++d)
+							sum += std::min(featureVector[d], supportVector[d]);
+						values[sv] = sum;
+					}
+				}
+			}
+		});
+	}
+
+	/**
+	 * @return Column vector of type CV_32FC1 with the hyperplane distances (available after visiting the kernel).
+	 */
+	const Mat& getDistances() const {
+		return distances;
+	}
+
+private:
+
+	/**
+	 * Computes the hyperplane distances of blocks of feature vectors, so the kernel values of a block stay small.
+	 *
+	 * @param[in] computeKernelValues Function that computes the kernel values of a block of feature vectors (rows)
+	 *   and the support vectors (columns).
+	 */
+	template <typename F>
+	void computeBlockwise(F computeKernelValues) {
+		const int blockSize = 256;
+		distances.create(featureVectors.rows, 1, CV_32FC1);
+		Mat kernelValues;
+		for (int start = 0; start < featureVectors.rows; start += blockSize) {
+			int end = std::min(start + blockSize, featureVectors.rows);
+			computeKernelValues(featureVectors.rowRange(start, end), kernelValues);
+			Mat blockDistances = distances.rowRange(start, end);
+			cv::gemm(kernelValues, coefficients, 1.0, cv::noArray(), 0.0, blockDistances);
+			blockDistances -= bias;
+		}
+	}
+
+	/**
+	 * @param[in] vectors Matrix of type CV_32FC1 with one vector per row.
+	 * @return Column vector with the squared norms of the rows.
+	 */
+	Mat computeSquaredNorms(const Mat& vectors) const {
+		Mat norms;
+		cv::reduce(vectors.mul(vectors), norms, 1, CV_REDUCE_SUM, CV_32F);
+		return norms;
+	}
+
+	const Mat& featureVectors; ///< Matrix of type CV_32FC1 with one feature vector per row.
+	const Mat& supportVectors; ///< Matrix of type CV_32FC1 with one support vector per row.
+	const Mat& coefficients; ///< Column vector of type CV_32FC1 with the coefficients of the support vectors.
+	float bias; ///< The bias that is subtracted from the sum over all scaled kernel values.
+	Mat distances; ///< Column vector of type CV_32FC1 with the hyperplane distances.
+};
+
+} // namespace
+
 SupportVectorMachine::SupportVectorMachine(shared_ptr<Kernel> kernel) :
-		kernel(kernel), supportVectors(), coefficients(), bias(0), threshold(0) {}
+		kernel(kernel), supportVectors(), coefficients(), bias(0), threshold(0), evaluator(), mapping() {}
+
+void SupportVectorMachine::setSupportVectors(vector<Mat> supportVectors) {
+	this->supportVectors = std::move(supportVectors);
+	updateEvaluator();
+}
+
+void SupportVectorMachine::setCoefficients(vector<float> coefficients) {
+	this->coefficients = std::move(coefficients);
+	updateEvaluator();
+}
+
+void SupportVectorMachine::setSupportVectorsAndCoefficients(vector<Mat> supportVectors, vector<float> coefficients) {
+	this->supportVectors = std::move(supportVectors);
+	this->coefficients = std::move(coefficients);
+	updateEvaluator();
+}
+
+void SupportVectorMachine::updateEvaluator() {
+	if (!supportVectors.empty() && supportVectors.size() == coefficients.size())
+		evaluator = KernelEvaluator::create(*kernel, supportVectors, coefficients);
+	else
+		evaluator.reset();
+}
 
 bool SupportVectorMachine::classify(const Mat& featureVector) const {
 	return classify(computeHyperplaneDistance(featureVector));
@@ -46,12 +246,69 @@ pair<bool, double> SupportVectorMachine::getConfidence(double hyperplaneDistance
 }
 
 double SupportVectorMachine::computeHyperplaneDistance(const Mat& featureVector) const {
+	if (evaluator)
+		return evaluator->compute(featureVector) - bias;
 	double distance = -bias;
 	for (size_t i = 0; i < supportVectors.size(); ++i)
 		distance += coefficients[i] * kernel->compute(featureVector, supportVectors[i]);
 	return distance;
 }
 
+vector<double> SupportVectorMachine::computeHyperplaneDistances(const vector<Mat>& featureVectors) const {
+	if (featureVectors.empty())
+		return vector<double>();
+	if (supportVectors.empty())
+		return vector<double>(featureVectors.size(), -bias);
+	size_t dimensions = supportVectors.front().total() * supportVectors.front().channels();
+	Mat featureVectorMatrix(featureVectors.size(), dimensions, CV_32FC1);
+	for (size_t i = 0; i < featureVectors.size(); ++i) {
+		const Mat& featureVector = featureVectors[i];
+		if (featureVector.total() * featureVector.channels() != dimensions)
+			throw invalid_argument("SupportVectorMachine: feature vectors must have the same number of values as the support vectors");
+		Mat row(featureVector.rows, featureVector.cols, CV_MAKETYPE(CV_32F, featureVector.channels()), featureVectorMatrix.ptr<float>(i));
+		featureVector.convertTo(row, row.type());
+	}
+	return computeHyperplaneDistances(featureVectorMatrix);
+}
+
+vector<double> SupportVectorMachine::computeHyperplaneDistances(const Mat& featureVectors) const {
+	if (featureVectors.empty())
+		return vector<double>();
+	if (supportVectors.empty())
+		return vector<double>(featureVectors.rows, -bias);
+	Mat featureVectorMatrix = featureVectors.reshape(1);
+	if (featureVectorMatrix.cols != supportVectors.front().total() * supportVectors.front().channels())
+		throw invalid_argument("SupportVectorMachine: feature vectors must have the same number of values as the support vectors");
+	if (featureVectorMatrix.depth() != CV_32F)
+		featureVectorMatrix.convertTo(featureVectorMatrix, CV_32F);
+	Mat supportVectorMatrix = createSupportVectorMatrix();
+	Mat coefficientVector(coefficients.size(), 1, CV_32FC1, const_cast<float*>(coefficients.data()));
+	HyperplaneDistanceComputation computation(featureVectorMatrix, supportVectorMatrix, coefficientVector, bias);
+	kernel->accept(computation);
+	const Mat& distances = computation.getDistances();
+	return vector<double>(distances.begin<float>(), distances.end<float>());
+}
+
+vector<pair<bool, double>> SupportVectorMachine::getConfidences(const vector<Mat>& featureVectors) const {
+	vector<double> distances = computeHyperplaneDistances(featureVectors);
+	vector<pair<bool, double>> confidences;
+	confidences.reserve(distances.size());
+	for (double distance : distances)
+		confidences.push_back(getConfidence(distance));
+	return confidences;
+}
+
+Mat SupportVectorMachine::createSupportVectorMatrix() const {
+	const Mat& firstSupportVector = supportVectors.front();
+	Mat supportVectorMatrix(supportVectors.size(), firstSupportVector.total() * firstSupportVector.channels(), CV_32FC1);
+	for (size_t i = 0; i < supportVectors.size(); ++i) {
+		const Mat& supportVector = supportVectors[i];
+		Mat row(supportVector.rows, supportVector.cols, CV_MAKETYPE(CV_32F, supportVector.channels()), supportVectorMatrix.ptr<float>(i));
+		supportVector.convertTo(row, row.type());
+	}
+	return supportVectorMatrix;
+}
+
 void SupportVectorMachine::store(std::ofstream& file) const {
 	if (!file)
 		throw runtime_error("SupportVectorMachine: Cannot write into stream");
@@ -89,6 +346,126 @@ void SupportVectorMachine::store(std::ofstream& file) const {
 	}
 }
 
+void SupportVectorMachine::storeBinary(const string& filename, const vector<double>& parameters) const {
+	if (supportVectors.empty() || supportVectors.size() != coefficients.size())
+		throw runtime_error("SupportVectorMachine: cannot store an SVM without support vectors or with missing coefficients");
+	BinaryHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, binaryMagic, sizeof(header.magic));
+	header.version = binaryVersion;
+	header.byteOrder = binaryByteOrder;
+	if (dynamic_cast<LinearKernel*>(getKernel().get())) {
+		header.kernelType = BINARY_LINEAR;
+	} else if (PolynomialKernel* kernel = dynamic_cast<PolynomialKernel*>(getKernel().get())) {
+		header.kernelType = BINARY_POLYNOMIAL;
+		header.degree = kernel->getDegree();
+		header.constant = kernel->getConstant();
+		header.alpha = kernel->getAlpha();
+	} else if (RbfKernel* kernel = dynamic_cast<RbfKernel*>(getKernel().get())) {
+		header.kernelType = BINARY_RBF;
+		header.gamma = kernel->getGamma();
+	} else if (dynamic_cast<HistogramIntersectionKernel*>(getKernel().get())) {
+		header.kernelType = BINARY_HIK;
+	} else {
+		throw runtime_error("SupportVectorMachine: cannot write kernel parameters (unknown kernel type)");
+	}
+	const Mat& firstSupportVector = supportVectors.front();
+	header.bias = bias;
+	header.count = static_cast<uint32_t>(supportVectors.size());
+	header.rows = firstSupportVector.rows;
+	header.cols = firstSupportVector.cols;
+	header.channels = firstSupportVector.channels();
+	header.depth = firstSupportVector.depth();
+	header.parameterCount = static_cast<uint32_t>(parameters.size());
+	size_t supportVectorSize = firstSupportVector.total() * firstSupportVector.elemSize();
+	header.parametersOffset = alignOffset(sizeof(header));
+	header.coefficientsOffset = alignOffset(header.parametersOffset + parameters.size() * sizeof(double));
+	header.supportVectorsOffset = alignOffset(header.coefficientsOffset + coefficients.size() * sizeof(float));
+	header.fileSize = header.supportVectorsOffset + supportVectors.size() * supportVectorSize;
+
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+		throw runtime_error("SupportVectorMachine: cannot write into file '" + filename + "'");
+	const char padding[binaryAlignment] = {};
+	auto pad = [&](uint64_t offset) {
+		file.write(padding, offset - static_cast<uint64_t>(file.tellp()));
+	};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	pad(header.parametersOffset);
+	file.write(reinterpret_cast<const char*>(parameters.data()), parameters.size() * sizeof(double));
+	pad(header.coefficientsOffset);
+	file.write(reinterpret_cast<const char*>(coefficients.data()), coefficients.size() * sizeof(float));
+	pad(header.supportVectorsOffset);
+	for (const Mat& supportVector : supportVectors) {
+		if (supportVector.type() != firstSupportVector.type() || supportVector.size() != firstSupportVector.size())
+			throw runtime_error("SupportVectorMachine: all support vectors must have the same size and type");
+		Mat continuousSupportVector = supportVector.isContinuous() ? supportVector : supportVector.clone();
+		file.write(reinterpret_cast<const char*>(continuousSupportVector.data), supportVectorSize);
+	}
+	if (!file)
+		throw runtime_error("SupportVectorMachine: cannot write into file '" + filename + "'");
+}
+
+shared_ptr<SupportVectorMachine> SupportVectorMachine::loadBinary(const string& filename, vector<double>* parameters) {
+	shared_ptr<const MappedFile> mapping = make_shared<MappedFile>(filename);
+	BinaryHeader header;
+	if (mapping->size() < sizeof(header))
+		throw runtime_error("SupportVectorMachine: file '" + filename + "' is too small to contain an SVM");
+	std::memcpy(&header, mapping->data(), sizeof(header));
+	if (std::memcmp(header.magic, binaryMagic, sizeof(header.magic)) != 0)
+		throw runtime_error("SupportVectorMachine: file '" + filename + "' does not contain a binary SVM");
+	if (header.byteOrder != binaryByteOrder)
+		throw runtime_error("SupportVectorMachine: file '" + filename + "' was written with a different byte order");
+	if (header.version != binaryVersion)
+		throw runtime_error("SupportVectorMachine: unsupported version " + std::to_string(header.version) + " of file '" + filename + "'");
+	if (header.depth != CV_8U && header.depth != CV_32S && header.depth != CV_32F && header.depth != CV_64F)
+		throw runtime_error("SupportVectorMachine: cannot load support vectors of depth other than CV_8U, CV_32S, CV_32F or CV_64F");
+	if (header.count == 0 || header.rows <= 0 || header.cols <= 0 || header.channels <= 0 || header.channels > CV_CN_MAX)
+		throw runtime_error("SupportVectorMachine: invalid support vector dimensions in file '" + filename + "'");
+	int type = CV_MAKETYPE(header.depth, header.channels);
+	// the sizes are validated against the mapped file before computing products that might overflow
+	uint64_t fileSize = mapping->size();
+	uint64_t elementSize = CV_ELEM_SIZE(type);
+	if (header.fileSize != fileSize
+			|| static_cast<uint64_t>(header.rows) > fileSize / elementSize / static_cast<uint64_t>(header.cols))
+		throw runtime_error("SupportVectorMachine: file '" + filename + "' is truncated or corrupt");
+	uint64_t supportVectorSize = static_cast<uint64_t>(header.rows) * header.cols * elementSize;
+	if (!isWithin(header.parametersOffset, header.parameterCount, sizeof(double), sizeof(header), fileSize)
+			|| !isWithin(header.coefficientsOffset, header.count, sizeof(float), header.parametersOffset + header.parameterCount * sizeof(double), fileSize)
+			|| !isWithin(header.supportVectorsOffset, header.count, supportVectorSize, header.coefficientsOffset + header.count * sizeof(float), fileSize))
+		throw runtime_error("SupportVectorMachine: file '" + filename + "' is truncated or corrupt");
+
+	shared_ptr<Kernel> kernel;
+	switch (header.kernelType) {
+		case BINARY_LINEAR: kernel.reset(new LinearKernel()); break;
+		case BINARY_POLYNOMIAL: kernel.reset(new PolynomialKernel(header.alpha, header.constant, header.degree)); break;
+		case BINARY_RBF: kernel.reset(new RbfKernel(header.gamma)); break;
+		case BINARY_HIK: kernel.reset(new HistogramIntersectionKernel()); break;
+		default: throw runtime_error("SupportVectorMachine: Invalid kernel type: " + std::to_string(header.kernelType));
+	}
+	shared_ptr<SupportVectorMachine> svm = make_shared<SupportVectorMachine>(kernel);
+	svm->bias = header.bias;
+	if (parameters) {
+		const double* values = reinterpret_cast<const double*>(mapping->data() + header.parametersOffset);
+		parameters->assign(values, values + header.parameterCount);
+	}
+	const float* coefficients = reinterpret_cast<const float*>(mapping->data() + header.coefficientsOffset);
+	svm->coefficients.assign(coefficients, coefficients + header.count);
+	uchar* supportVectorData = const_cast<uchar*>(mapping->data() + header.supportVectorsOffset);
+	svm->supportVectors.reserve(header.count);
+	for (uint32_t i = 0; i < header.count; ++i)
+		svm->supportVectors.emplace_back(header.rows, header.cols, type, supportVectorData + i * supportVectorSize);
+	svm->mapping = mapping;
+	svm->updateEvaluator();
+	return svm;
+}
+
+bool SupportVectorMachine::isBinary(const string& filename) {
+	std::ifstream file(filename, std::ios::binary);
+	char magic[sizeof(binaryMagic)];
+	return file.read(magic, sizeof(magic)) && std::memcmp(magic, binaryMagic, sizeof(magic)) == 0;
+}
+
 shared_ptr<SupportVectorMachine> SupportVectorMachine::load(std::ifstream& file) {
 	if (!file)
 		throw runtime_error("SupportVectorMachine: Cannot read from stream");
@@ -141,6 +518,7 @@ shared_ptr<SupportVectorMachine> SupportVectorMachine::load(std::ifstream& file)
 		default: throw runtime_error(
 				"SupportVectorMachine: cannot load support vectors of depth other than CV_8U, CV_32S, CV_32F or CV_64F");
 	}
+	svm->updateEvaluator();
 
 	return svm;
 }
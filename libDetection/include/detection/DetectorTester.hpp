@@ -100,6 +100,14 @@ public:
 	 */
 	void evaluate(detection::Detector& detector, const cv::Mat& image, imageio::Annotations annotations);
 
+	/**
+	 * Adds the evaluation data of another tester to the data of this tester, as if this tester evaluated the
+	 * detectors and images of the other tester, too.
+	 *
+	 * @param[in] other Tester whose evaluation data should be added.
+	 */
+	void merge(const DetectorTester& other);
+
 	/**
 	 * @return Summary of the evaluation.
 	 */
@@ -11,13 +11,16 @@
 #include "classification/ClassifierTrainer.hpp"
 #include "classification/ConfidenceBasedExampleManagement.hpp"
 #include "classification/ExampleManagement.hpp"
+#include "classification/ExampleStore.hpp"
 #include "classification/ProbabilisticSupportVectorMachine.hpp"
 #include "classification/SupportVectorMachine.hpp"
 #include "detection/AggregatedFeaturesDetector.hpp"
 #include "detection/NonMaximumSuppression.hpp"
 #include "imageio/AnnotatedImage.hpp"
+#include "imageio/AnnotatedImageSource.hpp"
 #include "imageprocessing/extraction/AggregatedFeaturesExtractor.hpp"
 #include "opencv2/core/core.hpp"
+#include <functional>
 #include <memory>
 #include <random>
 #include <string>
@@ -72,14 +75,26 @@ public:
 	 *
 	 * @param[in] images Images labeled with bounding boxes around positive and fuzzy examples (anything else is considered negative).
 	 */
-	void train(std::vector<imageio::AnnotatedImage> images);
+	void train(const std::vector<imageio::AnnotatedImage>& images);
+
+	/**
+	 * Trains the classifier that is used by the detector, streaming the images from a source.
+	 *
+	 * The source is reset and read once for collecting the initial training examples and once more per
+	 * bootstrapping round, so only one image has to be in memory at a time. Apart from that, the training is
+	 * the same as with a vector of images.
+	 *
+	 * @param[in] images Source of images labeled with bounding boxes around positive and fuzzy examples.
+	 */
+	void train(imageio::AnnotatedImageSource& images);
 
 	/**
 	 * Stores the SVM data into a file.
 	 *
 	 * @param[in] filename Name of the file.
+	 * @param[in] binary Flag that indicates whether to use the binary format that can be memory-mapped when loading.
 	 */
-	void storeClassifier(const std::string& filename) const;
+	void storeClassifier(const std::string& filename, bool binary = false) const;
 
 	/**
 	 * @return Weight vector of the SVM.
@@ -107,15 +122,32 @@ public:
 
 private:
 
+	/**
+	 * Function that passes each training image to the given function.
+	 */
+	typedef std::function<void(const std::function<void(const imageio::AnnotatedImage&)>&)> ImageIteration;
+
+	/**
+	 * Trains the classifier, iterating over the training images once per round.
+	 *
+	 * @param[in] forEachImage Function that passes each training image to the given function.
+	 */
+	void train(const ImageIteration& forEachImage);
+
 	void createEmptyClassifier();
 
-	void collectInitialTrainingExamples(std::vector<imageio::AnnotatedImage> images);
+	void collectInitialTrainingExamples(const ImageIteration& forEachImage);
 
-	void collectHardTrainingExamples(std::vector<imageio::AnnotatedImage> images);
+	void collectHardTrainingExamples(const ImageIteration& forEachImage);
 
 	void createHardNegativesDetector();
 
-	void collectTrainingExamples(std::vector<imageio::AnnotatedImage> images, bool initial);
+	void collectTrainingExamples(const ImageIteration& forEachImage, bool initial);
+
+	/**
+	 * Moves the buffered new training examples into the example management.
+	 */
+	void addCollectedExamples();
 
 	/**
 	 * Adjusts the size and aspect ratio of the annotations to fit the feature window size.
@@ -176,6 +208,9 @@ public:
 	int bootstrappingRounds = 3; ///< Number of bootstrapping rounds.
 	float negativeScoreThreshold = -1.0f; ///< SVM score threshold for retrieving strong negative examples.
 	double overlapThreshold = 0.3; ///< Maximum allowed overlap between negative examples and non-negative annotations.
+	bool compactExampleStorage = false; ///< Flag that indicates whether to keep the training examples in compact example stores.
+	classification::ExampleStore::Precision negativePrecision = classification::ExampleStore::Precision::FLOAT32; ///< Precision of compactly stored negative examples.
+	size_t exampleBatchSize = 1000; ///< Maximum number of new training examples that are buffered before adding them to the example management.
 
 private:
 
@@ -191,8 +226,10 @@ private:
 	std::shared_ptr<detection::AggregatedFeaturesDetector> hardNegativesDetector;
 	std::unique_ptr<classification::ExampleManagement> positives;
 	std::unique_ptr<classification::ExampleManagement> negatives;
-	std::vector<cv::Mat> newPositives;
-	std::vector<cv::Mat> newNegatives;
+	std::vector<cv::Mat> newPositives; ///< Buffered new positive training examples.
+	std::vector<cv::Mat> newNegatives; ///< Buffered new negative training examples.
+	size_t collectedPositiveCount = 0; ///< Number of positive training examples that were collected in the current round.
+	size_t collectedNegativeCount = 0; ///< Number of negative training examples that were collected in the current round.
 	cv::Mat image;
 	cv::Size imageSize;
 };
@@ -7,6 +7,7 @@
 
 #include "classification/LinearKernel.hpp"
 #include "detection/AggregatedFeaturesDetector.hpp"
+#include "imageprocessing/Instrumentation.hpp"
 #include "imageprocessing/Patch.hpp"
 #include "imageprocessing/filtering/GrayscaleFilter.hpp"
 #include <stdexcept>
@@ -74,8 +75,12 @@ vector<pair<Rect, float>> AggregatedFeaturesDetector::detectWithScores(shared_pt
 }
 
 void AggregatedFeaturesDetector::update(shared_ptr<VersionedImage> image) {
-	featureExtractor->update(image);
-	scorePyramid->update(image);
+	{
+		INSTRUMENT_SCOPE("detector.features");
+		featureExtractor->update(image);
+	}
+	INSTRUMENT_SCOPE("detector.scoring");
+	scorePyramid->update(); // the source feature pyramid is up-to-date already (and might be shared with a cache)
 }
 
 vector<Rect> AggregatedFeaturesDetector::detect() {
@@ -91,6 +96,7 @@ vector<pair<Rect, float>> AggregatedFeaturesDetector::detectWithScores() {
 }
 
 vector<Detection> AggregatedFeaturesDetector::getPositiveWindows() {
+	INSTRUMENT_SCOPE("detector.windows");
 	vector<Detection> positiveBounds;
 	for (const shared_ptr<ImagePyramidLayer>& layer : scorePyramid->getLayers()) {
 		const Mat& scoreMap = layer->getScaledImage();
@@ -108,6 +114,7 @@ vector<Detection> AggregatedFeaturesDetector::getPositiveWindows() {
 			}
 		}
 	}
+	INSTRUMENT_COUNT("detector.candidates", positiveBounds.size());
 	return positiveBounds;
 }
 
@@ -49,6 +49,13 @@ void DetectorTester::evaluate(Detector& detector, const Mat& image, Annotations
 	mergeInto(classifiedScores, classifyScores(detections, annotations));
 }
 
+void DetectorTester::merge(const DetectorTester& other) {
+	detectionTimeSum += other.detectionTimeSum;
+	imageCount += other.imageCount;
+	positiveCount += other.positiveCount;
+	mergeInto(classifiedScores, other.classifiedScores);
+}
+
 vector<pair<float, bool>> DetectorTester::classifyScores(const vector<pair<Rect, float>>& detections, Annotations annotations) const {
 	vector<pair<float, bool>> classifiedScores;
 	classifiedScores.reserve(detections.size());
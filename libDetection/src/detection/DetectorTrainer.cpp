@@ -8,12 +8,14 @@
 #include "classification/LinearKernel.hpp"
 #include "classification/UnlimitedExampleManagement.hpp"
 #include "detection/DetectorTrainer.hpp"
-#include "imageprocessing/Patch.hpp"
+#include "imageprocessing/Instrumentation.hpp"
+#include "imageprocessing/PatchView.hpp"
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
 
 using classification::ClassifierTrainer;
+using classification::ExampleStore;
 using classification::LinearKernel;
 using classification::ProbabilisticSupportVectorMachine;
 using classification::SupportVectorMachine;
@@ -24,11 +26,13 @@ using cv::Size;
 using detection::AggregatedFeaturesDetector;
 using detection::NonMaximumSuppression;
 using imageio::AnnotatedImage;
+using imageio::AnnotatedImageSource;
 using imageio::Annotation;
 using imageio::Annotations;
-using imageprocessing::Patch;
+using imageprocessing::PatchView;
 using imageprocessing::extraction::AggregatedFeaturesExtractor;
 using std::make_shared;
+using std::function;
 using std::make_unique;
 using std::runtime_error;
 using std::shared_ptr;
@@ -51,7 +55,14 @@ shared_ptr<AggregatedFeaturesDetector> DetectorTrainer::getDetector(shared_ptr<N
 	return detector;
 }
 
-void DetectorTrainer::storeClassifier(const string& filename) const {
+void DetectorTrainer::storeClassifier(const string& filename, bool binary) const {
+	if (binary) {
+		if (probabilisticSvm)
+			probabilisticSvm->storeBinary(filename);
+		else
+			svm->storeBinary(filename);
+		return;
+	}
 	std::ofstream stream(filename);
 	if (probabilisticSvm)
 		probabilisticSvm->store(stream);
@@ -81,16 +92,31 @@ void DetectorTrainer::setProbabilisticSvmTrainer(shared_ptr<ClassifierTrainer<Pr
 	svmTrainer.reset();
 }
 
-void DetectorTrainer::train(vector<AnnotatedImage> images) {
+void DetectorTrainer::train(const vector<AnnotatedImage>& images) {
+	train([&images](const function<void(const AnnotatedImage&)>& process) {
+		for (const AnnotatedImage& image : images)
+			process(image);
+	});
+}
+
+void DetectorTrainer::train(AnnotatedImageSource& images) {
+	train([&images](const function<void(const AnnotatedImage&)>& process) {
+		images.reset();
+		while (images.next())
+			process(images.getAnnotatedImage());
+	});
+}
+
+void DetectorTrainer::train(const ImageIteration& forEachImage) {
 	if (!featureExtractor)
 		throw runtime_error("DetectorTrainer: must set feature extractor first");
 	if (!svmTrainer && !probabilisticSvmTrainer)
 		throw runtime_error("DetectorTrainer: must set SVM trainer first");
 	createEmptyClassifier();
-	collectInitialTrainingExamples(images);
+	collectInitialTrainingExamples(forEachImage);
 	trainClassifier();
 	for (int round = 0; round < bootstrappingRounds; ++round) {
-		collectHardTrainingExamples(images);
+		collectHardTrainingExamples(forEachImage);
 		retrainClassifier();
 	}
 }
@@ -104,19 +130,23 @@ void DetectorTrainer::createEmptyClassifier() {
 		negatives = make_unique<HardNegativeExampleManagement>(svm, maxNegatives);
 	else
 		negatives = make_unique<UnlimitedExampleManagement>();
+	if (compactExampleStorage) {
+		positives->setStore(make_shared<ExampleStore>(ExampleStore::Precision::FLOAT32));
+		negatives->setStore(make_shared<ExampleStore>(negativePrecision));
+	}
 }
 
-void DetectorTrainer::collectInitialTrainingExamples(vector<AnnotatedImage> images) {
+void DetectorTrainer::collectInitialTrainingExamples(const ImageIteration& forEachImage) {
 	if (printProgressInformation)
 		std::cout << printPrefix << "collecting initial training examples" << std::endl;
-	collectTrainingExamples(images, true);
+	collectTrainingExamples(forEachImage, true);
 }
 
-void DetectorTrainer::collectHardTrainingExamples(vector<AnnotatedImage> images) {
+void DetectorTrainer::collectHardTrainingExamples(const ImageIteration& forEachImage) {
 	if (printProgressInformation)
 		std::cout << printPrefix << "collecting additional hard negative training examples" << std::endl;
 	createHardNegativesDetector();
-	collectTrainingExamples(images, false);
+	collectTrainingExamples(forEachImage, false);
 }
 
 void DetectorTrainer::createHardNegativesDetector() {
@@ -125,13 +155,31 @@ void DetectorTrainer::createHardNegativesDetector() {
 	svm->setThreshold(0);
 }
 
-void DetectorTrainer::collectTrainingExamples(vector<AnnotatedImage> images, bool initial) {
-	for (AnnotatedImage annotatedImage : images) {
+void DetectorTrainer::collectTrainingExamples(const ImageIteration& forEachImage, bool initial) {
+	INSTRUMENT_SCOPE("trainer.collect");
+	collectedPositiveCount = 0;
+	collectedNegativeCount = 0;
+	forEachImage([this, initial](const AnnotatedImage& annotatedImage) {
 		Annotations annotations = adjustSizes(annotatedImage.annotations);
 		addTrainingExamples(annotatedImage.image, annotations, initial);
 		if (mirrorTrainingData)
 			addMirroredTrainingExamples(annotatedImage.image, annotations, initial);
-	}
+		// the examples are not buffered for the whole round, so the memory is bounded by the example management
+		if (newPositives.size() + newNegatives.size() >= exampleBatchSize)
+			addCollectedExamples();
+	});
+	addCollectedExamples();
+	image = Mat(); // do not keep the last image until the next round
+}
+
+void DetectorTrainer::addCollectedExamples() {
+	// the classifier does not change while collecting, so adding in batches keeps the same hardest negatives
+	collectedPositiveCount += newPositives.size();
+	collectedNegativeCount += newNegatives.size();
+	positives->add(newPositives);
+	negatives->add(newNegatives);
+	newPositives.clear();
+	newNegatives.clear();
 }
 
 Annotations DetectorTrainer::adjustSizes(const Annotations& annotations) const {
@@ -200,9 +248,9 @@ void DetectorTrainer::setImage(const Mat& image) {
 
 void DetectorTrainer::addPositiveExamples(const vector<Rect>& positiveBoxes) {
 	for (const Rect& bounds : positiveBoxes) {
-		shared_ptr<Patch> patch = featureExtractor->extract(bounds);
-		if (patch)
-			newPositives.push_back(patch->getData());
+		PatchView patch;
+		if (featureExtractor->extractView(bounds, patch))
+			newPositives.push_back(patch.getData().clone());
 	}
 }
 
@@ -237,10 +285,10 @@ void DetectorTrainer::addHardNegativeExamples(const vector<Rect>& nonNegativeBox
 }
 
 bool DetectorTrainer::addNegativeIfNotOverlapping(Rect candidate, const vector<Rect>& nonNegativeBoxes) {
-	shared_ptr<Patch> patch = featureExtractor->extract(candidate);
-	if (!patch || isOverlapping(patch->getBounds(), nonNegativeBoxes))
+	PatchView patch;
+	if (!featureExtractor->extractView(candidate, patch) || isOverlapping(patch.getBounds(), nonNegativeBoxes))
 		return false;
-	newNegatives.push_back(patch->getData());
+	newNegatives.push_back(patch.getData().clone()); // only copied when kept
 	return true;
 }
 
@@ -261,25 +309,29 @@ double DetectorTrainer::computeOverlap(Rect a, Rect b) const {
 
 void DetectorTrainer::trainClassifier() {
 	if (printProgressInformation)
-		std::cout << printPrefix << "training SVM (with " << newPositives.size() << " positives and " << newNegatives.size() << " negatives)" << std::endl;
+		std::cout << printPrefix << "training SVM (with " << collectedPositiveCount << " positives and " << collectedNegativeCount << " negatives)" << std::endl;
 	trainSvm();
 }
 
 void DetectorTrainer::retrainClassifier() {
 	if (printProgressInformation)
-		std::cout << printPrefix << "re-training SVM (found " << newNegatives.size() << " potential new negatives)" << std::endl;
+		std::cout << printPrefix << "re-training SVM (found " << collectedNegativeCount << " potential new negatives)" << std::endl;
 	trainSvm();
 }
 
 void DetectorTrainer::trainSvm() {
-	positives->add(newPositives);
-	negatives->add(newNegatives);
-	if (probabilisticSvmTrainer)
-		probabilisticSvmTrainer->train(*probabilisticSvm, positives->examples, negatives->examples);
-	else
-		svmTrainer->train(*svm, positives->examples, negatives->examples);
-	newPositives.clear();
-	newNegatives.clear();
+	INSTRUMENT_SCOPE("trainer.svm");
+	if (compactExampleStorage) {
+		if (probabilisticSvmTrainer)
+			probabilisticSvmTrainer->train(*probabilisticSvm, *positives->getStore(), *negatives->getStore());
+		else
+			svmTrainer->train(*svm, *positives->getStore(), *negatives->getStore());
+	} else {
+		if (probabilisticSvmTrainer)
+			probabilisticSvmTrainer->train(*probabilisticSvm, positives->examples, negatives->examples);
+		else
+			svmTrainer->train(*svm, positives->examples, negatives->examples);
+	}
 }
 
 } /* namespace detection */
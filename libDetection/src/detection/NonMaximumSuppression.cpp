@@ -6,6 +6,7 @@
  */
 
 #include "detection/NonMaximumSuppression.hpp"
+#include "imageprocessing/Instrumentation.hpp"
 #include <stdexcept>
 
 using cv::Rect;
@@ -25,6 +26,7 @@ NonMaximumSuppression::MaximumType NonMaximumSuppression::getMaximumType() const
 }
 
 vector<Detection> NonMaximumSuppression::eliminateRedundantDetections(vector<Detection> candidates) const {
+	INSTRUMENT_SCOPE("detector.nms");
 	if (overlapThreshold == 1.0) // with this threshold, there would be an endless loop - this check assumes distinct bounding boxes
 		return candidates;
 	sortByScore(candidates);
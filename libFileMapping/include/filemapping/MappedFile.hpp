@@ -0,0 +1,62 @@
+/*
+ * MappedFile.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef FILEMAPPING_MAPPEDFILE_HPP_
+#define FILEMAPPING_MAPPEDFILE_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace filemapping {
+
+/**
+ * Read-only file that is mapped into memory.
+ *
+ * The pages are shared with all other processes that map the same file and are loaded lazily by the operating
+ * system. On platforms without POSIX memory mapping, the file is read into memory instead.
+ */
+class MappedFile {
+public:
+
+	/**
+	 * Maps a file into memory.
+	 *
+	 * @param[in] filename Name of the file.
+	 */
+	explicit MappedFile(const std::string& filename);
+
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * @return Pointer to the first byte of the file, aligned to the page size.
+	 */
+	const unsigned char* data() const {
+		return begin;
+	}
+
+	/**
+	 * @return Size of the file in bytes.
+	 */
+	size_t size() const {
+		return length;
+	}
+
+private:
+
+	const unsigned char* begin; ///< Pointer to the first byte of the file.
+	size_t length; ///< Size of the file in bytes.
+	std::vector<unsigned char> buffer; ///< Content of the file if it could not be mapped.
+};
+
+} /* namespace filemapping */
+
+#endif /* FILEMAPPING_MAPPEDFILE_HPP_ */
@@ -0,0 +1,69 @@
+/*
+ * MappedFile.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "filemapping/MappedFile.hpp"
+#include <fstream>
+#include <stdexcept>
+#ifndef WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+using std::runtime_error;
+using std::string;
+
+namespace filemapping {
+
+#ifndef WIN32
+
+MappedFile::MappedFile(const string& filename) : begin(nullptr), length(0), buffer() {
+	int descriptor = open(filename.c_str(), O_RDONLY);
+	if (descriptor < 0)
+		throw runtime_error("MappedFile: cannot open file '" + filename + "'");
+	struct stat status;
+	if (fstat(descriptor, &status) != 0) {
+		close(descriptor);
+		throw runtime_error("MappedFile: cannot determine the size of file '" + filename + "'");
+	}
+	length = static_cast<size_t>(status.st_size);
+	if (length > 0) {
+		void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, 0);
+		if (address == MAP_FAILED) {
+			close(descriptor);
+			throw runtime_error("MappedFile: cannot map file '" + filename + "'");
+		}
+		begin = static_cast<const unsigned char*>(address);
+	}
+	close(descriptor); // the mapping stays valid
+}
+
+MappedFile::~MappedFile() {
+	if (begin != nullptr)
+		munmap(const_cast<unsigned char*>(begin), length);
+}
+
+#else
+
+MappedFile::MappedFile(const string& filename) : begin(nullptr), length(0), buffer() {
+	std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+	if (!stream)
+		throw runtime_error("MappedFile: cannot open file '" + filename + "'");
+	length = static_cast<size_t>(stream.tellg());
+	buffer.resize(length);
+	stream.seekg(0);
+	if (!stream.read(reinterpret_cast<char*>(buffer.data()), length))
+		throw runtime_error("MappedFile: cannot read file '" + filename + "'");
+	begin = buffer.data();
+}
+
+MappedFile::~MappedFile() {}
+
+#endif
+
+} /* namespace filemapping */
@@ -0,0 +1,90 @@
+/*
+ * AnnotationIndex.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef ANNOTATIONINDEX_HPP_
+#define ANNOTATIONINDEX_HPP_
+
+#include "filemapping/MappedFile.hpp"
+#include "imageio/AnnotatedImageSource.hpp"
+#include "imageio/Annotations.hpp"
+#include <string>
+
+namespace imageio {
+
+/**
+ * Compact binary index of annotated image files that is memory-mapped, so opening it does not parse anything and
+ * the file name and annotations of each image can be accessed in constant time (e.g. for shuffling and sharding).
+ *
+ * The index is created once from another annotated image source (e.g. a dlib XML file), see write. It consists of
+ * a header, a fixed-size record per image, the bounding boxes of all images and the file names. The file names are
+ * stored as absolute paths, so the images are found independently of the location of the index.
+ */
+class AnnotationIndex {
+public:
+
+	/**
+	 * Opens an annotation index.
+	 *
+	 * @param[in] filename Name of the index file.
+	 */
+	explicit AnnotationIndex(const std::string& filename);
+
+	AnnotationIndex(const AnnotationIndex&) = delete;
+
+	AnnotationIndex& operator=(const AnnotationIndex&) = delete;
+
+	/**
+	 * Determines whether a file is an annotation index by looking at its first bytes.
+	 *
+	 * @param[in] filename Name of the file.
+	 * @return True if the file exists and is an annotation index, false otherwise.
+	 */
+	static bool isIndex(const std::string& filename);
+
+	/**
+	 * Creates an annotation index from the images of a source. The images themselves are not loaded, but the
+	 * source must provide their file names.
+	 *
+	 * @param[in] source Source of the annotated images, is reset before reading.
+	 * @param[in] filename Name of the index file that should be written.
+	 * @return Number of indexed images.
+	 */
+	static size_t write(AnnotatedImageSource& source, const std::string& filename);
+
+	/**
+	 * @return Number of images.
+	 */
+	size_t size() const {
+		return imageCount;
+	}
+
+	/**
+	 * @param[in] index Index of the image.
+	 * @return Absolute file name of the image.
+	 */
+	std::string getFile(size_t index) const;
+
+	/**
+	 * @param[in] index Index of the image.
+	 * @return Annotations of the image.
+	 */
+	Annotations getAnnotations(size_t index) const;
+
+private:
+
+	filemapping::MappedFile file; ///< Mapped index file.
+	size_t imageCount; ///< Number of images.
+	size_t boxCount; ///< Number of bounding boxes of all images.
+	size_t nameSize; ///< Size of the file names of all images in bytes.
+	const char* images; ///< Pointer to the first image record.
+	const char* boxes; ///< Pointer to the first bounding box record.
+	const char* names; ///< Pointer to the first character of the file names.
+};
+
+} /* namespace imageio */
+
+#endif /* ANNOTATIONINDEX_HPP_ */
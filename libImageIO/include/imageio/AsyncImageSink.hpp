@@ -0,0 +1,111 @@
+/*
+ * AsyncImageSink.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef ASYNCIMAGESINK_HPP_
+#define ASYNCIMAGESINK_HPP_
+
+#include "imageio/DirectoryImageSink.hpp"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace imageio {
+
+/**
+ * Image sink that passes the images to another sink using background threads, so adding an image does not wait
+ * for its encoding.
+ *
+ * The images are copied into a bounded queue. If the underlying sink is a directory image sink, then several
+ * threads encode the images concurrently, each one into the file of its sequence number. Otherwise a single thread
+ * passes the images to the underlying sink in order (e.g. to a video). If the queue is full, the overflow policy
+ * determines whether adding waits (backpressure) or drops an image. The sequence numbers of dropped images are not
+ * re-used, so the file numbers always correspond to the order in which the images were added.
+ *
+ * Errors of the underlying sink are reported by the next call of add or flush. The underlying sink must not be used
+ * by anyone else while it is wrapped by this sink.
+ */
+class AsyncImageSink : public ImageSink {
+public:
+
+	/**
+	 * Behavior when adding an image while the queue is full.
+	 */
+	enum class OverflowPolicy {
+		BLOCK, ///< Waits until there is space in the queue.
+		DROP_NEWEST, ///< Drops the added image.
+		DROP_OLDEST ///< Drops the oldest image of the queue that is not being written yet.
+	};
+
+	/**
+	 * Constructs a new asynchronous image sink.
+	 *
+	 * @param[in] sink Sink that writes the images.
+	 * @param[in] capacity Maximum number of images that wait for being written.
+	 * @param[in] threadCount Number of threads that write the images (only used with directory image sinks).
+	 * @param[in] policy Behavior when adding an image while the queue is full.
+	 */
+	explicit AsyncImageSink(std::shared_ptr<ImageSink> sink, int capacity = 8, int threadCount = 2,
+			OverflowPolicy policy = OverflowPolicy::DROP_OLDEST);
+
+	/**
+	 * Writes the remaining images and stops the threads. Errors that occur while doing so are not reported.
+	 */
+	~AsyncImageSink();
+
+	void add(const cv::Mat& image);
+
+	/**
+	 * Waits until all images that were added are written.
+	 */
+	void flush();
+
+	/**
+	 * @return Number of images that were dropped because the queue was full.
+	 */
+	size_t getDroppedCount() const;
+
+private:
+
+	/**
+	 * Image that waits for being written.
+	 */
+	struct Frame {
+		cv::Mat image; ///< Copy of the image.
+		unsigned int index; ///< Sequence number of the image.
+	};
+
+	/**
+	 * Writes images until this sink is stopped and the queue is empty.
+	 */
+	void write();
+
+	/**
+	 * Throws the error that occurred while writing an image, if any. Must be called while holding the lock.
+	 */
+	void rethrowError();
+
+	std::shared_ptr<ImageSink> sink; ///< Sink that writes the images.
+	std::shared_ptr<DirectoryImageSink> directorySink; ///< Sink that writes the images into numbered files, null if the images must be written in order.
+	size_t capacity; ///< Maximum number of images that wait for being written.
+	OverflowPolicy policy; ///< Behavior when adding an image while the queue is full.
+	std::deque<Frame> queue; ///< Images that wait for being written, in order of their sequence numbers.
+	unsigned int nextIndex; ///< Sequence number of the next added image.
+	size_t writingCount; ///< Number of images that are being written.
+	size_t droppedCount; ///< Number of dropped images.
+	bool stopping; ///< Flag that indicates whether the threads should stop once the queue is empty.
+	std::exception_ptr error; ///< First error that occurred while writing an image and was not reported yet.
+	std::vector<std::thread> threads; ///< Threads that write the images.
+	mutable std::mutex access; ///< Mutex that guards the queue, the counters, the flags, and the error.
+	std::condition_variable changed; ///< Signals changes of the queue and counters.
+};
+
+} /* namespace imageio */
+#endif /* ASYNCIMAGESINK_HPP_ */
@@ -28,6 +28,15 @@ public:
 
 	void add(const cv::Mat& image);
 
+	/**
+	 * Writes an image into the file of the given sequence number. Does not change the number of the next image
+	 * that is added and may be called by several threads concurrently.
+	 *
+	 * @param[in] image The image.
+	 * @param[in] index The sequence number of the image.
+	 */
+	void write(const cv::Mat& image, unsigned int index) const;
+
 private:
 
 	std::string directory; ///< The name of the directory.
@@ -45,9 +45,13 @@ public:
 
 	string getName() const;
 
+	string getFile() const;
+
 private:
 	vector<path> files; ///< The files of the given directory, ordered by name.
 	int index; ///< The index of the next file.
+	mutable Mat image; ///< The most recently loaded image.
+	mutable int imageIndex; ///< The index of the most recently loaded image, -1 if there is none.
 };
 
 } /* namespace imageio */
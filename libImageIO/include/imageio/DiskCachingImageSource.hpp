@@ -0,0 +1,96 @@
+/*
+ * DiskCachingImageSource.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef DISKCACHINGIMAGESOURCE_HPP_
+#define DISKCACHINGIMAGESOURCE_HPP_
+
+#include "imageio/AnnotatedImageSource.hpp"
+#include <memory>
+
+namespace imageio {
+
+/**
+ * Annotated image source that keeps the decoded images of another source in a directory, so they do not have to be
+ * decoded again when the source is read repeatedly (e.g. once per bootstrapping round of a training).
+ *
+ * The images are stored uncompressed and are identified by their position and name within the underlying source.
+ * The underlying source should load its images lazily (when calling getImage instead of next), otherwise the
+ * cache does not save anything. In that case, the images can be loaded without this source by other threads, too
+ * (see getImageLoader), which read the cache or load the image from the underlying source and write it into the
+ * cache. The cache directory may be re-used between runs as long as the underlying source does not change. Cached
+ * images of another type than expected or with an inconsistent size are considered stale and are re-created.
+ */
+class DiskCachingImageSource : public AnnotatedImageSource {
+public:
+
+	/**
+	 * Constructs a new disk caching image source. If the given source is an annotated image source, then its
+	 * annotations are passed through.
+	 *
+	 * @param[in] source Source of the (annotated) images.
+	 * @param[in] directory Directory that contains the cached images (created if it does not exist).
+	 * @param[in] type Type of the images of the source (color images by default), images of another type are not cached.
+	 */
+	DiskCachingImageSource(std::shared_ptr<ImageSource> source, const std::string& directory, int type = CV_8UC3);
+
+	void reset();
+
+	bool next();
+
+	const cv::Mat getImage() const;
+
+	std::string getName() const;
+
+	std::function<cv::Mat()> getImageLoader() const;
+
+	Annotations getAnnotations() const;
+
+private:
+
+	/**
+	 * Reads a cached image or loads the image and writes it into the cache.
+	 *
+	 * @param[in] cacheFile Name of the file that contains the cached image.
+	 * @param[in] type Expected type of the image.
+	 * @param[in] load Function that loads the image if it is not cached.
+	 * @return Image, empty if it could not be loaded.
+	 */
+	static cv::Mat loadImage(const std::string& cacheFile, int type, const std::function<cv::Mat()>& load);
+
+	/**
+	 * @return Name of the file that contains the current image.
+	 */
+	std::string getCacheFile() const;
+
+	/**
+	 * Reads a cached image.
+	 *
+	 * @param[in] filename Name of the file that contains the image.
+	 * @param[in] type Expected type of the image.
+	 * @return Image, empty if the file does not exist, is incomplete or does not contain an image of the expected type.
+	 */
+	static cv::Mat readImage(const std::string& filename, int type);
+
+	/**
+	 * Writes an image into the cache. The file is written under a temporary name first and renamed afterwards,
+	 * so an interrupted write does not leave a corrupted cache entry.
+	 *
+	 * @param[in] filename Name of the file to write the image into.
+	 * @param[in] image Image.
+	 */
+	static void writeImage(const std::string& filename, const cv::Mat& image);
+
+	std::shared_ptr<ImageSource> source; ///< Source of the images.
+	std::shared_ptr<AnnotatedImageSource> annotatedSource; ///< Source of the annotated images, null if there are no annotations.
+	std::string directory; ///< Directory that contains the cached images.
+	int type; ///< Type of the images.
+	int index; ///< Index of the current image, -1 before the first image.
+	mutable cv::Mat image; ///< Current image, empty until it is requested.
+};
+
+} /* namespace imageio */
+#endif /* DISKCACHINGIMAGESOURCE_HPP_ */
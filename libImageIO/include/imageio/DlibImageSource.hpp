@@ -36,6 +36,8 @@ public:
 
 	std::string getName() const;
 
+	std::string getFile() const;
+
 	Annotations getAnnotations() const;
 
 private:
@@ -46,7 +48,7 @@ private:
 	boost::property_tree::ptree::const_assoc_iterator imagesEnd; ///< Iterator pointing behind the last image entry.
 	boost::property_tree::ptree::const_assoc_iterator imagesNext; ///< Iterator pointing to the next image entry.
 	boost::filesystem::path filename; ///< Current image filename.
-	cv::Mat image; ///< Current image.
+	mutable cv::Mat image; ///< Current image, empty until it is loaded on the first request.
 	Annotations annotations; ///< Current annotations.
 };
 
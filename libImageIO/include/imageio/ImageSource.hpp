@@ -9,6 +9,7 @@
 #define IMAGESOURCE_HPP_
 
 #include "opencv2/core/core.hpp"
+#include <functional>
 #include <string>
 
 namespace imageio {
@@ -46,6 +47,27 @@ public:
 	 * @return The name of the current image (that may be empty if no data could be retrieved).
 	 */
 	virtual std::string getName() const = 0;
+
+	/**
+	 * Retrieves the file the current image is loaded from, so it can be loaded without this source (e.g. by another
+	 * thread) and without loading it here. Sources that load the images in getImage should override this function.
+	 *
+	 * @return The path of the current image file (that is empty if the image is not loaded lazily from a file).
+	 */
+	virtual std::string getFile() const {
+		return "";
+	}
+
+	/**
+	 * Retrieves a function that loads the current image without this source, so it can be called by another thread
+	 * after this source proceeded to other images. Sources that load the images in getImage other than by decoding
+	 * the file given by getFile (e.g. from a cache) should override this function.
+	 *
+	 * @return Function that loads the current image (that is empty if the image is loaded from its file or by getImage).
+	 */
+	virtual std::function<cv::Mat()> getImageLoader() const {
+		return std::function<cv::Mat()>();
+	}
 };
 
 } /* namespace imageio */
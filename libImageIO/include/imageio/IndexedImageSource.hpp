@@ -0,0 +1,88 @@
+/*
+ * IndexedImageSource.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef INDEXEDIMAGESOURCE_HPP_
+#define INDEXEDIMAGESOURCE_HPP_
+
+#include "imageio/AnnotatedImageSource.hpp"
+#include "imageio/AnnotationIndex.hpp"
+#include <memory>
+#include <vector>
+
+namespace imageio {
+
+/**
+ * Annotated image source that reads the file names and annotations from an annotation index. The images are
+ * provided in an arbitrary order, which allows to shuffle them or to split them into shards (e.g. one per thread
+ * or process) without reading the annotations of other images.
+ */
+class IndexedImageSource : public AnnotatedImageSource {
+public:
+
+	/**
+	 * Constructs a new indexed image source that provides all images in the order of the index.
+	 *
+	 * @param[in] filename Name of the index file.
+	 */
+	explicit IndexedImageSource(const std::string& filename);
+
+	/**
+	 * Constructs a new indexed image source that provides the given images.
+	 *
+	 * @param[in] index Annotation index.
+	 * @param[in] order Indices of the images in the order they should be provided.
+	 */
+	IndexedImageSource(std::shared_ptr<const AnnotationIndex> index, std::vector<size_t> order);
+
+	/**
+	 * Randomly changes the order of the images and resets this source.
+	 *
+	 * @param[in] seed Seed of the random number generator, so the order can be reproduced.
+	 */
+	void shuffle(unsigned int seed);
+
+	/**
+	 * Creates a source that provides every shardCount-th image of this source, beginning at the image with the
+	 * given index. The shards of all indices together provide each image exactly once.
+	 *
+	 * @param[in] shardIndex Index of the shard, must be smaller than the number of shards.
+	 * @param[in] shardCount Number of shards.
+	 * @return Source that provides the images of the shard in the order of this source.
+	 */
+	std::shared_ptr<IndexedImageSource> getShard(size_t shardIndex, size_t shardCount) const;
+
+	/**
+	 * @return Number of images that are provided by this source.
+	 */
+	size_t size() const {
+		return order.size();
+	}
+
+	void reset();
+
+	bool next();
+
+	const cv::Mat getImage() const;
+
+	std::string getName() const;
+
+	std::string getFile() const;
+
+	Annotations getAnnotations() const;
+
+private:
+
+	std::shared_ptr<const AnnotationIndex> index; ///< Annotation index.
+	std::vector<size_t> order; ///< Indices of the images in the order they are provided.
+	size_t position; ///< Position of the next image within the order.
+	std::string filename; ///< Current image filename, empty before the first image.
+	mutable cv::Mat image; ///< Current image, empty until it is loaded on the first request.
+};
+
+} /* namespace imageio */
+
+#endif /* INDEXEDIMAGESOURCE_HPP_ */
@@ -35,6 +35,10 @@ public:
 
 	std::string getName() const;
 
+	std::string getFile() const;
+
+	std::function<cv::Mat()> getImageLoader() const;
+
 	Annotations getAnnotations() const;
 
 private:
@@ -0,0 +1,112 @@
+/*
+ * PrefetchingImageSource.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef PREFETCHINGIMAGESOURCE_HPP_
+#define PREFETCHINGIMAGESOURCE_HPP_
+
+#include "imageio/AnnotatedImageSource.hpp"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace imageio {
+
+/**
+ * Annotated image source that reads ahead the images of another source using background threads.
+ *
+ * The threads proceed through the underlying source one after another and keep up to a fixed number of images in a
+ * bounded buffer. If the underlying source provides functions that load the images (see ImageSource::getImageLoader)
+ * or the image files (see ImageSource::getFile), the images are loaded by several threads concurrently, otherwise
+ * they are retrieved from the source by the threads in turn.
+ * The images are decoded only once, getImage returns the buffered image. Errors of the underlying source are
+ * reported by next when proceeding to the image that caused them.
+ *
+ * The underlying source must not be used by anyone else while it is wrapped by this source.
+ */
+class PrefetchingImageSource : public AnnotatedImageSource {
+public:
+
+	/**
+	 * Constructs a new prefetching image source. If the given source is an annotated image source, then the
+	 * annotations are read ahead, too.
+	 *
+	 * @param[in] source Source of the (annotated) images.
+	 * @param[in] capacity Maximum number of images to read ahead.
+	 * @param[in] threadCount Number of threads that read the images.
+	 */
+	explicit PrefetchingImageSource(std::shared_ptr<ImageSource> source, int capacity = 8, int threadCount = 2);
+
+	~PrefetchingImageSource();
+
+	void reset();
+
+	bool next();
+
+	const cv::Mat getImage() const;
+
+	std::string getName() const;
+
+	Annotations getAnnotations() const;
+
+private:
+
+	/**
+	 * Image that was read ahead.
+	 */
+	struct Frame {
+		cv::Mat image; ///< Image.
+		std::string name; ///< Name of the image.
+		std::string file; ///< File of the image, empty if the image was not loaded from a file.
+		std::function<cv::Mat()> loader; ///< Function that loads the image, empty if the image was not loaded by a function.
+		Annotations annotations; ///< Annotations of the image.
+		std::exception_ptr error; ///< Error that occurred while reading the image, null if there was none.
+		bool ready; ///< Flag that indicates whether the image is completely read.
+	};
+
+	/**
+	 * Starts the threads that read the images.
+	 */
+	void start();
+
+	/**
+	 * Stops the threads that read the images and discards the images that were read ahead.
+	 */
+	void stop();
+
+	/**
+	 * Reads images until the source is exhausted or this source is stopped.
+	 */
+	void read();
+
+	/**
+	 * Proceeds to the next image of the underlying source and appends it to the buffer. Must be called while
+	 * holding the lock.
+	 *
+	 * @return Appended frame whose image must still be loaded by its loader or from its file, null if there is none.
+	 */
+	std::shared_ptr<Frame> fetch();
+
+	std::shared_ptr<ImageSource> source; ///< Source of the images.
+	std::shared_ptr<AnnotatedImageSource> annotatedSource; ///< Source of the annotated images, null if there are no annotations.
+	size_t capacity; ///< Maximum number of images to read ahead.
+	int threadCount; ///< Number of threads that read the images.
+	std::deque<std::shared_ptr<Frame>> buffer; ///< Images that were read ahead, in order of the source.
+	std::shared_ptr<Frame> current; ///< Current image, null if there is none.
+	bool exhausted; ///< Flag that indicates whether the underlying source has no more images.
+	bool stopping; ///< Flag that indicates whether the threads should stop.
+	std::vector<std::thread> threads; ///< Threads that read the images.
+	std::mutex access; ///< Mutex that guards the buffer, the underlying source, and the flags.
+	std::condition_variable changed; ///< Signals changes of the buffer and flags.
+};
+
+} /* namespace imageio */
+#endif /* PREFETCHINGIMAGESOURCE_HPP_ */
@@ -0,0 +1,116 @@
+/*
+ * ThreadedCameraImageSource.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef THREADEDCAMERAIMAGESOURCE_HPP_
+#define THREADEDCAMERAIMAGESOURCE_HPP_
+
+#include "imageio/ImageSource.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace imageio {
+
+/**
+ * Image source that takes images from a camera device using a dedicated capture thread, so the camera is read
+ * while the previous image is being processed and next always provides the latest image.
+ *
+ * The images are captured into a fixed pool of buffers that are re-used without allocating memory. A buffer is
+ * only overwritten when no image (cv::Mat) refers to it anymore, so the images may be kept as long as necessary.
+ * Images that are replaced by a newer one before being taken by next are dropped and counted. Optionally, the
+ * capture thread converts the images to grayscale, too.
+ */
+class ThreadedCameraImageSource : public ImageSource {
+public:
+
+	/**
+	 * Constructs a new threaded camera image source.
+	 *
+	 * @param[in] device ID of the video capturing device.
+	 * @param[in] bufferCount Number of image buffers (at least three, so an image can be captured while the latest
+	 *                        and the current image are kept).
+	 * @param[in] grayscale Flag that indicates whether the capture thread should convert the images to grayscale.
+	 */
+	explicit ThreadedCameraImageSource(int device, int bufferCount = 4, bool grayscale = false);
+
+	~ThreadedCameraImageSource();
+
+	void reset();
+
+	bool next();
+
+	const cv::Mat getImage() const;
+
+	/**
+	 * @return Grayscale version of the current image, empty if the images are not converted.
+	 */
+	const cv::Mat getGrayscaleImage() const;
+
+	std::string getName() const;
+
+	/**
+	 * @return Number of images that were dropped, because they were replaced by a newer one or there was no free buffer.
+	 */
+	size_t getDroppedCount() const;
+
+private:
+
+	/**
+	 * Buffer that a captured image is written into.
+	 */
+	struct Buffer {
+		cv::Mat image; ///< Captured image.
+		cv::Mat grayscaleImage; ///< Grayscale version of the captured image, empty if the images are not converted.
+	};
+
+	/**
+	 * Starts the capture thread.
+	 */
+	void start();
+
+	/**
+	 * Stops the capture thread.
+	 */
+	void stop();
+
+	/**
+	 * Captures images until the camera fails or this source is stopped.
+	 */
+	void capture();
+
+	/**
+	 * Determines the index of a buffer that may be overwritten. Must be called while holding the lock.
+	 *
+	 * @return Index of a buffer that is neither the latest nor referenced by any image, -1 if there is none.
+	 */
+	int findFreeBuffer() const;
+
+	/**
+	 * @param[in] image Image.
+	 * @return True if no other image refers to the data of the given image, false otherwise.
+	 */
+	static bool isUnreferenced(const cv::Mat& image);
+
+	int device; ///< ID of the video capturing device.
+	bool grayscale; ///< Flag that indicates whether the capture thread converts the images to grayscale.
+	cv::VideoCapture camera; ///< The video capture, only used by the capture thread after construction.
+	std::vector<Buffer> buffers; ///< Pool of image buffers.
+	int latest; ///< Index of the buffer that contains the latest image that was not taken yet, -1 if there is none.
+	bool ended; ///< Flag that indicates whether the camera did not provide any more images.
+	bool stopping; ///< Flag that indicates whether the capture thread should stop.
+	size_t droppedCount; ///< Number of dropped images.
+	cv::Mat image; ///< The current image.
+	cv::Mat grayscaleImage; ///< Grayscale version of the current image.
+	std::thread thread; ///< Thread that captures the images.
+	mutable std::mutex access; ///< Mutex that guards the buffer references, the flags, and the counter.
+	std::condition_variable changed; ///< Signals new images and changes of the flags.
+};
+
+} /* namespace imageio */
+#endif /* THREADEDCAMERAIMAGESOURCE_HPP_ */
@@ -0,0 +1,170 @@
+/*
+ * AnnotationIndex.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "imageio/AnnotationIndex.hpp"
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/filesystem.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using std::out_of_range;
+using std::runtime_error;
+using std::string;
+using std::vector;
+
+namespace imageio {
+
+namespace {
+
+const char indexMagic[8] = {'A', 'N', 'N', 'O', 'I', 'D', 'X', '1'}; ///< First bytes of index files.
+const uint32_t indexVersion = 1; ///< Current version of the format.
+const uint32_t indexByteOrder = 0x01020304; ///< Marker for detecting files with a different byte order.
+
+/**
+ * Header at the beginning of index files, followed by the image records, box records and file names.
+ */
+struct IndexHeader {
+	char magic[8]; ///< Magic number, see indexMagic.
+	uint32_t version; ///< Version of the format.
+	uint32_t byteOrder; ///< Byte order marker, see indexByteOrder.
+	uint64_t imageCount; ///< Number of image records.
+	uint64_t boxCount; ///< Number of box records.
+	uint64_t nameSize; ///< Size of the file names in bytes.
+};
+
+/**
+ * Location of the file name and bounding boxes of an image.
+ */
+struct ImageRecord {
+	uint64_t nameOffset; ///< Offset of the file name relative to the first file name.
+	uint64_t firstBox; ///< Index of the first bounding box.
+	uint32_t nameLength; ///< Length of the file name.
+	uint32_t boxCount; ///< Number of bounding boxes.
+};
+
+/**
+ * Bounding box of an annotation.
+ */
+struct BoxRecord {
+	int32_t x; ///< X coordinate of the upper left corner.
+	int32_t y; ///< Y coordinate of the upper left corner.
+	int32_t width; ///< Width.
+	int32_t height; ///< Height.
+	uint32_t fuzzy; ///< 1 if the annotation should be ignored (neither positive, nor negative), 0 otherwise.
+};
+
+} // namespace
+
+AnnotationIndex::AnnotationIndex(const string& filename) :
+		file(filename), imageCount(0), boxCount(0), nameSize(0), images(nullptr), boxes(nullptr), names(nullptr) {
+	IndexHeader header;
+	if (file.size() < sizeof(header))
+		throw runtime_error("AnnotationIndex: '" + filename + "' is no annotation index");
+	std::memcpy(&header, file.data(), sizeof(header));
+	if (std::memcmp(header.magic, indexMagic, sizeof(header.magic)) != 0)
+		throw runtime_error("AnnotationIndex: '" + filename + "' is no annotation index");
+	if (header.version != indexVersion)
+		throw runtime_error("AnnotationIndex: unsupported version " + std::to_string(header.version) + " of '" + filename + "'");
+	if (header.byteOrder != indexByteOrder)
+		throw runtime_error("AnnotationIndex: '" + filename + "' was written with a different byte order");
+	uint64_t expectedSize = sizeof(header) + header.imageCount * sizeof(ImageRecord)
+			+ header.boxCount * sizeof(BoxRecord) + header.nameSize;
+	if (expectedSize != file.size())
+		throw runtime_error("AnnotationIndex: '" + filename + "' is truncated or corrupted");
+	imageCount = static_cast<size_t>(header.imageCount);
+	boxCount = static_cast<size_t>(header.boxCount);
+	nameSize = static_cast<size_t>(header.nameSize);
+	images = reinterpret_cast<const char*>(file.data()) + sizeof(header);
+	boxes = images + imageCount * sizeof(ImageRecord);
+	names = boxes + boxCount * sizeof(BoxRecord);
+}
+
+bool AnnotationIndex::isIndex(const string& filename) {
+	std::ifstream stream(filename, std::ios::binary);
+	char magic[sizeof(indexMagic)];
+	return stream.read(magic, sizeof(magic)) && std::memcmp(magic, indexMagic, sizeof(magic)) == 0;
+}
+
+size_t AnnotationIndex::write(AnnotatedImageSource& source, const string& filename) {
+	vector<ImageRecord> imageRecords;
+	vector<BoxRecord> boxRecords;
+	string allNames;
+	source.reset();
+	while (source.next()) {
+		string name = source.getFile();
+		if (name.empty())
+			throw runtime_error("AnnotationIndex: the source does not provide the file of image '" + source.getName() + "'");
+		name = boost::filesystem::absolute(name).string();
+		Annotations annotations = source.getAnnotations();
+		ImageRecord imageRecord;
+		imageRecord.nameOffset = allNames.size();
+		imageRecord.firstBox = boxRecords.size();
+		imageRecord.nameLength = static_cast<uint32_t>(name.size());
+		imageRecord.boxCount = static_cast<uint32_t>(annotations.annotations.size());
+		imageRecords.push_back(imageRecord);
+		for (const Annotation& annotation : annotations.annotations) {
+			const cv::Rect& bounds = annotation.bounds;
+			boxRecords.push_back(BoxRecord{bounds.x, bounds.y, bounds.width, bounds.height, annotation.fuzzy ? 1u : 0u});
+		}
+		allNames += name;
+	}
+	IndexHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, indexMagic, sizeof(header.magic));
+	header.version = indexVersion;
+	header.byteOrder = indexByteOrder;
+	header.imageCount = imageRecords.size();
+	header.boxCount = boxRecords.size();
+	header.nameSize = allNames.size();
+
+	string temporaryFilename = filename + ".tmp";
+	std::ofstream stream(temporaryFilename, std::ios::binary);
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(imageRecords.data()), imageRecords.size() * sizeof(ImageRecord));
+	stream.write(reinterpret_cast<const char*>(boxRecords.data()), boxRecords.size() * sizeof(BoxRecord));
+	stream.write(allNames.data(), allNames.size());
+	stream.close();
+	if (!stream)
+		throw runtime_error("AnnotationIndex: could not write index file '" + temporaryFilename + "'");
+	boost::filesystem::rename(temporaryFilename, filename);
+	return imageRecords.size();
+}
+
+string AnnotationIndex::getFile(size_t index) const {
+	if (index >= imageCount)
+		throw out_of_range("AnnotationIndex: image index " + std::to_string(index) + " is out of range");
+	ImageRecord record;
+	std::memcpy(&record, images + index * sizeof(ImageRecord), sizeof(record));
+	if (record.nameOffset + record.nameLength > nameSize)
+		throw runtime_error("AnnotationIndex: file name of image " + std::to_string(index) + " is out of bounds");
+	return string(names + record.nameOffset, record.nameLength);
+}
+
+Annotations AnnotationIndex::getAnnotations(size_t index) const {
+	if (index >= imageCount)
+		throw out_of_range("AnnotationIndex: image index " + std::to_string(index) + " is out of range");
+	ImageRecord record;
+	std::memcpy(&record, images + index * sizeof(ImageRecord), sizeof(record));
+	if (record.firstBox + record.boxCount > boxCount)
+		throw runtime_error("AnnotationIndex: boxes of image " + std::to_string(index) + " are out of bounds");
+	Annotations annotations;
+	annotations.annotations.reserve(record.boxCount);
+	for (uint32_t i = 0; i < record.boxCount; ++i) {
+		BoxRecord box;
+		std::memcpy(&box, boxes + (record.firstBox + i) * sizeof(BoxRecord), sizeof(box));
+		annotations.annotations.emplace_back(cv::Rect(box.x, box.y, box.width, box.height), box.fuzzy != 0);
+	}
+	return annotations;
+}
+
+} /* namespace imageio */
@@ -0,0 +1,128 @@
+/*
+ * AsyncImageSink.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "imageio/AsyncImageSink.hpp"
+#include <stdexcept>
+#include <utility>
+
+using cv::Mat;
+using std::exception_ptr;
+using std::invalid_argument;
+using std::lock_guard;
+using std::mutex;
+using std::shared_ptr;
+using std::unique_lock;
+
+namespace imageio {
+
+AsyncImageSink::AsyncImageSink(shared_ptr<ImageSink> sink, int capacity, int threadCount, OverflowPolicy policy) :
+		sink(sink),
+		directorySink(std::dynamic_pointer_cast<DirectoryImageSink>(sink)),
+		capacity(capacity),
+		policy(policy),
+		queue(),
+		nextIndex(0),
+		writingCount(0),
+		droppedCount(0),
+		stopping(false),
+		error(),
+		threads(),
+		access(),
+		changed() {
+	if (!sink)
+		throw invalid_argument("AsyncImageSink: the sink must not be null");
+	if (capacity < 1)
+		throw invalid_argument("AsyncImageSink: the capacity must be greater than zero");
+	if (threadCount < 1)
+		throw invalid_argument("AsyncImageSink: the number of threads must be greater than zero");
+	if (!directorySink)
+		threadCount = 1; // other sinks expect the images in order
+	for (int i = 0; i < threadCount; ++i)
+		threads.emplace_back(&AsyncImageSink::write, this);
+}
+
+AsyncImageSink::~AsyncImageSink() {
+	{
+		lock_guard<mutex> lock(access);
+		stopping = true;
+	}
+	changed.notify_all();
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+void AsyncImageSink::add(const Mat& image) {
+	Frame frame{image.clone(), 0}; // copied before locking, so the writing threads are not blocked meanwhile
+	unique_lock<mutex> lock(access);
+	rethrowError();
+	frame.index = nextIndex++;
+	if (queue.size() >= capacity) {
+		if (policy == OverflowPolicy::BLOCK) {
+			changed.wait(lock, [this]() { return queue.size() < capacity || error; });
+			rethrowError();
+		} else if (policy == OverflowPolicy::DROP_NEWEST) {
+			++droppedCount;
+			return;
+		} else {
+			queue.pop_front();
+			++droppedCount;
+		}
+	}
+	queue.push_back(std::move(frame));
+	changed.notify_all();
+}
+
+void AsyncImageSink::flush() {
+	unique_lock<mutex> lock(access);
+	changed.wait(lock, [this]() { return queue.empty() && writingCount == 0; });
+	rethrowError();
+}
+
+size_t AsyncImageSink::getDroppedCount() const {
+	lock_guard<mutex> lock(access);
+	return droppedCount;
+}
+
+void AsyncImageSink::rethrowError() {
+	if (error) {
+		exception_ptr occurredError = error;
+		error = exception_ptr();
+		std::rethrow_exception(occurredError);
+	}
+}
+
+void AsyncImageSink::write() {
+	unique_lock<mutex> lock(access);
+	while (true) {
+		changed.wait(lock, [this]() { return stopping || !queue.empty(); });
+		if (queue.empty())
+			return;
+		Frame frame = std::move(queue.front());
+		queue.pop_front();
+		++writingCount;
+		changed.notify_all();
+		// encode the image without holding the lock, so images can be added and written concurrently
+		lock.unlock();
+		exception_ptr writeError;
+		try {
+			if (directorySink)
+				directorySink->write(frame.image, frame.index);
+			else
+				sink->add(frame.image);
+		} catch (...) {
+			writeError = std::current_exception();
+		}
+		frame.image = Mat();
+		lock.lock();
+		--writingCount;
+		if (writeError && !error)
+			error = writeError;
+		changed.notify_all();
+	}
+}
+
+} /* namespace imageio */
@@ -41,8 +41,12 @@ DirectoryImageSink::DirectoryImageSink(string directory, string ending) :
 }
 
 void DirectoryImageSink::add(const Mat& image) {
+	write(image, index++);
+}
+
+void DirectoryImageSink::write(const Mat& image, unsigned int index) const {
 	ostringstream filename;
-	filename << directory << setfill('0') << setw(5) << index++ << setw(0) << '.' << ending;
+	filename << directory << setfill('0') << setw(5) << index << setw(0) << '.' << ending;
 	if (!imwrite(filename.str(), image))
 		throw std::runtime_error("DirectoryImageSink: Could not write image file '" + filename.str() + "'");
 }
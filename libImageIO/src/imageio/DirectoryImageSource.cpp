@@ -18,7 +18,7 @@ using std::runtime_error;
 
 namespace imageio {
 
-DirectoryImageSource::DirectoryImageSource(const string& directory) : files(), index(-1) {
+DirectoryImageSource::DirectoryImageSource(const string& directory) : files(), index(-1), image(), imageIndex(-1) {
 	path dirpath(directory);
 	if (!exists(dirpath))
 		throw runtime_error("DirectoryImageSource: Directory '" + directory + "' does not exist.");
@@ -51,9 +51,12 @@ bool DirectoryImageSource::next() {
 const Mat DirectoryImageSource::getImage() const {
 	if (index < 0 || index >= static_cast<int>(files.size()))
 		return Mat();
-	Mat image = cv::imread(files[index].string(), CV_LOAD_IMAGE_COLOR);
-	if (image.empty())
-		throw runtime_error("DirectoryImageSource: image '" + files[index].string() + "' could not be loaded");
+	if (imageIndex != index) {
+		image = cv::imread(files[index].string(), CV_LOAD_IMAGE_COLOR);
+		if (image.empty())
+			throw runtime_error("DirectoryImageSource: image '" + files[index].string() + "' could not be loaded");
+		imageIndex = index;
+	}
 	return image;
 }
 
@@ -63,4 +66,10 @@ string DirectoryImageSource::getName() const {
 	return files[index].filename().string();
 }
 
+string DirectoryImageSource::getFile() const {
+	if (index < 0 || index >= static_cast<int>(files.size()))
+		return "";
+	return files[index].string();
+}
+
 } /* namespace imageio */
@@ -0,0 +1,134 @@
+/*
+ * DiskCachingImageSource.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "imageio/DiskCachingImageSource.hpp"
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/filesystem.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+using boost::filesystem::path;
+using cv::Mat;
+using std::function;
+using std::invalid_argument;
+using std::runtime_error;
+using std::shared_ptr;
+using std::string;
+
+namespace imageio {
+
+DiskCachingImageSource::DiskCachingImageSource(shared_ptr<ImageSource> source, const string& directory, int type) :
+		source(source),
+		annotatedSource(std::dynamic_pointer_cast<AnnotatedImageSource>(source)),
+		directory(directory),
+		type(type),
+		index(-1),
+		image() {
+	if (!source)
+		throw invalid_argument("DiskCachingImageSource: the source must not be null");
+	path directoryPath(directory);
+	if (!boost::filesystem::exists(directoryPath))
+		boost::filesystem::create_directories(directoryPath);
+	else if (!boost::filesystem::is_directory(directoryPath))
+		throw runtime_error("DiskCachingImageSource: '" + directory + "' is no directory");
+}
+
+void DiskCachingImageSource::reset() {
+	source->reset();
+	index = -1;
+	image = Mat();
+}
+
+bool DiskCachingImageSource::next() {
+	image = Mat();
+	if (!source->next())
+		return false;
+	++index;
+	return true;
+}
+
+const Mat DiskCachingImageSource::getImage() const {
+	if (image.empty() && index >= 0)
+		image = loadImage(getCacheFile(), type, [this]() { return source->getImage(); });
+	return image;
+}
+
+function<Mat()> DiskCachingImageSource::getImageLoader() const {
+	if (index < 0)
+		return function<Mat()>();
+	function<Mat()> load = source->getImageLoader();
+	if (!load) {
+		string file = source->getFile();
+		if (file.empty()) // the underlying source loads the image by getImage (or has done so already)
+			return function<Mat()>();
+		load = [file]() { return cv::imread(file, CV_LOAD_IMAGE_COLOR); };
+	}
+	string cacheFile = getCacheFile();
+	int type = this->type;
+	return [cacheFile, type, load]() { return loadImage(cacheFile, type, load); };
+}
+
+string DiskCachingImageSource::getName() const {
+	return source->getName();
+}
+
+Annotations DiskCachingImageSource::getAnnotations() const {
+	return annotatedSource ? annotatedSource->getAnnotations() : Annotations();
+}
+
+Mat DiskCachingImageSource::loadImage(const string& cacheFile, int type, const function<Mat()>& load) {
+	Mat image = readImage(cacheFile, type);
+	if (image.empty()) { // not cached or stale
+		image = load();
+		if (!image.empty() && image.type() == type)
+			writeImage(cacheFile, image);
+	}
+	return image;
+}
+
+string DiskCachingImageSource::getCacheFile() const {
+	return (path(directory) / (std::to_string(index) + "_" + path(source->getName()).filename().string() + ".mat")).string();
+}
+
+Mat DiskCachingImageSource::readImage(const string& filename, int type) {
+	std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+	if (!stream)
+		return Mat();
+	uint64_t fileSize = static_cast<uint64_t>(stream.tellg());
+	stream.seekg(0);
+	int32_t header[3]; // rows, cols, type
+	if (!stream.read(reinterpret_cast<char*>(header), sizeof(header))
+			|| header[0] <= 0 || header[1] <= 0 || header[2] != type)
+		return Mat();
+	uint64_t dataSize = static_cast<uint64_t>(header[0]) * static_cast<uint64_t>(header[1]) * CV_ELEM_SIZE(type);
+	if (fileSize != sizeof(header) + dataSize)
+		return Mat();
+	Mat image(header[0], header[1], type);
+	if (!stream.read(reinterpret_cast<char*>(image.data), image.total() * image.elemSize()))
+		return Mat();
+	return image;
+}
+
+void DiskCachingImageSource::writeImage(const string& filename, const Mat& image) {
+	Mat continuousImage = image.isContinuous() ? image : image.clone();
+	string temporaryFilename = filename + ".tmp";
+	std::ofstream stream(temporaryFilename, std::ios::binary);
+	int32_t header[3] = { continuousImage.rows, continuousImage.cols, continuousImage.type() };
+	stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(continuousImage.data), continuousImage.total() * continuousImage.elemSize());
+	stream.close();
+	if (!stream)
+		throw runtime_error("DiskCachingImageSource: could not write image file '" + temporaryFilename + "'");
+	boost::filesystem::rename(temporaryFilename, filename);
+}
+
+} /* namespace imageio */
@@ -36,9 +36,7 @@ bool DlibImageSource::next() {
 	boost::filesystem::path imageFilepath = directory;
 	imageFilepath /= imageFilename;
 	filename = imageFilepath;
-	image = cv::imread(imageFilepath.string(), CV_LOAD_IMAGE_COLOR);
-	if (image.empty())
-		throw std::runtime_error("image '" + imageFilepath.string() + "' could not be loaded");
+	image = cv::Mat(); // loaded lazily, so read-ahead sources can load it on their own threads
 	annotations.annotations.clear();
 	int objectCount = 0;
 	int ignoreCount = 0;
@@ -56,6 +54,11 @@ bool DlibImageSource::next() {
 }
 
 const cv::Mat DlibImageSource::getImage() const {
+	if (image.empty() && !filename.empty()) {
+		image = cv::imread(filename.string(), CV_LOAD_IMAGE_COLOR);
+		if (image.empty())
+			throw std::runtime_error("image '" + filename.string() + "' could not be loaded");
+	}
 	return image;
 }
 
@@ -63,6 +66,10 @@ string DlibImageSource::getName() const {
 	return filename.filename().string();
 }
 
+string DlibImageSource::getFile() const {
+	return filename.string();
+}
+
 Annotations DlibImageSource::getAnnotations() const {
 	return annotations;
 }
@@ -0,0 +1,95 @@
+/*
+ * IndexedImageSource.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "imageio/IndexedImageSource.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "boost/filesystem.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+using std::invalid_argument;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace imageio {
+
+IndexedImageSource::IndexedImageSource(const string& filename) :
+		index(make_shared<AnnotationIndex>(filename)), order(index->size()), position(0), filename(), image() {
+	std::iota(order.begin(), order.end(), 0);
+}
+
+IndexedImageSource::IndexedImageSource(shared_ptr<const AnnotationIndex> index, vector<size_t> order) :
+		index(index), order(order), position(0), filename(), image() {
+	if (!index)
+		throw invalid_argument("IndexedImageSource: the index must not be null");
+	for (size_t i : order) {
+		if (i >= index->size())
+			throw invalid_argument("IndexedImageSource: image index " + std::to_string(i) + " is out of range");
+	}
+}
+
+void IndexedImageSource::shuffle(unsigned int seed) {
+	std::mt19937 generator(seed);
+	std::shuffle(order.begin(), order.end(), generator);
+	reset();
+}
+
+shared_ptr<IndexedImageSource> IndexedImageSource::getShard(size_t shardIndex, size_t shardCount) const {
+	if (shardIndex >= shardCount)
+		throw invalid_argument("IndexedImageSource: the shard index must be smaller than the shard count");
+	vector<size_t> shardOrder;
+	shardOrder.reserve(order.size() / shardCount + 1);
+	for (size_t i = shardIndex; i < order.size(); i += shardCount)
+		shardOrder.push_back(order[i]);
+	return make_shared<IndexedImageSource>(index, shardOrder);
+}
+
+void IndexedImageSource::reset() {
+	position = 0;
+	filename.clear();
+	image = cv::Mat();
+}
+
+bool IndexedImageSource::next() {
+	image = cv::Mat(); // loaded lazily, so read-ahead sources can load it on their own threads
+	if (position >= order.size()) {
+		filename.clear();
+		return false;
+	}
+	filename = index->getFile(order[position]);
+	++position;
+	return true;
+}
+
+const cv::Mat IndexedImageSource::getImage() const {
+	if (image.empty() && !filename.empty()) {
+		image = cv::imread(filename, CV_LOAD_IMAGE_COLOR);
+		if (image.empty())
+			throw std::runtime_error("image '" + filename + "' could not be loaded");
+	}
+	return image;
+}
+
+string IndexedImageSource::getName() const {
+	return boost::filesystem::path(filename).filename().string();
+}
+
+string IndexedImageSource::getFile() const {
+	return filename;
+}
+
+Annotations IndexedImageSource::getAnnotations() const {
+	if (filename.empty())
+		return Annotations();
+	return index->getAnnotations(order[position - 1]);
+}
+
+} /* namespace imageio */
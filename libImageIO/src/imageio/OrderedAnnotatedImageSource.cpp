@@ -8,6 +8,7 @@
 #include "imageio/OrderedAnnotatedImageSource.hpp"
 
 using cv::Mat;
+using std::function;
 using std::shared_ptr;
 using std::string;
 
@@ -35,6 +36,14 @@ string OrderedAnnotatedImageSource::getName() const {
 	return imageSource->getName();
 }
 
+string OrderedAnnotatedImageSource::getFile() const {
+	return imageSource->getFile();
+}
+
+function<Mat()> OrderedAnnotatedImageSource::getImageLoader() const {
+	return imageSource->getImageLoader();
+}
+
 Annotations OrderedAnnotatedImageSource::getAnnotations() const {
 	return annotationSource->getAnnotations();
 }
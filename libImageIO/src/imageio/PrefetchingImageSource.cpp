@@ -0,0 +1,160 @@
+/*
+ * PrefetchingImageSource.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "imageio/PrefetchingImageSource.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include <stdexcept>
+
+using cv::Mat;
+using std::exception_ptr;
+using std::invalid_argument;
+using std::lock_guard;
+using std::make_shared;
+using std::mutex;
+using std::runtime_error;
+using std::shared_ptr;
+using std::string;
+using std::unique_lock;
+
+namespace imageio {
+
+PrefetchingImageSource::PrefetchingImageSource(shared_ptr<ImageSource> source, int capacity, int threadCount) :
+		source(source),
+		annotatedSource(std::dynamic_pointer_cast<AnnotatedImageSource>(source)),
+		capacity(capacity),
+		threadCount(threadCount),
+		buffer(),
+		current(),
+		exhausted(false),
+		stopping(false),
+		threads(),
+		access(),
+		changed() {
+	if (!source)
+		throw invalid_argument("PrefetchingImageSource: the source must not be null");
+	if (capacity < 1)
+		throw invalid_argument("PrefetchingImageSource: the capacity must be greater than zero");
+	if (threadCount < 1)
+		throw invalid_argument("PrefetchingImageSource: the number of threads must be greater than zero");
+	start();
+}
+
+PrefetchingImageSource::~PrefetchingImageSource() {
+	stop();
+}
+
+void PrefetchingImageSource::start() {
+	stopping = false;
+	exhausted = false;
+	for (int i = 0; i < threadCount; ++i)
+		threads.emplace_back(&PrefetchingImageSource::read, this);
+}
+
+void PrefetchingImageSource::stop() {
+	{
+		lock_guard<mutex> lock(access);
+		stopping = true;
+	}
+	changed.notify_all();
+	for (std::thread& thread : threads)
+		thread.join();
+	threads.clear();
+	buffer.clear();
+	current.reset();
+}
+
+void PrefetchingImageSource::reset() {
+	stop();
+	source->reset();
+	start();
+}
+
+void PrefetchingImageSource::read() {
+	unique_lock<mutex> lock(access);
+	while (true) {
+		changed.wait(lock, [this]() { return stopping || (!exhausted && buffer.size() < capacity); });
+		if (stopping)
+			return;
+		shared_ptr<Frame> frame = fetch();
+		changed.notify_all();
+		if (!frame)
+			continue;
+		// load the image without holding the lock, so other threads can proceed with the next images
+		lock.unlock();
+		Mat image;
+		exception_ptr error;
+		try {
+			image = frame->loader ? frame->loader() : cv::imread(frame->file, CV_LOAD_IMAGE_COLOR);
+			if (image.empty())
+				throw runtime_error("PrefetchingImageSource: image '" + (frame->file.empty() ? frame->name : frame->file) + "' could not be loaded");
+		} catch (...) {
+			error = std::current_exception();
+		}
+		lock.lock();
+		frame->image = image;
+		frame->error = error;
+		frame->ready = true;
+		changed.notify_all();
+	}
+}
+
+shared_ptr<PrefetchingImageSource::Frame> PrefetchingImageSource::fetch() {
+	shared_ptr<Frame> frame = make_shared<Frame>();
+	frame->ready = true;
+	try {
+		if (!source->next()) {
+			exhausted = true;
+			return shared_ptr<Frame>();
+		}
+		buffer.push_back(frame);
+		frame->name = source->getName();
+		frame->file = source->getFile();
+		frame->loader = source->getImageLoader();
+		if (annotatedSource)
+			frame->annotations = annotatedSource->getAnnotations();
+		if (frame->loader || !frame->file.empty()) {
+			frame->ready = false;
+			return frame;
+		}
+		frame->image = source->getImage();
+	} catch (...) {
+		if (buffer.empty() || buffer.back() != frame)
+			buffer.push_back(frame);
+		frame->error = std::current_exception();
+		exhausted = true; // the state of the source is unknown, so it is not used anymore
+	}
+	return shared_ptr<Frame>();
+}
+
+bool PrefetchingImageSource::next() {
+	unique_lock<mutex> lock(access);
+	current.reset();
+	changed.wait(lock, [this]() { return buffer.empty() ? exhausted : buffer.front()->ready; });
+	if (buffer.empty())
+		return false;
+	shared_ptr<Frame> frame = buffer.front();
+	buffer.pop_front();
+	changed.notify_all();
+	if (frame->error)
+		std::rethrow_exception(frame->error);
+	current = frame;
+	return true;
+}
+
+const Mat PrefetchingImageSource::getImage() const {
+	return current ? current->image : Mat();
+}
+
+string PrefetchingImageSource::getName() const {
+	return current ? current->name : "";
+}
+
+Annotations PrefetchingImageSource::getAnnotations() const {
+	return current ? current->annotations : Annotations();
+}
+
+} /* namespace imageio */
@@ -0,0 +1,155 @@
+/*
+ * ThreadedCameraImageSource.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "imageio/ThreadedCameraImageSource.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include <stdexcept>
+
+using cv::Mat;
+using std::invalid_argument;
+using std::lock_guard;
+using std::mutex;
+using std::runtime_error;
+using std::string;
+using std::to_string;
+using std::unique_lock;
+
+namespace imageio {
+
+ThreadedCameraImageSource::ThreadedCameraImageSource(int device, int bufferCount, bool grayscale) :
+		device(device),
+		grayscale(grayscale),
+		camera(device),
+		buffers(),
+		latest(-1),
+		ended(false),
+		stopping(false),
+		droppedCount(0),
+		image(),
+		grayscaleImage(),
+		thread(),
+		access(),
+		changed() {
+	if (bufferCount < 3)
+		throw invalid_argument("ThreadedCameraImageSource: there must be at least three buffers");
+	if (!camera.isOpened())
+		throw invalid_argument("ThreadedCameraImageSource: Could not open stream from device " + to_string(device));
+	buffers.resize(bufferCount);
+	start();
+}
+
+ThreadedCameraImageSource::~ThreadedCameraImageSource() {
+	stop();
+	camera.release();
+}
+
+void ThreadedCameraImageSource::start() {
+	latest = -1;
+	ended = false;
+	stopping = false;
+	thread = std::thread(&ThreadedCameraImageSource::capture, this);
+}
+
+void ThreadedCameraImageSource::stop() {
+	{
+		lock_guard<mutex> lock(access);
+		stopping = true;
+	}
+	changed.notify_all();
+	if (thread.joinable())
+		thread.join();
+}
+
+void ThreadedCameraImageSource::reset() {
+	stop();
+	camera.release();
+	if (!camera.open(device))
+		throw runtime_error("ThreadedCameraImageSource: Could not open stream from device " + to_string(device));
+	image = Mat();
+	grayscaleImage = Mat();
+	start();
+}
+
+bool ThreadedCameraImageSource::next() {
+	unique_lock<mutex> lock(access);
+	changed.wait(lock, [this]() { return latest >= 0 || ended; });
+	if (latest < 0) {
+		image = Mat();
+		grayscaleImage = Mat();
+		return false;
+	}
+	// the current image refers to the buffer, so the capture thread does not overwrite it while it is in use
+	image = buffers[latest].image;
+	grayscaleImage = buffers[latest].grayscaleImage;
+	latest = -1;
+	return true;
+}
+
+const Mat ThreadedCameraImageSource::getImage() const {
+	return image;
+}
+
+const Mat ThreadedCameraImageSource::getGrayscaleImage() const {
+	return grayscaleImage;
+}
+
+string ThreadedCameraImageSource::getName() const {
+	return "";
+}
+
+size_t ThreadedCameraImageSource::getDroppedCount() const {
+	lock_guard<mutex> lock(access);
+	return droppedCount;
+}
+
+void ThreadedCameraImageSource::capture() {
+	unique_lock<mutex> lock(access);
+	while (!stopping) {
+		int index = findFreeBuffer();
+		lock.unlock();
+		bool captured;
+		if (index < 0) { // all buffers are in use, so the image is skipped to keep the camera from lagging behind
+			captured = camera.grab();
+		} else {
+			Buffer& buffer = buffers[index];
+			captured = camera.read(buffer.image);
+			if (captured && grayscale)
+				cv::cvtColor(buffer.image, buffer.grayscaleImage, CV_BGR2GRAY);
+		}
+		lock.lock();
+		if (!captured) {
+			ended = true;
+			changed.notify_all();
+			return;
+		}
+		if (index < 0 || latest >= 0)
+			++droppedCount;
+		if (index >= 0) {
+			latest = index;
+			changed.notify_all();
+		}
+	}
+}
+
+int ThreadedCameraImageSource::findFreeBuffer() const {
+	for (size_t i = 0; i < buffers.size(); ++i) {
+		int index = static_cast<int>(i);
+		if (index != latest && isUnreferenced(buffers[i].image) && isUnreferenced(buffers[i].grayscaleImage))
+			return index;
+	}
+	return -1;
+}
+
+bool ThreadedCameraImageSource::isUnreferenced(const Mat& image) {
+#if CV_MAJOR_VERSION < 3
+	return !image.refcount || *image.refcount == 1;
+#else
+	return !image.u || image.u->refcount == 1;
+#endif
+}
+
+} /* namespace imageio */
@@ -0,0 +1,244 @@
+/*
+ * FrameAllocator.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef IMAGEPROCESSING_FRAMEALLOCATOR_HPP_
+#define IMAGEPROCESSING_FRAMEALLOCATOR_HPP_
+
+#include "opencv2/core/core.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace imageprocessing {
+
+/**
+ * Matrix allocator that keeps the memory of released matrices in an arena and re-uses it for later matrices, so
+ * the temporary matrices of a frame (layer images, filter buffers, split channels, patches, score maps) do not
+ * cause heap allocations once the sizes of the previous frames were seen.
+ *
+ * The memory is organized in blocks of size classes (eight per power of two). Because some matrices outlive the
+ * frame they were created in (e.g. cached pyramid layers or track features), blocks are recycled when their matrix
+ * is released instead of rewinding the whole arena. At the end of each frame, blocks of size classes that were not
+ * requested during the frame are returned to the heap.
+ *
+ * To keep allocations from parallel workers from contending, each thread has its own cache of free blocks and its
+ * own counters, which are merged when the frame is finished. Released blocks go into the cache of the releasing
+ * thread until it holds a few blocks of that size class, further blocks go into a pool that is shared by all
+ * threads and that is only accessed when the cache of a thread cannot serve an allocation.
+ *
+ * The number of allocations and allocated bytes are counted per frame and stage. The stage is the innermost scope
+ * that is measured by the instrumentation (see Instrumentation.hpp) on the allocating thread, so the stages are
+ * only distinguished if INSTRUMENTATION is defined. Allocations outside of any measured scope are counted under
+ * an empty stage name.
+ *
+ * With OpenCV 3 and later, a scope installs the allocator as the default allocator of all matrices. The default
+ * allocator is global to the process, so while a scope is open, the matrices of all threads (e.g. the camera,
+ * prefetching or output threads of an application) are allocated from the arena, too. With OpenCV 2, there is no
+ * default allocator and a scope has no effect, so the arena only serves matrices that the allocator was assigned
+ * to explicitly (cv::Mat::allocator) and the temporary matrices of OpenCV functions are allocated on the heap.
+ * The allocator must outlive all matrices that were allocated by it.
+ */
+class FrameAllocator : public cv::MatAllocator {
+public:
+
+	/**
+	 * Allocation counts of a stage.
+	 */
+	struct Counters {
+		size_t allocations; ///< Number of allocated matrices.
+		size_t bytes; ///< Number of bytes that were requested by the allocated matrices.
+		size_t heapAllocations; ///< Number of allocations that could not be served from the arena.
+		size_t heapBytes; ///< Number of bytes that were allocated on the heap.
+	};
+
+	/**
+	 * Installs an allocator as the default allocator of matrices of all threads until the end of its lifetime. Has
+	 * no effect with OpenCV 2, which does not support a default allocator.
+	 */
+	class Scope {
+	public:
+
+		/**
+		 * Installs the allocator.
+		 *
+		 * @param[in] allocator Allocator that should be used for all new matrices of the process.
+		 */
+		explicit Scope(FrameAllocator& allocator);
+
+		/**
+		 * Re-installs the previous default allocator.
+		 */
+		~Scope();
+
+		Scope(const Scope&) = delete;
+
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+
+		cv::MatAllocator* previousAllocator; ///< Default allocator that was installed before.
+	};
+
+	FrameAllocator();
+
+	~FrameAllocator();
+
+	FrameAllocator(const FrameAllocator&) = delete;
+
+	FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+#if CV_MAJOR_VERSION < 3
+	void allocate(int dims, const int* sizes, int type, int*& refcount, uchar*& datastart, uchar*& data, size_t* step);
+
+	void deallocate(int* refcount, uchar* datastart, uchar* data);
+#else
+#if CV_MAJOR_VERSION < 4
+	typedef int AccessFlag;
+#else
+	typedef cv::AccessFlag AccessFlag;
+#endif
+
+	cv::UMatData* allocate(int dims, const int* sizes, int type,
+			void* data, size_t* step, AccessFlag flags, cv::UMatUsageFlags usageFlags) const;
+
+	bool allocate(cv::UMatData* data, AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const;
+
+	void deallocate(cv::UMatData* data) const;
+#endif
+
+	/**
+	 * Finishes the current frame, making its counters available and returning the blocks of size classes that were
+	 * not requested during the frame to the heap.
+	 */
+	void finishFrame();
+
+	/**
+	 * @return Counters of the last finished frame by stage name (including stages that did not allocate anything).
+	 */
+	std::map<std::string, Counters> getLastFrame() const;
+
+	/**
+	 * @return Counters of the last finished frame summed up over all stages.
+	 */
+	Counters getLastFrameTotal() const;
+
+	/**
+	 * @return Number of bytes that are currently in use by matrices.
+	 */
+	size_t getUsedBytes() const;
+
+	/**
+	 * @return Number of bytes that are kept in the arena for re-use.
+	 */
+	size_t getPooledBytes() const;
+
+private:
+
+	/**
+	 * Blocks of the same capacity.
+	 */
+	struct SizeClass {
+		std::vector<uchar*> freeBlocks; ///< Blocks that are not in use.
+		bool requested; ///< Flag that indicates whether a block was requested during the current frame.
+	};
+
+	/**
+	 * Free blocks and counters of a single thread.
+	 */
+	struct ThreadCache {
+		std::mutex access; ///< Mutex that guards the cache, only contended while finishing a frame.
+		std::unordered_map<size_t, SizeClass> sizeClasses; ///< Size classes by capacity.
+		std::unordered_map<const char*, Counters> currentFrame; ///< Counters of the current frame by stage.
+		long long usedBytes; ///< Change of the bytes in use that was caused by the thread (negative if it released foreign matrices).
+		long long pooledBytes; ///< Number of bytes that are kept in the cache for re-use.
+#if CV_MAJOR_VERSION >= 3
+		std::vector<void*> freeMatData; ///< Memory of released matrix data descriptors.
+#endif
+	};
+
+	/**
+	 * Computes the size of the matrix data, filling in the steps.
+	 *
+	 * @param[in] dims Number of dimensions.
+	 * @param[in] sizes Sizes of the dimensions.
+	 * @param[in] type Type of the matrix elements.
+	 * @param[in,out] step Steps of the dimensions, only computed if data is null or the step is not given.
+	 * @param[in] data Data that was provided by the user, null if the memory should be allocated.
+	 * @return Size of the matrix data in bytes.
+	 */
+	static size_t computeSize(int dims, const int* sizes, int type, size_t* step, const void* data);
+
+	/**
+	 * @param[in] size Number of requested bytes.
+	 * @return Capacity of the size class that the requested bytes belong to.
+	 */
+	static size_t getCapacity(size_t size);
+
+	/**
+	 * Returns all blocks of a size class to the heap.
+	 *
+	 * @param[in] sizeClass Size class.
+	 * @param[in,out] pooledBytes Number of pooled bytes the blocks were counted in.
+	 */
+	static void releaseBlocks(SizeClass& sizeClass, long long& pooledBytes);
+
+	/**
+	 * @return Cache of the calling thread, registered on first use.
+	 */
+	ThreadCache& getThreadCache();
+
+	/**
+	 * Takes a block from the cache of the calling thread, from the shared pool or from the heap.
+	 *
+	 * @param[in] cache Cache of the calling thread.
+	 * @param[in] size Number of requested bytes.
+	 * @return Block with at least the requested number of bytes (after the block header).
+	 */
+	uchar* acquire(ThreadCache& cache, size_t size);
+
+	/**
+	 * Puts a block back into the cache of the calling thread or into the shared pool.
+	 *
+	 * @param[in] cache Cache of the calling thread.
+	 * @param[in] data Block that was acquired before.
+	 */
+	void release(ThreadCache& cache, uchar* data);
+
+#if CV_MAJOR_VERSION >= 3
+	/**
+	 * @param[in] cache Cache of the calling thread.
+	 * @return Memory for a matrix data descriptor.
+	 */
+	void* acquireMatData(ThreadCache& cache);
+
+	/**
+	 * @param[in] cache Cache of the calling thread.
+	 * @param[in] matData Memory of a destroyed matrix data descriptor.
+	 */
+	void releaseMatData(ThreadCache& cache, void* matData);
+#endif
+
+	const size_t id; ///< Number that identifies the allocator in the thread-local references to the caches.
+	mutable std::mutex access; ///< Mutex that guards the registered caches and the last frame, locked before any cache.
+	std::map<std::thread::id, std::shared_ptr<ThreadCache>> threadCaches; ///< Caches of the threads that allocated or released.
+	std::map<std::string, Counters> lastFrame; ///< Counters of the last finished frame by stage.
+	mutable std::mutex poolAccess; ///< Mutex that guards the shared pool, locked after any cache.
+	std::map<size_t, SizeClass> sizeClasses; ///< Shared size classes by capacity.
+	long long usedBytes; ///< Number of bytes in use that were not accounted by the registered caches.
+	long long pooledBytes; ///< Number of bytes that are kept in the shared pool.
+#if CV_MAJOR_VERSION >= 3
+	std::vector<void*> freeMatData; ///< Memory of released matrix data descriptors that are shared.
+#endif
+};
+
+} /* namespace imageprocessing */
+
+#endif /* IMAGEPROCESSING_FRAMEALLOCATOR_HPP_ */
@@ -93,6 +93,15 @@ public:
 	 */
 	explicit ImagePyramid(std::shared_ptr<ImagePyramid> pyramid, double minScaleFactor = 0, double maxScaleFactor = 1);
 
+	/**
+	 * Constructs a new image pyramid without source that consists of existing layers, e.g. layers that were loaded
+	 * from a file. Updating the pyramid does not change it.
+	 *
+	 * @param[in] octaveLayerCount The number of layers per octave.
+	 * @param[in] layers The pyramid layers, ordered by consecutive indices.
+	 */
+	ImagePyramid(int octaveLayerCount, std::vector<std::shared_ptr<ImagePyramidLayer>> layers);
+
 
 	/**
 	 * Adds a new filter that is applied to the original image after the currently existing image filters.
@@ -158,6 +167,13 @@ public:
 	 */
 	void update();
 
+	/**
+	 * @return Version of the source image that the layers were computed from, changes with each update that changes the layers.
+	 */
+	const Version& getVersion() const {
+		return version;
+	}
+
 	/**
 	 * Determines the pyramid layer with the given index.
 	 *
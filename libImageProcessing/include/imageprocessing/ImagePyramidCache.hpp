@@ -0,0 +1,200 @@
+/*
+ * ImagePyramidCache.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef IMAGEPROCESSING_IMAGEPYRAMIDCACHE_HPP_
+#define IMAGEPROCESSING_IMAGEPYRAMIDCACHE_HPP_
+
+#include "imageprocessing/ImagePyramid.hpp"
+#include "imageprocessing/ImagePyramidStore.hpp"
+#include "opencv2/core/core.hpp"
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace imageprocessing {
+
+/**
+ * Thread-safe cache of image pyramids that were computed from images.
+ *
+ * The pyramids are identified by the content of the images (size, type, and two independent hashes of the pixel
+ * values) and the minimum scale factor, so the same pyramid is found for copies of an image or for images that were
+ * re-created with the same content, e.g. by mirroring an image twice. The cache keeps a copy of each image, which is
+ * compared to the requested image on each hit, so a hash collision never leads to the pyramid of another image.
+ * Concurrent requests for the same image compute its pyramid only once. If the total size of the cached pyramid
+ * layers and images exceeds the capacity, the least recently used pyramids are removed from the cache.
+ *
+ * Optionally, the pyramids are kept in a persistent store, so they are loaded instead of computed if they are not
+ * in memory anymore, e.g. in a later run of the program. Stored pyramids are identified by the key only.
+ *
+ * All users of a cache must expect the same pyramid configuration (filters, layers per octave, maximum scale
+ * factor), as the pyramids are not distinguished by it. The cached pyramids must not be updated, but can be used as
+ * the source of other pyramids without filters, which then share the layers instead of copying them.
+ */
+class ImagePyramidCache {
+public:
+
+	/**
+	 * Constructs a new empty image pyramid cache.
+	 *
+	 * @param[in] pyramidFactory Function that creates a new pyramid that is not yet updated with an image.
+	 * @param[in] capacity Maximum size of the cached pyramid layers and images in bytes.
+	 */
+	ImagePyramidCache(std::function<std::shared_ptr<ImagePyramid>()> pyramidFactory, size_t capacity);
+
+	/**
+	 * Retrieves the pyramid of an image, computing it if necessary.
+	 *
+	 * @param[in] image Image.
+	 * @param[in] minScaleFactor Minimum scale factor of the pyramid if it has to be computed.
+	 * @return Pyramid of the image.
+	 */
+	std::shared_ptr<ImagePyramid> get(const cv::Mat& image, double minScaleFactor);
+
+	/**
+	 * Changes the persistent store of the pyramids. The store must only contain pyramids of the configuration
+	 * that is created by the pyramid factory.
+	 *
+	 * @param[in] store Persistent store of the pyramids, null if the pyramids should not be stored.
+	 */
+	void setStore(std::shared_ptr<ImagePyramidStore> store);
+
+	/**
+	 * @return Size of the cached pyramid layers and images in bytes.
+	 */
+	size_t getSize() const;
+
+	/**
+	 * @return Number of requests that were answered from the cache.
+	 */
+	size_t getHitCount() const;
+
+	/**
+	 * @return Number of requests that needed the pyramid to be computed.
+	 */
+	size_t getMissCount() const;
+
+	/**
+	 * @return Number of requests that were answered from the persistent store.
+	 */
+	size_t getLoadCount() const;
+
+private:
+
+	/**
+	 * Identification of a pyramid by the content of its image and its minimum scale factor.
+	 */
+	struct Key {
+		int rows; ///< Row count of the image.
+		int cols; ///< Column count of the image.
+		int type; ///< Type of the image.
+		long long scale; ///< Minimum scale factor of the pyramid in millionths.
+		uint64_t hash; ///< Hash of the pixel values.
+		uint64_t secondHash; ///< Second hash of the pixel values that is independent of the first one.
+
+		bool operator==(const Key& other) const {
+			return rows == other.rows && cols == other.cols && type == other.type && scale == other.scale
+					&& hash == other.hash && secondHash == other.secondHash;
+		}
+	};
+
+	/**
+	 * Hash function of keys.
+	 */
+	struct KeyHash {
+		size_t operator()(const Key& key) const {
+			return static_cast<size_t>(key.hash);
+		}
+	};
+
+	/**
+	 * Cached pyramid.
+	 */
+	struct Entry {
+		std::shared_future<std::shared_ptr<ImagePyramid>> pyramid; ///< Pyramid that might still be computed.
+		cv::Mat image; ///< Copy of the image the pyramid was computed from.
+		size_t size; ///< Size of the pyramid layers and the image in bytes (zero while being computed).
+		std::list<Key>::iterator usage; ///< Position within the usage order.
+	};
+
+	/**
+	 * @param[in] image Image.
+	 * @param[in] minScaleFactor Minimum scale factor of the pyramid.
+	 * @return Key that identifies the pyramid by the content of the image and the minimum scale factor.
+	 */
+	static Key createKey(const cv::Mat& image, double minScaleFactor);
+
+	/**
+	 * @param[in] key Key that identifies a pyramid.
+	 * @return Key of the pyramid within the persistent store.
+	 */
+	static std::string createStoreKey(const Key& key);
+
+	/**
+	 * @param[in] image Image.
+	 * @param[in] other Other image of the same size and type.
+	 * @return True if both images have the same pixel values, false otherwise.
+	 */
+	static bool haveEqualContent(const cv::Mat& image, const cv::Mat& other);
+
+	/**
+	 * Loads a pyramid from the persistent store or computes it if it is not stored.
+	 *
+	 * @param[in] image Image.
+	 * @param[in] key Key that identifies the pyramid.
+	 * @param[in] minScaleFactor Minimum scale factor of the pyramid.
+	 * @return Pyramid of the image.
+	 */
+	std::shared_ptr<ImagePyramid> loadOrCompute(const cv::Mat& image, const Key& key, double minScaleFactor);
+
+	/**
+	 * Computes a pyramid using the pyramid factory.
+	 *
+	 * @param[in] image Image.
+	 * @param[in] minScaleFactor Minimum scale factor of the pyramid.
+	 * @return Pyramid of the image.
+	 */
+	std::shared_ptr<ImagePyramid> compute(const cv::Mat& image, double minScaleFactor) const;
+
+	/**
+	 * @param[in] pyramid Image pyramid.
+	 * @return Size of the pyramid layers in bytes.
+	 */
+	static size_t computeSize(const ImagePyramid& pyramid);
+
+	/**
+	 * Removes a cached pyramid. Must be called while holding the lock.
+	 *
+	 * @param[in] entry Position of the cached pyramid.
+	 */
+	void remove(std::unordered_map<Key, Entry, KeyHash>::iterator entry);
+
+	/**
+	 * Removes the least recently used pyramids until the size does not exceed the capacity anymore. Must be called
+	 * while holding the lock.
+	 */
+	void evict();
+
+	std::function<std::shared_ptr<ImagePyramid>()> pyramidFactory; ///< Function that creates new pyramids.
+	size_t capacity; ///< Maximum size of the cached pyramid layers and images in bytes.
+	size_t size; ///< Size of the cached pyramid layers and images in bytes.
+	size_t hitCount; ///< Number of requests that were answered from the cache.
+	size_t missCount; ///< Number of requests that needed the pyramid to be computed.
+	size_t loadCount; ///< Number of requests that were answered from the persistent store.
+	std::shared_ptr<ImagePyramidStore> store; ///< Persistent store of the pyramids, null if there is none.
+	std::unordered_map<Key, Entry, KeyHash> entries; ///< Cached pyramids.
+	std::list<Key> usage; ///< Keys of the cached pyramids, most recently used first.
+	mutable std::mutex access; ///< Mutex that guards all members but the factory and capacity.
+};
+
+} /* namespace imageprocessing */
+
+#endif /* IMAGEPROCESSING_IMAGEPYRAMIDCACHE_HPP_ */
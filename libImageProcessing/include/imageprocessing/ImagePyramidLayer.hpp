@@ -107,6 +107,20 @@ public:
 		return scale;
 	}
 
+	/**
+	 * @return The actual scale factor of the image width.
+	 */
+	double getWidthScaleFactor() const {
+		return scaleX;
+	}
+
+	/**
+	 * @return The actual scale factor of the image height.
+	 */
+	double getHeightScaleFactor() const {
+		return scaleY;
+	}
+
 	/**
 	 * @return The image of this layer.
 	 */
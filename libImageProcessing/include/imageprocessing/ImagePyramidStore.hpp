@@ -0,0 +1,44 @@
+/*
+ * ImagePyramidStore.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef IMAGEPROCESSING_IMAGEPYRAMIDSTORE_HPP_
+#define IMAGEPROCESSING_IMAGEPYRAMIDSTORE_HPP_
+
+#include "imageprocessing/ImagePyramid.hpp"
+#include <memory>
+#include <string>
+
+namespace imageprocessing {
+
+/**
+ * Persistent storage of computed image pyramids, e.g. on disk. Must be safe to use by several threads concurrently.
+ */
+class ImagePyramidStore {
+public:
+
+	virtual ~ImagePyramidStore() {}
+
+	/**
+	 * Loads a pyramid.
+	 *
+	 * @param[in] key Key that identifies the pyramid (consists of letters, digits and underscores only).
+	 * @return Pyramid that was stored with the given key, null if there is none.
+	 */
+	virtual std::shared_ptr<ImagePyramid> load(const std::string& key) = 0;
+
+	/**
+	 * Stores a pyramid, replacing any pyramid that was stored with the same key.
+	 *
+	 * @param[in] key Key that identifies the pyramid (consists of letters, digits and underscores only).
+	 * @param[in] pyramid Pyramid to store.
+	 */
+	virtual void store(const std::string& key, const ImagePyramid& pyramid) = 0;
+};
+
+} /* namespace imageprocessing */
+
+#endif /* IMAGEPROCESSING_IMAGEPYRAMIDSTORE_HPP_ */
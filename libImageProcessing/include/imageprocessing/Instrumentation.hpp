@@ -0,0 +1,281 @@
+/*
+ * Instrumentation.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef IMAGEPROCESSING_INSTRUMENTATION_HPP_
+#define IMAGEPROCESSING_INSTRUMENTATION_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace imageprocessing {
+
+/**
+ * Registry of the run times of named processing stages and of named counters, used to find out where the time of
+ * a frame went.
+ *
+ * The times and counts of all threads are summed up per frame until the frame is finished, which creates a
+ * snapshot of the frame. To keep the measurements cheap inside of parallel loops, each thread accumulates its times,
+ * counts and trace events separately (keyed by the address of the name) and the values of all threads are merged
+ * into the snapshot when the frame is finished. The snapshots of the most recent frames are kept for computing
+ * percentiles. Optionally, each timed scope is recorded as an event that can be exported in the trace event format
+ * of Chrome (about:tracing).
+ *
+ * The stages report using the macros INSTRUMENT_SCOPE, INSTRUMENT_COUNT and INSTRUMENT_FRAME, which are compiled
+ * out unless INSTRUMENTATION is defined (CMake option ENABLE_INSTRUMENTATION).
+ */
+class Instrumentation {
+public:
+
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * Times (in milliseconds) and counts of a single frame.
+	 */
+	struct Snapshot {
+		size_t frame; ///< Number of the frame.
+		std::map<std::string, double> times; ///< Summed up times of the stages in milliseconds.
+		std::map<std::string, double> counts; ///< Summed up counter values.
+	};
+
+	/**
+	 * Distribution of the per-frame values of a stage or counter over the recent frames (frames without a value
+	 * count as zero).
+	 */
+	struct Statistics {
+		double p50; ///< Median.
+		double p99; ///< 99th percentile.
+		double mean; ///< Mean.
+		double max; ///< Maximum.
+	};
+
+	/**
+	 * @return Registry that is shared by the whole process.
+	 */
+	static Instrumentation& getInstance();
+
+	/**
+	 * Adds the run time of a stage to the current frame.
+	 *
+	 * @param[in] name Name of the stage, must stay valid until the registry is cleared (e.g. a string literal).
+	 * @param[in] start Start of the run.
+	 * @param[in] end End of the run.
+	 */
+	void addTime(const char* name, Clock::time_point start, Clock::time_point end);
+
+	/**
+	 * Adds a value to a counter of the current frame.
+	 *
+	 * @param[in] name Name of the counter, must stay valid until the registry is cleared (e.g. a string literal).
+	 * @param[in] value Value to add.
+	 */
+	void addCount(const char* name, double value);
+
+	/**
+	 * Finishes the current frame, creating its snapshot and starting the next frame.
+	 */
+	void finishFrame();
+
+	/**
+	 * @return Snapshot of the last finished frame, empty if there is none.
+	 */
+	Snapshot getLastFrame() const;
+
+	/**
+	 * @return Statistics of the stage times (in milliseconds) over the recent frames by stage name.
+	 */
+	std::map<std::string, Statistics> getTimeStatistics() const;
+
+	/**
+	 * @return Statistics of the counter values over the recent frames by counter name.
+	 */
+	std::map<std::string, Statistics> getCountStatistics() const;
+
+	/**
+	 * @param[in] frameCount Number of recent frames to keep for computing the statistics.
+	 */
+	void setWindowSize(size_t frameCount);
+
+	/**
+	 * Enables or disables the recording of trace events.
+	 *
+	 * @param[in] enabled Flag that indicates whether each timed scope should be recorded.
+	 * @param[in] maxEventCount Maximum number of recorded events, further events are ignored.
+	 */
+	void setTracing(bool enabled, size_t maxEventCount = 1000000);
+
+	/**
+	 * Removes all times, counts, snapshots and trace events.
+	 */
+	void clear();
+
+	/**
+	 * Writes the last frame and the statistics of the recent frames in JSON format.
+	 *
+	 * @param[in] stream Stream to write into.
+	 */
+	void writeJson(std::ostream& stream) const;
+
+	/**
+	 * Writes the recorded trace events in the trace event format of Chrome.
+	 *
+	 * @param[in] stream Stream to write into.
+	 */
+	void writeChromeTrace(std::ostream& stream) const;
+
+	/**
+	 * @return Name of the innermost stage that is measured on the calling thread, null if there is none.
+	 */
+	static const char* getCurrentStage();
+
+private:
+
+	friend class ScopedTimer;
+
+	/**
+	 * Timed scope or finished frame.
+	 */
+	struct TraceEvent {
+		const char* name; ///< Name of the stage, null for the end of a frame.
+		Clock::time_point start; ///< Start of the scope.
+		Clock::time_point end; ///< End of the scope.
+		int thread; ///< Number of the thread.
+	};
+
+	/**
+	 * Accumulated value of a stage or counter.
+	 */
+	struct Sum {
+		double value; ///< Sum of the added values.
+		bool added; ///< Flag that indicates whether a value was added during the current frame.
+	};
+
+	/**
+	 * Times, counts and trace events of a single thread that were not merged yet.
+	 */
+	struct ThreadData {
+		std::mutex access; ///< Mutex that guards the values, only contended while merging.
+		int thread; ///< Number of the thread.
+		std::unordered_map<const char*, Sum> times; ///< Summed up times of the stages in milliseconds.
+		std::unordered_map<const char*, Sum> counts; ///< Summed up counter values.
+		std::vector<TraceEvent> events; ///< Recorded trace events.
+	};
+
+	Instrumentation();
+
+	/**
+	 * @return Data of the calling thread, registered on first use.
+	 */
+	ThreadData& getThreadData();
+
+	/**
+	 * Moves the accumulated values of a thread into a snapshot, keeping the entries for the next frame.
+	 *
+	 * @param[in,out] sums Accumulated values by name.
+	 * @param[in,out] values Values of the snapshot by name.
+	 */
+	static void merge(std::unordered_map<const char*, Sum>& sums, std::map<std::string, double>& values);
+
+	/**
+	 * Computes the statistics of the values over the recent frames. Must be called while holding the lock.
+	 *
+	 * @param[in] values Member of the snapshots that contains the values.
+	 * @return Statistics by name.
+	 */
+	std::map<std::string, Statistics> computeStatistics(std::map<std::string, double> Snapshot::*values) const;
+
+	/**
+	 * @param[in] name Name of a stage or counter.
+	 * @return Human-readable name (e.g. demangled type names).
+	 */
+	static std::string getDisplayName(const std::string& name);
+
+	/**
+	 * Writes statistics in JSON format.
+	 *
+	 * @param[in] stream Stream to write into.
+	 * @param[in] statistics Statistics by name.
+	 */
+	static void writeJson(std::ostream& stream, const std::map<std::string, Statistics>& statistics);
+
+	/**
+	 * Changes the innermost stage that is measured on the calling thread.
+	 *
+	 * @param[in] name Name of the new stage, null if there is none.
+	 * @return Name of the previous stage.
+	 */
+	static const char* setCurrentStage(const char* name);
+
+	mutable std::mutex access; ///< Mutex that guards the registered threads and all merged values.
+	Clock::time_point origin; ///< Point in time that the trace event times are relative to.
+	size_t currentFrame; ///< Number of the current frame.
+	std::deque<Snapshot> frames; ///< Snapshots of the recent frames, the last one is the newest.
+	size_t windowSize; ///< Number of recent frames to keep.
+	std::atomic<bool> tracing; ///< Flag that indicates whether trace events are recorded.
+	std::atomic<size_t> maxEventCount; ///< Maximum number of recorded trace events.
+	std::atomic<size_t> eventCount; ///< Number of recorded trace events (including the ones that were not merged yet).
+	std::vector<TraceEvent> events; ///< Merged trace events.
+	std::vector<std::shared_ptr<ThreadData>> threads; ///< Data of the registered threads.
+	int threadCount; ///< Number of threads that were registered so far.
+};
+
+/**
+ * Measures the time from its construction to its destruction and adds it to the instrumentation registry.
+ */
+class ScopedTimer {
+public:
+
+	/**
+	 * Starts the measurement.
+	 *
+	 * @param[in] name Name of the stage, must stay valid until the registry is cleared (e.g. a string literal).
+	 */
+	explicit ScopedTimer(const char* name) :
+			name(name), previousStage(Instrumentation::setCurrentStage(name)), start(Instrumentation::Clock::now()) {}
+
+	~ScopedTimer() {
+		Instrumentation::getInstance().addTime(name, start, Instrumentation::Clock::now());
+		Instrumentation::setCurrentStage(previousStage);
+	}
+
+	ScopedTimer(const ScopedTimer&) = delete;
+
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+
+	const char* name; ///< Name of the stage.
+	const char* previousStage; ///< Name of the enclosing stage, null if there is none.
+	Instrumentation::Clock::time_point start; ///< Start of the measurement.
+};
+
+} /* namespace imageprocessing */
+
+#define INSTRUMENTATION_CONCAT_(a, b) a##b
+#define INSTRUMENTATION_CONCAT(a, b) INSTRUMENTATION_CONCAT_(a, b)
+
+#ifdef INSTRUMENTATION
+	/** Measures the time until the end of the enclosing scope as a run of the named stage. */
+	#define INSTRUMENT_SCOPE(name) ::imageprocessing::ScopedTimer INSTRUMENTATION_CONCAT(scopedTimer, __LINE__)(name)
+	/** Adds a value to the named counter of the current frame. */
+	#define INSTRUMENT_COUNT(name, value) ::imageprocessing::Instrumentation::getInstance().addCount(name, value)
+	/** Finishes the current frame. */
+	#define INSTRUMENT_FRAME() ::imageprocessing::Instrumentation::getInstance().finishFrame()
+#else
+	#define INSTRUMENT_SCOPE(name) ((void)0)
+	#define INSTRUMENT_COUNT(name, value) ((void)0)
+	#define INSTRUMENT_FRAME() ((void)0)
+#endif
+
+#endif /* IMAGEPROCESSING_INSTRUMENTATION_HPP_ */
@@ -0,0 +1,60 @@
+/*
+ * MappedImagePyramidStore.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef IMAGEPROCESSING_MAPPEDIMAGEPYRAMIDSTORE_HPP_
+#define IMAGEPROCESSING_MAPPEDIMAGEPYRAMIDSTORE_HPP_
+
+#include "imageprocessing/ImagePyramidStore.hpp"
+#include <string>
+
+namespace imageprocessing {
+
+/**
+ * Store of image pyramids (e.g. feature pyramids) that keeps each pyramid in a binary file of a directory and
+ * memory-maps the files when loading, so the layers are read lazily at page cache speed and are shared with other
+ * processes that use the same pyramids.
+ *
+ * The pyramids of different configurations (filters, layers per octave, scale factors) are kept in separate
+ * sub-directories whose names are derived from a description of the configuration. The loaded layers refer to the
+ * mapped files and must not be changed.
+ */
+class MappedImagePyramidStore : public ImagePyramidStore {
+public:
+
+	/**
+	 * Constructs a new mapped image pyramid store.
+	 *
+	 * @param[in] directory Directory that contains the pyramid files of all configurations (created if necessary).
+	 * @param[in] configuration Description of the configuration of the pyramids, e.g. the filter parameters.
+	 */
+	MappedImagePyramidStore(const std::string& directory, const std::string& configuration);
+
+	std::shared_ptr<ImagePyramid> load(const std::string& key) override;
+
+	void store(const std::string& key, const ImagePyramid& pyramid) override;
+
+	/**
+	 * @return Directory that contains the pyramid files of this store's configuration.
+	 */
+	const std::string& getDirectory() const {
+		return directory;
+	}
+
+private:
+
+	/**
+	 * @param[in] key Key that identifies a pyramid.
+	 * @return Name of the file that contains the pyramid.
+	 */
+	std::string getFilename(const std::string& key) const;
+
+	std::string directory; ///< Directory that contains the pyramid files of this store's configuration.
+};
+
+} /* namespace imageprocessing */
+
+#endif /* IMAGEPROCESSING_MAPPEDIMAGEPYRAMIDSTORE_HPP_ */
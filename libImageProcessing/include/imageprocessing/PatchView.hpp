@@ -0,0 +1,78 @@
+/*
+ * PatchView.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef IMAGEPROCESSING_PATCHVIEW_HPP_
+#define IMAGEPROCESSING_PATCHVIEW_HPP_
+
+#include "imageprocessing/Patch.hpp"
+#include "imageprocessing/Version.hpp"
+#include "opencv2/core/core.hpp"
+
+namespace imageprocessing {
+
+/**
+ * Lightweight patch whose data refers to the memory it was extracted from (e.g. a layer of a feature pyramid)
+ * instead of owning a copy. The data is not continuous in general and is only valid as long as the source is not
+ * updated, which can be checked using the version of the source. Copying a view does not copy the data, so the
+ * data has to be copied explicitly (see copy) if it should be kept.
+ */
+class PatchView {
+public:
+
+	/**
+	 * Constructs an empty view.
+	 */
+	PatchView() : bounds(), data(), version() {}
+
+	/**
+	 * Constructs a new view.
+	 *
+	 * @param[in] bounds The bounds of the patch within the image.
+	 * @param[in] data The patch data that refers to the source memory.
+	 * @param[in] version The version of the source the data was extracted from.
+	 */
+	PatchView(cv::Rect bounds, const cv::Mat& data, const Version& version) :
+			bounds(bounds), data(data), version(version) {}
+
+	/**
+	 * @return The bounds of the patch within the image.
+	 */
+	cv::Rect getBounds() const {
+		return bounds;
+	}
+
+	/**
+	 * @return The patch data that refers to the source memory (might be an image patch or a feature vector).
+	 */
+	const cv::Mat& getData() const {
+		return data;
+	}
+
+	/**
+	 * @return The version of the source the data was extracted from.
+	 */
+	const Version& getVersion() const {
+		return version;
+	}
+
+	/**
+	 * @return Patch that owns a continuous copy of the data, so it may be kept after the source was updated.
+	 */
+	Patch copy() const {
+		return Patch(bounds, data.clone());
+	}
+
+private:
+
+	cv::Rect bounds; ///< The bounds of the patch within the image.
+	cv::Mat data; ///< The patch data that refers to the source memory.
+	Version version; ///< The version of the source the data was extracted from.
+};
+
+} /* namespace imageprocessing */
+
+#endif /* IMAGEPROCESSING_PATCHVIEW_HPP_ */
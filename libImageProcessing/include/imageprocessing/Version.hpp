@@ -8,6 +8,7 @@
 #ifndef IMAGEPROCESSING_VERSION_HPP_
 #define IMAGEPROCESSING_VERSION_HPP_
 
+#include <atomic>
 #include <ostream>
 
 namespace imageprocessing {
@@ -39,7 +40,7 @@ public:
 
 private:
 
-	static int nextInstance;
+	static std::atomic<int> nextInstance; ///< Atomic, as versions might be created by several threads concurrently.
 
 	int instance;
 	int version;
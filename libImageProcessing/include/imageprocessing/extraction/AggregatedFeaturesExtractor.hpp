@@ -9,6 +9,7 @@
 #define IMAGEPROCESSING_EXTRACTION_AGGREGATEDFEATURESEXTRACTOR_HPP_
 
 #include "imageprocessing/ImagePyramid.hpp"
+#include "imageprocessing/ImagePyramidCache.hpp"
 #include "imageprocessing/Patch.hpp"
 #include "imageprocessing/VersionedImage.hpp"
 #include "imageprocessing/extraction/FeatureExtractor.hpp"
@@ -73,8 +74,43 @@ public:
 
 	std::shared_ptr<Patch> extract(cv::Rect bounds) const override;
 
+	/**
+	 * Extracts a patch whose data refers to the feature pyramid instead of being a copy of it. The data stays
+	 * valid until the next update and is not continuous in general.
+	 *
+	 * @param[in] bounds Bounding box of the patch within the image.
+	 * @return Patch whose data is a view into the feature pyramid, null if the patch is outside of the pyramid.
+	 */
+	std::shared_ptr<Patch> extractView(cv::Rect bounds) const;
+
+	/**
+	 * Extracts a patch whose data refers to the feature pyramid without copying it or allocating memory. The view
+	 * stays valid as long as the version of the feature pyramid does not change (see isValid).
+	 *
+	 * @param[in] bounds Bounding box of the patch within the image.
+	 * @param[out] view View of the patch, unchanged if the patch is outside of the pyramid.
+	 * @return True if the patch could be extracted, false if it is outside of the pyramid.
+	 */
+	bool extractView(cv::Rect bounds, PatchView& view) const override;
+
+	/**
+	 * @param[in] view View that was extracted by this extractor.
+	 * @return True if the data of the view still refers to the current feature pyramid, false otherwise.
+	 */
+	bool isValid(const PatchView& view) const;
+
 	std::shared_ptr<ImagePyramid> getFeaturePyramid();
 
+	/**
+	 * Changes the cache that provides the feature pyramids of the images. Instead of computing its own feature
+	 * pyramid, this extractor then refers to the layers of the cached pyramids, which must have been created with
+	 * the same filters and maximum scale factor. The feature pyramid of this extractor (as returned by
+	 * getFeaturePyramid) is a view of the cached pyramid afterwards and must not be changed.
+	 *
+	 * @param[in] cache Cache of feature pyramids, null to compute the feature pyramid again.
+	 */
+	void setPyramidCache(std::shared_ptr<ImagePyramidCache> cache);
+
 	/**
 	 * Converts bounds given as cell indices of an image pyramid layer to pixel indices of the original image.
 	 *
@@ -143,11 +179,20 @@ private:
 	 */
 	cv::Point computePointInLayerCells(cv::Point_<double> pointInImagePixels, const ImagePyramidLayer& layer) const;
 
-	std::shared_ptr<Patch> extract(const ImagePyramidLayer& layer, cv::Rect boundsInLayerCells) const;
+	/**
+	 * Extracts a patch from the layer that fits the given bounds best.
+	 *
+	 * @param[in] bounds Bounding box of the patch within the image.
+	 * @param[in] copyData Flag that indicates whether the patch data should be copied or refer to the layer.
+	 * @return Extracted patch, null if the patch is outside of the feature pyramid.
+	 */
+	std::shared_ptr<Patch> extract(cv::Rect bounds, bool copyData) const;
 
 	bool isPatchWithinImage(cv::Rect bounds, const cv::Mat& image) const;
 
 	std::shared_ptr<ImagePyramid> featurePyramid;
+	std::shared_ptr<ImagePyramid> ownFeaturePyramid; ///< Feature pyramid that is computed by this extractor, null if there is no cache.
+	std::shared_ptr<ImagePyramidCache> pyramidCache; ///< Cache that provides the feature pyramids, null if they are computed by this extractor.
 	cv::Size patchSizeInCells;
 	cv::Size patchSizeInPixels;
 	int cellSizeInPixels;
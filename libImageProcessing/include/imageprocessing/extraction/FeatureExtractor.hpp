@@ -10,6 +10,7 @@
 
 #include "opencv2/core/core.hpp"
 #include "imageprocessing/Patch.hpp"
+#include "imageprocessing/PatchView.hpp"
 #include "imageprocessing/VersionedImage.hpp"
 #include <memory>
 
@@ -62,6 +63,23 @@ public:
 		cv::Point center = Patch::computeCenter(bounds);
 		return extract(center.x, center.y, bounds.width, bounds.height);
 	}
+
+	/**
+	 * Extracts the feature vector of a certain location (patch) of the current image without copying it, if possible.
+	 * The data of the view might refer to memory of this extractor that changes with the next update, so it has to be
+	 * copied if it should be kept. By default, the feature vector is extracted as a copy.
+	 *
+	 * @param[in] bounds The bounds of the patch.
+	 * @param[out] view The view of the patch, unchanged if the patch could not be created.
+	 * @return True if the patch could be created, false otherwise.
+	 */
+	virtual bool extractView(cv::Rect bounds, PatchView& view) const {
+		std::shared_ptr<Patch> patch = extract(bounds);
+		if (!patch)
+			return false;
+		view = PatchView(patch->getBounds(), patch->getData(), Version());
+		return true;
+	}
 };
 
 } /* namespace extraction */
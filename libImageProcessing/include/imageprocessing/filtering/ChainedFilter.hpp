@@ -58,6 +58,13 @@ public:
 	 */
 	void add(std::shared_ptr<ImageFilter> filter);
 
+	/**
+	 * @return True if there are no filters (applying this filter just copies the image), false otherwise.
+	 */
+	bool empty() const {
+		return filters.empty();
+	}
+
 	using ImageFilter::applyTo;
 
 	cv::Mat applyTo(const cv::Mat& image, cv::Mat& filtered) const;
@@ -0,0 +1,389 @@
+/*
+ * FrameAllocator.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "imageprocessing/FrameAllocator.hpp"
+#include "imageprocessing/Instrumentation.hpp"
+#include <atomic>
+#include <new>
+#include <stdexcept>
+
+using cv::Mat;
+using std::lock_guard;
+using std::make_shared;
+using std::map;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+
+namespace imageprocessing {
+
+namespace {
+
+const size_t headerSize = 64; ///< Size of the block header, keeps the alignment of the matrix data.
+const size_t autoStep = 0x7fffffff; ///< Step that is computed from the sizes (CV_AUTOSTEP).
+const size_t maxCachedBlocks = 16; ///< Maximum number of free blocks per size class (or descriptors) that a thread keeps.
+
+std::atomic<size_t> allocatorCount(0); ///< Number of allocators that were created so far.
+
+/**
+ * Header in front of the matrix data of each block.
+ */
+struct BlockHeader {
+	size_t capacity; ///< Number of bytes after the header.
+	int refcount; ///< Reference counter of the matrix data (only used by OpenCV 2).
+};
+
+BlockHeader* getHeader(uchar* data) {
+	return reinterpret_cast<BlockHeader*>(data - headerSize);
+}
+
+} // namespace
+
+FrameAllocator::Scope::Scope(FrameAllocator& allocator) :
+#if CV_MAJOR_VERSION < 3
+		previousAllocator(nullptr) {}
+#else
+		previousAllocator(Mat::getDefaultAllocator()) {
+	Mat::setDefaultAllocator(&allocator);
+}
+#endif
+
+FrameAllocator::Scope::~Scope() {
+#if CV_MAJOR_VERSION >= 3
+	Mat::setDefaultAllocator(previousAllocator);
+#endif
+}
+
+FrameAllocator::FrameAllocator() :
+		id(++allocatorCount),
+		access(),
+		threadCaches(),
+		lastFrame(),
+		poolAccess(),
+		sizeClasses(),
+		usedBytes(0),
+		pooledBytes(0) {}
+
+FrameAllocator::~FrameAllocator() {
+	for (auto& threadCache : threadCaches) {
+		// the cache might still be referenced by its thread, so it is emptied instead of relying on its destruction
+		ThreadCache& cache = *threadCache.second;
+		lock_guard<mutex> lock(cache.access);
+		for (auto& sizeClass : cache.sizeClasses)
+			releaseBlocks(sizeClass.second, cache.pooledBytes);
+		cache.sizeClasses.clear();
+#if CV_MAJOR_VERSION >= 3
+		for (void* matData : cache.freeMatData)
+			::operator delete(matData);
+		cache.freeMatData.clear();
+#endif
+	}
+	for (auto& sizeClass : sizeClasses)
+		releaseBlocks(sizeClass.second, pooledBytes);
+#if CV_MAJOR_VERSION >= 3
+	for (void* matData : freeMatData)
+		::operator delete(matData);
+#endif
+}
+
+#if CV_MAJOR_VERSION < 3
+
+void FrameAllocator::allocate(int dims, const int* sizes, int type,
+		int*& refcount, uchar*& datastart, uchar*& data, size_t* step) {
+	size_t size = computeSize(dims, sizes, type, step, nullptr);
+	data = datastart = acquire(getThreadCache(), size);
+	refcount = &getHeader(data)->refcount;
+	*refcount = 1;
+}
+
+void FrameAllocator::deallocate(int* refcount, uchar* datastart, uchar* data) {
+	release(getThreadCache(), datastart);
+}
+
+#else
+
+cv::UMatData* FrameAllocator::allocate(int dims, const int* sizes, int type,
+		void* data, size_t* step, AccessFlag flags, cv::UMatUsageFlags usageFlags) const {
+	// the allocator interface of OpenCV is const, although the arena changes
+	FrameAllocator& self = const_cast<FrameAllocator&>(*this);
+	size_t size = computeSize(dims, sizes, type, step, data);
+	ThreadCache& cache = self.getThreadCache();
+	cv::UMatData* u = new (self.acquireMatData(cache)) cv::UMatData(this);
+	u->size = size;
+	if (data) {
+		u->data = u->origdata = static_cast<uchar*>(data);
+		u->flags |= cv::UMatData::USER_ALLOCATED;
+	} else {
+		u->data = u->origdata = self.acquire(cache, size);
+	}
+	return u;
+}
+
+bool FrameAllocator::allocate(cv::UMatData* data, AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const {
+	return data != nullptr;
+}
+
+void FrameAllocator::deallocate(cv::UMatData* u) const {
+	if (!u)
+		return;
+	FrameAllocator& self = const_cast<FrameAllocator&>(*this);
+	ThreadCache& cache = self.getThreadCache();
+	if (!(u->flags & cv::UMatData::USER_ALLOCATED))
+		self.release(cache, u->origdata);
+	u->~UMatData();
+	self.releaseMatData(cache, u);
+}
+
+#endif
+
+void FrameAllocator::finishFrame() {
+	lock_guard<mutex> lock(access);
+	// the counters are reset instead of removed, so the maps do not allocate in the steady state
+	for (auto& stageCounters : lastFrame)
+		stageCounters.second = Counters{0, 0, 0, 0};
+	Counters total = {0, 0, 0, 0};
+	for (auto& threadCache : threadCaches) {
+		ThreadCache& cache = *threadCache.second;
+		lock_guard<mutex> cacheLock(cache.access);
+		for (auto& stageCounters : cache.currentFrame) {
+			Counters& counters = stageCounters.second;
+			Counters& stage = lastFrame[stageCounters.first ? stageCounters.first : ""];
+			stage.allocations += counters.allocations;
+			stage.bytes += counters.bytes;
+			stage.heapAllocations += counters.heapAllocations;
+			stage.heapBytes += counters.heapBytes;
+			total.allocations += counters.allocations;
+			total.bytes += counters.bytes;
+			total.heapAllocations += counters.heapAllocations;
+			total.heapBytes += counters.heapBytes;
+			counters = Counters{0, 0, 0, 0};
+		}
+		// the shared size classes collect whether any thread requested a block
+		lock_guard<mutex> poolLock(poolAccess);
+		for (auto& sizeClass : cache.sizeClasses) {
+			if (sizeClass.second.requested)
+				sizeClasses[sizeClass.first].requested = true;
+			sizeClass.second.requested = false;
+		}
+	}
+	for (auto threadCache = threadCaches.begin(); threadCache != threadCaches.end();) {
+		bool ended = threadCache->second.use_count() == 1; // only referenced by the registry
+		{
+			ThreadCache& cache = *threadCache->second;
+			lock_guard<mutex> cacheLock(cache.access);
+			lock_guard<mutex> poolLock(poolAccess);
+			for (auto& sizeClass : cache.sizeClasses) {
+				SizeClass& sharedSizeClass = sizeClasses[sizeClass.first];
+				if (!sharedSizeClass.requested) {
+					releaseBlocks(sizeClass.second, cache.pooledBytes);
+				} else if (ended) {
+					sharedSizeClass.freeBlocks.insert(sharedSizeClass.freeBlocks.end(),
+							sizeClass.second.freeBlocks.begin(), sizeClass.second.freeBlocks.end());
+					sizeClass.second.freeBlocks.clear();
+				}
+			}
+			if (ended) {
+				usedBytes += cache.usedBytes;
+				pooledBytes += cache.pooledBytes;
+#if CV_MAJOR_VERSION >= 3
+				freeMatData.insert(freeMatData.end(), cache.freeMatData.begin(), cache.freeMatData.end());
+				cache.freeMatData.clear();
+#endif
+			}
+		}
+		if (ended)
+			threadCache = threadCaches.erase(threadCache);
+		else
+			++threadCache;
+	}
+	{
+		lock_guard<mutex> poolLock(poolAccess);
+		for (auto& sizeClass : sizeClasses) {
+			if (!sizeClass.second.requested)
+				releaseBlocks(sizeClass.second, pooledBytes);
+			sizeClass.second.requested = false;
+		}
+	}
+	INSTRUMENT_COUNT("memory.allocations", total.allocations);
+	INSTRUMENT_COUNT("memory.heap_allocations", total.heapAllocations);
+	INSTRUMENT_COUNT("memory.heap_bytes", total.heapBytes);
+}
+
+map<string, FrameAllocator::Counters> FrameAllocator::getLastFrame() const {
+	lock_guard<mutex> lock(access);
+	return lastFrame;
+}
+
+FrameAllocator::Counters FrameAllocator::getLastFrameTotal() const {
+	lock_guard<mutex> lock(access);
+	Counters total = {0, 0, 0, 0};
+	for (const auto& stageCounters : lastFrame) {
+		total.allocations += stageCounters.second.allocations;
+		total.bytes += stageCounters.second.bytes;
+		total.heapAllocations += stageCounters.second.heapAllocations;
+		total.heapBytes += stageCounters.second.heapBytes;
+	}
+	return total;
+}
+
+size_t FrameAllocator::getUsedBytes() const {
+	lock_guard<mutex> lock(access);
+	long long bytes = 0;
+	for (const auto& threadCache : threadCaches) {
+		lock_guard<mutex> cacheLock(threadCache.second->access);
+		bytes += threadCache.second->usedBytes;
+	}
+	lock_guard<mutex> poolLock(poolAccess);
+	return static_cast<size_t>(bytes + usedBytes);
+}
+
+size_t FrameAllocator::getPooledBytes() const {
+	lock_guard<mutex> lock(access);
+	long long bytes = 0;
+	for (const auto& threadCache : threadCaches) {
+		lock_guard<mutex> cacheLock(threadCache.second->access);
+		bytes += threadCache.second->pooledBytes;
+	}
+	lock_guard<mutex> poolLock(poolAccess);
+	return static_cast<size_t>(bytes + pooledBytes);
+}
+
+size_t FrameAllocator::computeSize(int dims, const int* sizes, int type, size_t* step, const void* data) {
+	size_t size = CV_ELEM_SIZE(type);
+	for (int i = dims - 1; i >= 0; --i) {
+		if (step) {
+			if (data && step[i] != autoStep) {
+				if (size > step[i])
+					throw std::invalid_argument("FrameAllocator: step must not be smaller than the row size");
+				size = step[i];
+			} else {
+				step[i] = size;
+			}
+		}
+		size *= sizes[i];
+	}
+	return size;
+}
+
+size_t FrameAllocator::getCapacity(size_t size) {
+	size_t power = 64;
+	while (power < size)
+		power *= 2;
+	size_t granularity = power / 16; // eight size classes between power / 2 and power
+	return (size + granularity - 1) / granularity * granularity;
+}
+
+void FrameAllocator::releaseBlocks(SizeClass& sizeClass, long long& pooledBytes) {
+	for (uchar* data : sizeClass.freeBlocks) {
+		pooledBytes -= getHeader(data)->capacity;
+		cv::fastFree(getHeader(data));
+	}
+	sizeClass.freeBlocks.clear();
+	sizeClass.freeBlocks.shrink_to_fit();
+}
+
+FrameAllocator::ThreadCache& FrameAllocator::getThreadCache() {
+	// the reference to the cache of the most recently used allocator avoids the lock in the common case
+	thread_local size_t allocatorId = 0;
+	thread_local shared_ptr<ThreadCache> cache;
+	if (allocatorId != id) {
+		lock_guard<mutex> lock(access);
+		shared_ptr<ThreadCache>& threadCache = threadCaches[std::this_thread::get_id()];
+		if (!threadCache) {
+			threadCache = make_shared<ThreadCache>();
+			threadCache->usedBytes = 0;
+			threadCache->pooledBytes = 0;
+		}
+		cache = threadCache;
+		allocatorId = id;
+	}
+	return *cache;
+}
+
+uchar* FrameAllocator::acquire(ThreadCache& cache, size_t size) {
+	size_t capacity = getCapacity(size);
+	{
+		lock_guard<mutex> lock(cache.access);
+		SizeClass& sizeClass = cache.sizeClasses[capacity];
+		sizeClass.requested = true;
+		Counters& counters = cache.currentFrame[Instrumentation::getCurrentStage()]; // value-initialized on first use
+		++counters.allocations;
+		counters.bytes += size;
+		cache.usedBytes += capacity;
+		if (!sizeClass.freeBlocks.empty()) {
+			uchar* data = sizeClass.freeBlocks.back();
+			sizeClass.freeBlocks.pop_back();
+			cache.pooledBytes -= capacity;
+			return data;
+		}
+		{
+			lock_guard<mutex> poolLock(poolAccess);
+			auto sharedSizeClass = sizeClasses.find(capacity);
+			if (sharedSizeClass != sizeClasses.end() && !sharedSizeClass->second.freeBlocks.empty()) {
+				uchar* data = sharedSizeClass->second.freeBlocks.back();
+				sharedSizeClass->second.freeBlocks.pop_back();
+				pooledBytes -= capacity;
+				return data;
+			}
+		}
+		++counters.heapAllocations;
+		counters.heapBytes += headerSize + capacity;
+	}
+	uchar* block = static_cast<uchar*>(cv::fastMalloc(headerSize + capacity));
+	uchar* data = block + headerSize;
+	getHeader(data)->capacity = capacity;
+	return data;
+}
+
+void FrameAllocator::release(ThreadCache& cache, uchar* data) {
+	size_t capacity = getHeader(data)->capacity;
+	lock_guard<mutex> lock(cache.access);
+	cache.usedBytes -= capacity;
+	SizeClass& sizeClass = cache.sizeClasses[capacity];
+	if (sizeClass.freeBlocks.size() < maxCachedBlocks) {
+		sizeClass.freeBlocks.push_back(data);
+		cache.pooledBytes += capacity;
+	} else { // blocks that are allocated by one thread and released by another end up in the shared pool
+		lock_guard<mutex> poolLock(poolAccess);
+		sizeClasses[capacity].freeBlocks.push_back(data);
+		pooledBytes += capacity;
+	}
+}
+
+#if CV_MAJOR_VERSION >= 3
+
+void* FrameAllocator::acquireMatData(ThreadCache& cache) {
+	{
+		lock_guard<mutex> lock(cache.access);
+		if (!cache.freeMatData.empty()) {
+			void* matData = cache.freeMatData.back();
+			cache.freeMatData.pop_back();
+			return matData;
+		}
+		lock_guard<mutex> poolLock(poolAccess);
+		if (!freeMatData.empty()) {
+			void* matData = freeMatData.back();
+			freeMatData.pop_back();
+			return matData;
+		}
+	}
+	return ::operator new(sizeof(cv::UMatData));
+}
+
+void FrameAllocator::releaseMatData(ThreadCache& cache, void* matData) {
+	lock_guard<mutex> lock(cache.access);
+	if (cache.freeMatData.size() < maxCachedBlocks) {
+		cache.freeMatData.push_back(matData);
+	} else {
+		lock_guard<mutex> poolLock(poolAccess);
+		freeMatData.push_back(matData);
+	}
+}
+
+#endif
+
+} /* namespace imageprocessing */
@@ -7,6 +7,7 @@
 
 #include "imageprocessing/ImagePyramid.hpp"
 #include "imageprocessing/ImagePyramidLayer.hpp"
+#include "imageprocessing/Instrumentation.hpp"
 #include "imageprocessing/VersionedImage.hpp"
 #include "imageprocessing/filtering/ChainedFilter.hpp"
 #include "opencv2/imgproc/imgproc.hpp"
@@ -70,6 +71,14 @@ ImagePyramid::ImagePyramid(shared_ptr<ImagePyramid> pyramid, double minScaleFact
 		firstLayer(0), layers(), lambdas(), sourceImage(), sourcePyramid(pyramid), version(),
 		imageFilter(make_shared<ChainedFilter>()), layerFilter(make_shared<ChainedFilter>()) {}
 
+ImagePyramid::ImagePyramid(int octaveLayerCount, vector<shared_ptr<ImagePyramidLayer>> layers) :
+		ImagePyramid(octaveLayerCount, layers.empty() ? 1 : layers.back()->getScaleFactor(),
+				layers.empty() ? 1 : layers.front()->getScaleFactor()) {
+	this->layers = std::move(layers);
+	if (!this->layers.empty())
+		firstLayer = this->layers.front()->getIndex();
+}
+
 void ImagePyramid::addImageFilter(const shared_ptr<ImageFilter>& filter) {
 	imageFilter->add(filter);
 	if (sourcePyramid)
@@ -133,6 +142,7 @@ void ImagePyramid::update() {
 }
 
 void ImagePyramid::createLayers(const Mat& image) {
+	INSTRUMENT_SCOPE("pyramid.exact");
 	Mat filteredImage = imageFilter->applyTo(image);
 	for (size_t i = 0; i < octaveLayerCount; ++i) {
 		double scaleFactor = pow(incrementalScaleFactor, i);
@@ -162,14 +172,24 @@ void ImagePyramid::createLayers(const Mat& image) {
 }
 
 void ImagePyramid::createLayers(const ImagePyramid& pyramid) {
+	INSTRUMENT_SCOPE("pyramid.approximated");
 	if (octaveLayerCount % pyramid.octaveLayerCount != 0)
 		throw runtime_error(
 				"ImagePyramid: octaveLayerCount must be divisible by the source pyramid's octaveLayerCount to enable approximation of layers");
+	int layersPerOriginalLayer = octaveLayerCount / pyramid.octaveLayerCount;
+	if (layersPerOriginalLayer == 1 && layerFilter->empty()) { // nothing to filter or approximate, share the layers
+		for (const shared_ptr<ImagePyramidLayer>& layer : pyramid.layers) {
+			if (layer->getScaleFactor() < minScaleFactor)
+				break;
+			if (layer->getScaleFactor() <= maxScaleFactor)
+				layers.push_back(layer);
+		}
+		return;
+	}
 	vector<shared_ptr<ImagePyramidLayer>> filteredLayers;
 	filteredLayers.reserve(pyramid.layers.size());
 	for (const shared_ptr<ImagePyramidLayer>& layer : pyramid.layers)
 		filteredLayers.push_back(layer->createFiltered(*layerFilter));
-	int layersPerOriginalLayer = octaveLayerCount / pyramid.octaveLayerCount;
 	vector<double> lambdas = this->lambdas;
 	if (lambdas.size() == 0)
 		lambdas = estimateLambdas(filteredLayers);
@@ -239,6 +259,7 @@ vector<double> ImagePyramid::computeLambdas(const vector<double>& channelRatios,
 }
 
 Mat ImagePyramid::resize(const Mat& image, double scaleFactor, const vector<double>& lambdas) const {
+	INSTRUMENT_SCOPE("pyramid.resize");
 	Size scaledSize(cvRound(image.cols * scaleFactor), cvRound(image.rows * scaleFactor));
 	vector<Mat> channels;
 	cv::split(image, channels);
@@ -0,0 +1,202 @@
+/*
+ * ImagePyramidCache.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "imageprocessing/ImagePyramidCache.hpp"
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+using cv::Mat;
+using std::function;
+using std::invalid_argument;
+using std::lock_guard;
+using std::mutex;
+using std::promise;
+using std::shared_future;
+using std::shared_ptr;
+using std::string;
+
+namespace imageprocessing {
+
+ImagePyramidCache::ImagePyramidCache(function<shared_ptr<ImagePyramid>()> pyramidFactory, size_t capacity) :
+		pyramidFactory(pyramidFactory), capacity(capacity), size(0), hitCount(0), missCount(0), loadCount(0), store(), entries(), usage(), access() {
+	if (!pyramidFactory)
+		throw invalid_argument("ImagePyramidCache: the pyramid factory must not be empty");
+}
+
+shared_ptr<ImagePyramid> ImagePyramidCache::get(const Mat& image, double minScaleFactor) {
+	Key key = createKey(image, minScaleFactor);
+	promise<shared_ptr<ImagePyramid>> pyramidPromise;
+	shared_future<shared_ptr<ImagePyramid>> cachedPyramid;
+	bool collision = false;
+	{
+		lock_guard<mutex> lock(access);
+		auto entry = entries.find(key);
+		if (entry != entries.end() && !haveEqualContent(image, entry->second.image)) {
+			++missCount;
+			collision = true;
+		} else if (entry != entries.end()) {
+			++hitCount;
+			usage.splice(usage.begin(), usage, entry->second.usage);
+			cachedPyramid = entry->second.pyramid;
+		} else {
+			++missCount;
+			usage.push_front(key);
+			// the image is copied, as the caller might change it in place after the pyramid was computed
+			entries.emplace(key, Entry{pyramidPromise.get_future().share(), image.clone(), 0, usage.begin()});
+		}
+	}
+	if (collision) // both hashes collide with another image, so the pyramid is neither cached nor stored
+		return compute(image, minScaleFactor);
+	if (cachedPyramid.valid())
+		return cachedPyramid.get(); // waits if another thread is still computing the pyramid
+	try {
+		shared_ptr<ImagePyramid> pyramid = loadOrCompute(image, key, minScaleFactor);
+		pyramidPromise.set_value(pyramid);
+		lock_guard<mutex> lock(access);
+		auto entry = entries.find(key);
+		if (entry != entries.end() && entry->second.size == 0) {
+			entry->second.size = computeSize(*pyramid) + entry->second.image.total() * entry->second.image.elemSize();
+			size += entry->second.size;
+			evict();
+		}
+		return pyramid;
+	} catch (...) {
+		pyramidPromise.set_exception(std::current_exception());
+		lock_guard<mutex> lock(access);
+		auto entry = entries.find(key);
+		if (entry != entries.end() && entry->second.size == 0)
+			remove(entry);
+		throw;
+	}
+}
+
+shared_ptr<ImagePyramid> ImagePyramidCache::loadOrCompute(const Mat& image, const Key& key, double minScaleFactor) {
+	shared_ptr<ImagePyramidStore> store;
+	{
+		lock_guard<mutex> lock(access);
+		store = this->store;
+	}
+	string storeKey = store ? createStoreKey(key) : "";
+	if (store) {
+		shared_ptr<ImagePyramid> pyramid = store->load(storeKey);
+		if (pyramid) {
+			lock_guard<mutex> lock(access);
+			++loadCount;
+			return pyramid;
+		}
+	}
+	shared_ptr<ImagePyramid> pyramid = compute(image, minScaleFactor);
+	if (store)
+		store->store(storeKey, *pyramid);
+	return pyramid;
+}
+
+shared_ptr<ImagePyramid> ImagePyramidCache::compute(const Mat& image, double minScaleFactor) const {
+	shared_ptr<ImagePyramid> pyramid = pyramidFactory();
+	pyramid->setMinScaleFactor(minScaleFactor);
+	pyramid->update(image);
+	return pyramid;
+}
+
+void ImagePyramidCache::setStore(shared_ptr<ImagePyramidStore> store) {
+	lock_guard<mutex> lock(access);
+	this->store = store;
+}
+
+size_t ImagePyramidCache::getSize() const {
+	lock_guard<mutex> lock(access);
+	return size;
+}
+
+size_t ImagePyramidCache::getHitCount() const {
+	lock_guard<mutex> lock(access);
+	return hitCount;
+}
+
+size_t ImagePyramidCache::getMissCount() const {
+	lock_guard<mutex> lock(access);
+	return missCount;
+}
+
+size_t ImagePyramidCache::getLoadCount() const {
+	lock_guard<mutex> lock(access);
+	return loadCount;
+}
+
+string ImagePyramidCache::createStoreKey(const Key& key) {
+	std::ostringstream stream;
+	stream << key.rows << '_' << key.cols << '_' << key.type << '_'
+			<< std::hex << std::setfill('0') << std::setw(16) << key.hash << std::setw(16) << key.secondHash << '_'
+			<< std::dec << key.scale;
+	return stream.str();
+}
+
+ImagePyramidCache::Key ImagePyramidCache::createKey(const Mat& image, double minScaleFactor) {
+	// FNV-1a and a multiply-rotate hash (as used by MurmurHash) over 64-bit words (and the remaining bytes of each row)
+	const uint64_t prime = 1099511628211ull;
+	const uint64_t multiplier1 = 0x87c37b91114253d5ull;
+	const uint64_t multiplier2 = 0x4cf5ad432745937full;
+	auto mix = [&](uint64_t secondHash, uint64_t word) {
+		word *= multiplier1;
+		word = (word << 31) | (word >> 33);
+		secondHash ^= word * multiplier2;
+		return ((secondHash << 27) | (secondHash >> 37)) * 5 + 0x52dce729;
+	};
+	uint64_t hash = 14695981039346656037ull;
+	uint64_t secondHash = 0;
+	size_t rowSize = image.cols * image.elemSize();
+	for (int row = 0; row < image.rows; ++row) {
+		const uchar* values = image.ptr(row);
+		size_t i = 0;
+		for (; i + sizeof(uint64_t) <= rowSize; i += sizeof(uint64_t)) {
+			uint64_t word;
+			std::memcpy(&word, values + i, sizeof(word));
+			hash = (hash ^ word) * prime;
+			secondHash = mix(secondHash, word);
+		}
+		for (; i < rowSize; ++i) {
+			hash = (hash ^ values[i]) * prime;
+			secondHash = mix(secondHash, values[i]);
+		}
+	}
+	long long scale = static_cast<long long>(std::round(minScaleFactor * 1e6));
+	return Key{image.rows, image.cols, image.type(), scale, hash, secondHash};
+}
+
+bool ImagePyramidCache::haveEqualContent(const Mat& image, const Mat& other) {
+	size_t rowSize = image.cols * image.elemSize();
+	for (int row = 0; row < image.rows; ++row) {
+		if (std::memcmp(image.ptr(row), other.ptr(row), rowSize) != 0)
+			return false;
+	}
+	return true;
+}
+
+size_t ImagePyramidCache::computeSize(const ImagePyramid& pyramid) {
+	size_t size = 0;
+	for (const shared_ptr<ImagePyramidLayer>& layer : pyramid.getLayers()) {
+		const Mat& image = layer->getScaledImage();
+		size += image.total() * image.elemSize();
+	}
+	return size;
+}
+
+void ImagePyramidCache::evict() {
+	while (size > capacity && usage.size() > 1)
+		remove(entries.find(usage.back()));
+}
+
+void ImagePyramidCache::remove(std::unordered_map<Key, Entry, KeyHash>::iterator entry) {
+	size -= entry->second.size;
+	usage.erase(entry->second.usage);
+	entries.erase(entry);
+}
+
+} /* namespace imageprocessing */
@@ -0,0 +1,291 @@
+/*
+ * Instrumentation.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "imageprocessing/Instrumentation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#ifdef __GNUG__
+	#include <cxxabi.h>
+#endif
+
+using std::endl;
+using std::lock_guard;
+using std::map;
+using std::mutex;
+using std::ostream;
+using std::shared_ptr;
+using std::string;
+using std::unordered_map;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+
+namespace imageprocessing {
+
+namespace {
+
+thread_local const char* currentStage = nullptr; ///< Innermost stage that is measured on the current thread.
+
+} // namespace
+
+Instrumentation& Instrumentation::getInstance() {
+	static Instrumentation instance;
+	return instance;
+}
+
+Instrumentation::Instrumentation() :
+		access(),
+		origin(Clock::now()),
+		currentFrame(0),
+		frames(),
+		windowSize(1000),
+		tracing(false),
+		maxEventCount(0),
+		eventCount(0),
+		events(),
+		threads(),
+		threadCount(0) {}
+
+void Instrumentation::addTime(const char* name, Clock::time_point start, Clock::time_point end) {
+	ThreadData& data = getThreadData();
+	lock_guard<mutex> lock(data.access);
+	Sum& time = data.times[name]; // value-initialized on first use
+	time.value += duration<double, std::milli>(end - start).count();
+	time.added = true;
+	if (tracing.load(std::memory_order_relaxed)
+			&& eventCount.fetch_add(1, std::memory_order_relaxed) < maxEventCount.load(std::memory_order_relaxed))
+		data.events.push_back(TraceEvent{name, start, end, data.thread});
+}
+
+void Instrumentation::addCount(const char* name, double value) {
+	ThreadData& data = getThreadData();
+	lock_guard<mutex> lock(data.access);
+	Sum& count = data.counts[name];
+	count.value += value;
+	count.added = true;
+}
+
+void Instrumentation::finishFrame() {
+	ThreadData& callingThread = getThreadData();
+	lock_guard<mutex> lock(access);
+	Snapshot snapshot{currentFrame, {}, {}};
+	for (const shared_ptr<ThreadData>& data : threads) {
+		lock_guard<mutex> threadLock(data->access);
+		merge(data->times, snapshot.times);
+		merge(data->counts, snapshot.counts);
+		events.insert(events.end(), data->events.begin(), data->events.end());
+		data->events.clear();
+	}
+	// threads that ended were merged for the last time and are only referenced by the registry
+	threads.erase(std::remove_if(threads.begin(), threads.end(), [](const shared_ptr<ThreadData>& data) {
+		return data.use_count() == 1;
+	}), threads.end());
+	if (tracing && eventCount.fetch_add(1, std::memory_order_relaxed) < maxEventCount) {
+		Clock::time_point now = Clock::now();
+		events.push_back(TraceEvent{nullptr, now, now, callingThread.thread});
+	}
+	frames.push_back(std::move(snapshot));
+	while (frames.size() > windowSize)
+		frames.pop_front();
+	++currentFrame;
+}
+
+Instrumentation::Snapshot Instrumentation::getLastFrame() const {
+	lock_guard<mutex> lock(access);
+	return frames.empty() ? Snapshot{0, {}, {}} : frames.back();
+}
+
+map<string, Instrumentation::Statistics> Instrumentation::getTimeStatistics() const {
+	lock_guard<mutex> lock(access);
+	return computeStatistics(&Snapshot::times);
+}
+
+map<string, Instrumentation::Statistics> Instrumentation::getCountStatistics() const {
+	lock_guard<mutex> lock(access);
+	return computeStatistics(&Snapshot::counts);
+}
+
+void Instrumentation::setWindowSize(size_t frameCount) {
+	lock_guard<mutex> lock(access);
+	windowSize = std::max(frameCount, static_cast<size_t>(1));
+	while (frames.size() > windowSize)
+		frames.pop_front();
+}
+
+void Instrumentation::setTracing(bool enabled, size_t maxEventCount) {
+	lock_guard<mutex> lock(access);
+	tracing = enabled;
+	this->maxEventCount = maxEventCount;
+}
+
+void Instrumentation::clear() {
+	lock_guard<mutex> lock(access);
+	origin = Clock::now();
+	currentFrame = 0;
+	frames.clear();
+	for (const shared_ptr<ThreadData>& data : threads) {
+		lock_guard<mutex> threadLock(data->access);
+		data->times.clear();
+		data->counts.clear();
+		data->events.clear();
+	}
+	eventCount = 0;
+	events.clear();
+}
+
+Instrumentation::ThreadData& Instrumentation::getThreadData() {
+	// the data is shared with the registry, so the values of finished threads are still merged
+	thread_local shared_ptr<ThreadData> data;
+	if (!data) {
+		data = std::make_shared<ThreadData>();
+		lock_guard<mutex> lock(access);
+		data->thread = threadCount++;
+		threads.push_back(data);
+	}
+	return *data;
+}
+
+void Instrumentation::merge(unordered_map<const char*, Sum>& sums, map<string, double>& values) {
+	// the entries are reset instead of removed, so the maps do not allocate in the steady state
+	for (auto& namedSum : sums) {
+		Sum& sum = namedSum.second;
+		if (sum.added)
+			values[namedSum.first] += sum.value;
+		sum = Sum{0, false};
+	}
+}
+
+map<string, Instrumentation::Statistics> Instrumentation::computeStatistics(map<string, double> Snapshot::*values) const {
+	map<string, vector<double>> valuesByName;
+	for (const Snapshot& frame : frames) {
+		for (const auto& value : frame.*values)
+			valuesByName[value.first];
+	}
+	for (const Snapshot& frame : frames) {
+		for (auto& namedValues : valuesByName) {
+			auto value = (frame.*values).find(namedValues.first);
+			namedValues.second.push_back(value == (frame.*values).end() ? 0.0 : value->second);
+		}
+	}
+	map<string, Statistics> statistics;
+	for (auto& namedValues : valuesByName) {
+		vector<double>& sortedValues = namedValues.second;
+		std::sort(sortedValues.begin(), sortedValues.end());
+		auto percentile = [&sortedValues](double p) { // nearest rank
+			size_t rank = static_cast<size_t>(std::ceil(p * sortedValues.size()));
+			return sortedValues[std::max(rank, static_cast<size_t>(1)) - 1];
+		};
+		double sum = 0;
+		for (double value : sortedValues)
+			sum += value;
+		statistics[namedValues.first] = Statistics{percentile(0.5), percentile(0.99), sum / sortedValues.size(), sortedValues.back()};
+	}
+	return statistics;
+}
+
+string Instrumentation::getDisplayName(const string& name) {
+#ifdef __GNUG__
+	if (!name.empty() && name[0] == 'N') { // mangled type name, e.g. reported by ChainedFilter
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+		if (status == 0 && demangled) {
+			string displayName(demangled);
+			std::free(demangled);
+			return displayName;
+		}
+		std::free(demangled);
+	}
+#endif
+	return name;
+}
+
+void Instrumentation::writeJson(ostream& stream) const {
+	lock_guard<mutex> lock(access);
+	stream << std::fixed << std::setprecision(3);
+	stream << "{" << endl;
+	stream << "  \"frames\": " << (frames.empty() ? 0 : frames.back().frame + 1) << "," << endl;
+	stream << "  \"window\": " << frames.size() << "," << endl;
+	stream << "  \"time_unit\": \"ms\"," << endl;
+	stream << "  \"last_frame\": {" << endl;
+	stream << "    \"times\": {";
+	if (!frames.empty()) {
+		bool first = true;
+		for (const auto& time : frames.back().times) {
+			stream << (first ? "" : ", ") << "\"" << getDisplayName(time.first) << "\": " << time.second;
+			first = false;
+		}
+	}
+	stream << "}," << endl;
+	stream << "    \"counts\": {";
+	if (!frames.empty()) {
+		bool first = true;
+		for (const auto& count : frames.back().counts) {
+			stream << (first ? "" : ", ") << "\"" << getDisplayName(count.first) << "\": " << count.second;
+			first = false;
+		}
+	}
+	stream << "}" << endl;
+	stream << "  }," << endl;
+	stream << "  \"times\": ";
+	writeJson(stream, computeStatistics(&Snapshot::times));
+	stream << "," << endl;
+	stream << "  \"counts\": ";
+	writeJson(stream, computeStatistics(&Snapshot::counts));
+	stream << endl << "}" << endl;
+}
+
+void Instrumentation::writeJson(ostream& stream, const map<string, Statistics>& statistics) {
+	stream << "{";
+	bool first = true;
+	for (const auto& namedStatistics : statistics) {
+		const Statistics& values = namedStatistics.second;
+		stream << (first ? "" : ",") << endl;
+		stream << "    \"" << getDisplayName(namedStatistics.first) << "\": {\"p50\": " << values.p50 << ", \"p99\": " << values.p99
+				<< ", \"mean\": " << values.mean << ", \"max\": " << values.max << "}";
+		first = false;
+	}
+	stream << endl << "  }";
+}
+
+void Instrumentation::writeChromeTrace(ostream& stream) const {
+	lock_guard<mutex> lock(access);
+	vector<TraceEvent> allEvents = events;
+	for (const shared_ptr<ThreadData>& data : threads) { // events of the current frame
+		lock_guard<mutex> threadLock(data->access);
+		allEvents.insert(allEvents.end(), data->events.begin(), data->events.end());
+	}
+	stream << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+	for (size_t i = 0; i < allEvents.size(); ++i) {
+		const TraceEvent& event = allEvents[i];
+		long long start = duration_cast<microseconds>(event.start - origin).count();
+		stream << (i == 0 ? "" : ",") << endl;
+		if (event.name) {
+			long long length = duration_cast<microseconds>(event.end - event.start).count();
+			stream << "{\"name\": \"" << getDisplayName(event.name) << "\", \"ph\": \"X\", \"ts\": " << start
+					<< ", \"dur\": " << length << ", \"pid\": 0, \"tid\": " << event.thread << "}";
+		} else {
+			stream << "{\"name\": \"frame\", \"ph\": \"i\", \"s\": \"g\", \"ts\": " << start
+					<< ", \"pid\": 0, \"tid\": " << event.thread << "}";
+		}
+	}
+	stream << endl << "]}" << endl;
+}
+
+const char* Instrumentation::getCurrentStage() {
+	return currentStage;
+}
+
+const char* Instrumentation::setCurrentStage(const char* name) {
+	const char* previousStage = currentStage;
+	currentStage = name;
+	return previousStage;
+}
+
+} /* namespace imageprocessing */
@@ -0,0 +1,179 @@
+/*
+ * MappedImagePyramidStore.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "filemapping/MappedFile.hpp"
+#include "imageprocessing/ImagePyramidLayer.hpp"
+#include "imageprocessing/MappedImagePyramidStore.hpp"
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/filesystem.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+using cv::Mat;
+using filemapping::MappedFile;
+using std::make_shared;
+using std::runtime_error;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace imageprocessing {
+
+namespace {
+
+const char pyramidMagic[8] = {'P', 'Y', 'R', 'A', 'M', 'I', 'D', '1'}; ///< First bytes of pyramid files.
+const uint32_t pyramidVersion = 1; ///< Current version of the format.
+const uint32_t pyramidByteOrder = 0x01020304; ///< Marker for detecting files with a different byte order.
+const uint64_t pyramidAlignment = 64; ///< Alignment of the layer data.
+
+/**
+ * Header at the beginning of pyramid files, followed by the layer headers.
+ */
+struct PyramidHeader {
+	char magic[8]; ///< Magic number, see pyramidMagic.
+	uint32_t version; ///< Version of the format.
+	uint32_t byteOrder; ///< Byte order marker, see pyramidByteOrder.
+	int32_t octaveLayerCount; ///< Number of layers per octave.
+	uint32_t layerCount; ///< Number of layers.
+	uint64_t fileSize; ///< Size of the whole file in bytes.
+};
+
+/**
+ * Description of a pyramid layer whose (continuous) data is located at an aligned offset of the file.
+ */
+struct LayerHeader {
+	int32_t index; ///< Index of the layer.
+	int32_t rows; ///< Row count of the layer image.
+	int32_t cols; ///< Column count of the layer image.
+	int32_t type; ///< Type of the layer image.
+	double scaleFactor; ///< Theoretical scale factor of the layer.
+	double widthScaleFactor; ///< Actual scale factor of the image width.
+	double heightScaleFactor; ///< Actual scale factor of the image height.
+	uint64_t offset; ///< Offset of the layer data in bytes.
+};
+
+uint64_t alignOffset(uint64_t offset) {
+	return (offset + pyramidAlignment - 1) / pyramidAlignment * pyramidAlignment;
+}
+
+string hashConfiguration(const string& configuration) {
+	uint64_t hash = 14695981039346656037ull;
+	for (unsigned char c : configuration)
+		hash = (hash ^ c) * 1099511628211ull;
+	std::ostringstream stream;
+	stream << std::hex << std::setfill('0') << std::setw(16) << hash;
+	return stream.str();
+}
+
+} // namespace
+
+MappedImagePyramidStore::MappedImagePyramidStore(const string& directory, const string& configuration) :
+		directory((boost::filesystem::path(directory) / hashConfiguration(configuration)).string()) {
+	boost::filesystem::path path(this->directory);
+	if (!boost::filesystem::exists(path)) {
+		boost::filesystem::create_directories(path);
+		std::ofstream stream((path / "configuration").string());
+		stream << configuration;
+	} else if (!boost::filesystem::is_directory(path)) {
+		throw runtime_error("MappedImagePyramidStore: '" + this->directory + "' is no directory");
+	}
+}
+
+string MappedImagePyramidStore::getFilename(const string& key) const {
+	return (boost::filesystem::path(directory) / (key + ".pyramid")).string();
+}
+
+shared_ptr<ImagePyramid> MappedImagePyramidStore::load(const string& key) {
+	string filename = getFilename(key);
+	if (!boost::filesystem::exists(filename))
+		return shared_ptr<ImagePyramid>();
+	shared_ptr<const MappedFile> mapping = make_shared<MappedFile>(filename);
+	PyramidHeader header;
+	if (mapping->size() < sizeof(header))
+		return shared_ptr<ImagePyramid>();
+	std::memcpy(&header, mapping->data(), sizeof(header));
+	if (std::memcmp(header.magic, pyramidMagic, sizeof(header.magic)) != 0
+			|| header.version != pyramidVersion
+			|| header.byteOrder != pyramidByteOrder
+			|| header.fileSize != mapping->size()
+			|| sizeof(header) + header.layerCount * sizeof(LayerHeader) > header.fileSize)
+		return shared_ptr<ImagePyramid>(); // unusable files are replaced by storing the pyramid again
+	vector<shared_ptr<ImagePyramidLayer>> layers;
+	layers.reserve(header.layerCount);
+	for (uint32_t i = 0; i < header.layerCount; ++i) {
+		LayerHeader layerHeader;
+		std::memcpy(&layerHeader, mapping->data() + sizeof(header) + i * sizeof(LayerHeader), sizeof(layerHeader));
+		uint64_t layerSize = static_cast<uint64_t>(layerHeader.rows) * layerHeader.cols * CV_ELEM_SIZE(layerHeader.type);
+		if (layerHeader.rows < 0 || layerHeader.cols < 0 || layerHeader.offset + layerSize > header.fileSize)
+			return shared_ptr<ImagePyramid>();
+		Mat image(layerHeader.rows, layerHeader.cols, layerHeader.type, const_cast<unsigned char*>(mapping->data() + layerHeader.offset));
+		// each layer keeps the mapping alive, as layers might be shared with other pyramids
+		layers.push_back(shared_ptr<ImagePyramidLayer>(new ImagePyramidLayer(layerHeader.index, layerHeader.scaleFactor,
+				layerHeader.widthScaleFactor, layerHeader.heightScaleFactor, image), [mapping](ImagePyramidLayer* layer) {
+			delete layer;
+		}));
+	}
+	return make_shared<ImagePyramid>(header.octaveLayerCount, layers);
+}
+
+void MappedImagePyramidStore::store(const string& key, const ImagePyramid& pyramid) {
+	const vector<shared_ptr<ImagePyramidLayer>>& layers = pyramid.getLayers();
+	PyramidHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, pyramidMagic, sizeof(header.magic));
+	header.version = pyramidVersion;
+	header.byteOrder = pyramidByteOrder;
+	header.octaveLayerCount = pyramid.getOctaveLayerCount();
+	header.layerCount = static_cast<uint32_t>(layers.size());
+	vector<LayerHeader> layerHeaders(layers.size());
+	uint64_t offset = sizeof(header) + layers.size() * sizeof(LayerHeader);
+	for (size_t i = 0; i < layers.size(); ++i) {
+		const Mat& image = layers[i]->getScaledImage();
+		LayerHeader& layerHeader = layerHeaders[i];
+		std::memset(&layerHeader, 0, sizeof(layerHeader));
+		layerHeader.index = layers[i]->getIndex();
+		layerHeader.rows = image.rows;
+		layerHeader.cols = image.cols;
+		layerHeader.type = image.type();
+		layerHeader.scaleFactor = layers[i]->getScaleFactor();
+		layerHeader.widthScaleFactor = layers[i]->getWidthScaleFactor();
+		layerHeader.heightScaleFactor = layers[i]->getHeightScaleFactor();
+		layerHeader.offset = alignOffset(offset);
+		offset = layerHeader.offset + image.total() * image.elemSize();
+	}
+	header.fileSize = offset;
+
+	// write into a temporary file first, so concurrent readers never see an incomplete pyramid
+	std::ostringstream temporaryFilename;
+	temporaryFilename << getFilename(key) << '.' << std::this_thread::get_id() << ".tmp";
+	std::ofstream file(temporaryFilename.str(), std::ios::binary);
+	if (!file)
+		throw runtime_error("MappedImagePyramidStore: cannot write into file '" + temporaryFilename.str() + "'");
+	const char padding[pyramidAlignment] = {};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(layerHeaders.data()), layerHeaders.size() * sizeof(LayerHeader));
+	for (size_t i = 0; i < layers.size(); ++i) {
+		file.write(padding, layerHeaders[i].offset - static_cast<uint64_t>(file.tellp()));
+		const Mat& image = layers[i]->getScaledImage();
+		Mat continuousImage = image.isContinuous() ? image : image.clone();
+		file.write(reinterpret_cast<const char*>(continuousImage.data), continuousImage.total() * continuousImage.elemSize());
+	}
+	file.close();
+	if (!file)
+		throw runtime_error("MappedImagePyramidStore: cannot write into file '" + temporaryFilename.str() + "'");
+	boost::filesystem::rename(temporaryFilename.str(), getFilename(key));
+}
+
+} /* namespace imageprocessing */
@@ -9,7 +9,7 @@
 
 namespace imageprocessing {
 
-int Version::nextInstance = 0;
+std::atomic<int> Version::nextInstance(0);
 
 std::ostream& operator<<(std::ostream& out, const Version& version) {
 	return out << version.instance << ":" << version.version;
@@ -7,6 +7,7 @@
 
 #include "imageprocessing/extraction/AggregatedFeaturesExtractor.hpp"
 #include "imageprocessing/ImagePyramidLayer.hpp"
+#include <limits>
 
 using cv::Mat;
 using cv::Point;
@@ -28,7 +29,9 @@ AggregatedFeaturesExtractor::AggregatedFeaturesExtractor(shared_ptr<ImagePyramid
 				patchSizeInPixels(patchSizeInCells * cellSizeInPixels),
 				cellSizeInPixels(cellSizeInPixels),
 				adjustMinScaleFactor(adjustMinScaleFactor),
-				minScaleFactor(maxPatchWidthInPixels > 0 ? getMinScaleFactor(maxPatchWidthInPixels) : 0) {
+				minScaleFactor(maxPatchWidthInPixels > 0 ? getMinScaleFactor(maxPatchWidthInPixels) : 0),
+				ownFeaturePyramid(),
+				pyramidCache() {
 	if (minPatchWidthInPixels > patchSizeInPixels.width)
 		featurePyramid->setMaxScaleFactor(getMaxScaleFactor(minPatchWidthInPixels));
 	if (maxPatchWidthInPixels > 0)
@@ -67,7 +70,28 @@ shared_ptr<ImagePyramid> AggregatedFeaturesExtractor::getFeaturePyramid() {
 	return featurePyramid;
 }
 
+void AggregatedFeaturesExtractor::setPyramidCache(shared_ptr<ImagePyramidCache> cache) {
+	if (cache && !pyramidCache) {
+		ownFeaturePyramid = featurePyramid;
+		// view without filters and minimum scale factor that shares the layers of the cached pyramids
+		featurePyramid = make_shared<ImagePyramid>(ownFeaturePyramid,
+				std::numeric_limits<double>::min(), ownFeaturePyramid->getMaxScaleFactor());
+	} else if (!cache && pyramidCache) {
+		featurePyramid = ownFeaturePyramid;
+		ownFeaturePyramid.reset();
+	}
+	pyramidCache = cache;
+}
+
 void AggregatedFeaturesExtractor::update(shared_ptr<VersionedImage> image) {
+	if (pyramidCache) {
+		double pyramidMinScaleFactor = adjustMinScaleFactor
+				? std::max(minScaleFactor, getMinScaleFactor(image->getData()))
+				: ownFeaturePyramid->getMinScaleFactor();
+		featurePyramid->setSource(pyramidCache->get(image->getData(), pyramidMinScaleFactor));
+		featurePyramid->update();
+		return;
+	}
 	if (adjustMinScaleFactor)
 		featurePyramid->setMinScaleFactor(std::max(minScaleFactor, getMinScaleFactor(image->getData())));
 	featurePyramid->update(image);
@@ -94,12 +118,37 @@ shared_ptr<Patch> AggregatedFeaturesExtractor::extract(int centerX, int centerY,
 }
 
 shared_ptr<Patch> AggregatedFeaturesExtractor::extract(Rect bounds) const {
+	return extract(bounds, true);
+}
+
+shared_ptr<Patch> AggregatedFeaturesExtractor::extractView(Rect bounds) const {
+	return extract(bounds, false);
+}
+
+bool AggregatedFeaturesExtractor::extractView(Rect bounds, PatchView& view) const {
 	const shared_ptr<ImagePyramidLayer> layer = getLayer(bounds.width);
 	if (!layer)
-		return shared_ptr<Patch>();
+		return false;
 	Point_<double> centerInImagePixels(bounds.x + 0.5 * bounds.width, bounds.y + 0.5 * bounds.height);
 	Point centerInLayerCells = computePointInLayerCells(centerInImagePixels, *layer);
-	return extract(*layer, Patch::computeBounds(centerInLayerCells, patchSizeInCells));
+	Rect boundsInLayerCells = Patch::computeBounds(centerInLayerCells, patchSizeInCells);
+	const Mat& layerCellImage = layer->getScaledImage();
+	if (!isPatchWithinImage(boundsInLayerCells, layerCellImage))
+		return false;
+	Rect boundsInImagePixels = computeBoundsInImagePixels(boundsInLayerCells, *layer);
+	view = PatchView(boundsInImagePixels, Mat(layerCellImage, boundsInLayerCells), featurePyramid->getVersion());
+	return true;
+}
+
+bool AggregatedFeaturesExtractor::isValid(const PatchView& view) const {
+	return view.getVersion() == featurePyramid->getVersion();
+}
+
+shared_ptr<Patch> AggregatedFeaturesExtractor::extract(Rect bounds, bool copyData) const {
+	PatchView view;
+	if (!extractView(bounds, view))
+		return shared_ptr<Patch>();
+	return make_shared<Patch>(view.getBounds(), copyData ? view.getData().clone() : view.getData());
 }
 
 const shared_ptr<ImagePyramidLayer> AggregatedFeaturesExtractor::getLayer(int width) const {
@@ -114,15 +163,6 @@ Point AggregatedFeaturesExtractor::computePointInLayerCells(Point_<double> point
 	);
 }
 
-shared_ptr<Patch> AggregatedFeaturesExtractor::extract(const ImagePyramidLayer& layer, Rect boundsInLayerCells) const {
-	const Mat& layerCellImage = layer.getScaledImage();
-	if (!isPatchWithinImage(boundsInLayerCells, layerCellImage))
-		return shared_ptr<Patch>();
-	Mat data(layerCellImage, boundsInLayerCells);
-	Rect boundsInImagePixels = computeBoundsInImagePixels(boundsInLayerCells, layer);
-	return make_shared<Patch>(boundsInImagePixels, data.clone());
-}
-
 bool AggregatedFeaturesExtractor::isPatchWithinImage(Rect bounds, const Mat& image) const {
 	return bounds.x >= 0
 			&& bounds.y >= 0
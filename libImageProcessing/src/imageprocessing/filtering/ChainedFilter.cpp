@@ -6,6 +6,8 @@
  */
 
 #include "imageprocessing/filtering/ChainedFilter.hpp"
+#include "imageprocessing/Instrumentation.hpp"
+#include <typeinfo>
 
 using cv::Mat;
 using std::vector;
@@ -38,16 +40,23 @@ Mat ChainedFilter::applyTo(const Mat &image, Mat &filtered) const {
 	if (filters.empty()) {
 		image.copyTo(filtered);
 	} else {
-		filters[0]->applyTo(image, filtered);
-		for (unsigned int i = 1; i < filters.size(); ++i)
+		{
+			INSTRUMENT_SCOPE(typeid(*filters[0]).name()); // the filters are reported by their (mangled) type names
+			filters[0]->applyTo(image, filtered);
+		}
+		for (unsigned int i = 1; i < filters.size(); ++i) {
+			INSTRUMENT_SCOPE(typeid(*filters[i]).name());
 			filters[i]->applyInPlace(filtered);
+		}
 	}
 	return filtered;
 }
 
 void ChainedFilter::applyInPlace(Mat& image) const {
-	for (unsigned int i = 0; i < filters.size(); ++i)
+	for (unsigned int i = 0; i < filters.size(); ++i) {
+		INSTRUMENT_SCOPE(typeid(*filters[i]).name());
 		filters[i]->applyInPlace(image);
+	}
 }
 
 } /* namespace filtering */
@@ -17,11 +17,16 @@
 
 namespace libsvm {
 
+/**
+ * Data of a libSVM training. The nodes refer to the training examples where possible, so the examples must
+ * outlive the data.
+ */
 struct LibSvmData {
-	std::vector<std::unique_ptr<struct svm_node, NodeDeleter>> positiveExamples;
-	std::vector<std::unique_ptr<struct svm_node, NodeDeleter>> negativeExamples;
-	std::unique_ptr<struct svm_problem, ProblemDeleter> problem;
-	std::unique_ptr<struct svm_model, ModelDeleter> model;
+	std::vector<struct svm_node> nodes; ///< Nodes of the positive and negative training examples (in that order).
+	std::vector<std::unique_ptr<svm_value[]>> copiedValues; ///< Values of the nodes that could not refer to the training examples.
+	std::vector<double> labels; ///< Labels of the training examples.
+	std::unique_ptr<struct svm_problem> problem; ///< libSVM problem that refers to the nodes and labels.
+	std::unique_ptr<struct svm_model, ModelDeleter> model; ///< Trained libSVM model.
 };
 
 /**
@@ -37,8 +42,13 @@ public:
 	 *
 	 * @param[in] c Soft margin parameter.
 	 * @param[in] compensateImbalance Flag that indicates whether to adjust class weights to compensate for unbalanced data.
+	 * @param[in] cacheSize Size of the kernel cache in MB.
 	 */
-	LibSvmTrainer(double c, bool compensateImbalance);
+	LibSvmTrainer(double c, bool compensateImbalance, double cacheSize = 100);
+
+	using classification::ClassifierTrainer<classification::SupportVectorMachine>::train;
+
+	using classification::ClassifierTrainer<classification::ProbabilisticSupportVectorMachine>::train;
 
 	void train(classification::SupportVectorMachine& svm,
 			const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const override;
@@ -61,23 +71,13 @@ private:
 			const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const;
 
 	/**
-	 * Creates libSVM nodes from training examples.
-	 *
-	 * @param[in] examples Training examples.
-	 * @return Vector of libSVM nodes.
-	 */
-	std::vector<std::unique_ptr<struct svm_node, NodeDeleter>> createNodes(const std::vector<cv::Mat>& examples) const;
-
-	/**
-	 * Creates the libSVM problem containing the training data.
+	 * Creates the libSVM problem containing the training data without copying the training examples if possible.
 	 *
-	 * @param[in] positiveExamples Positive training examples.
-	 * @param[in] negativeExamples Negative training examples.
-	 * @return The libSVM problem.
+	 * @param[in,out] data Training data that receives the nodes, labels, and problem.
+	 * @param[in] positives Positive training examples.
+	 * @param[in] negatives Negative training examples.
 	 */
-	std::unique_ptr<struct svm_problem, ProblemDeleter> createProblem(
-			const std::vector<std::unique_ptr<struct svm_node, NodeDeleter>>& positiveExamples,
-			const std::vector<std::unique_ptr<struct svm_node, NodeDeleter>>& negativeExamples) const;
+	void createProblem(LibSvmData& data, const std::vector<cv::Mat>& positives, const std::vector<cv::Mat>& negatives) const;
 
 	/**
 	 * Sets parameters of the SVM according to the model.
@@ -68,6 +68,17 @@ public:
 	 */
 	std::unique_ptr<struct svm_node, NodeDeleter> createNode(const cv::Mat& vector) const;
 
+	/**
+	 * Initializes a libSVM node from the given feature vector data. If the vector is continuous and its depth
+	 * matches the libSVM value type, then the node refers to the vector data directly. Otherwise, the values are
+	 * copied into a newly allocated buffer.
+	 *
+	 * @param[out] node The libSVM node that must not outlive the feature vector or the buffer.
+	 * @param[in] vector The feature vector.
+	 * @param[out] buffer The buffer containing the copied values, empty if the node refers to the vector data.
+	 */
+	void initNode(struct svm_node& node, const cv::Mat& vector, std::unique_ptr<svm_value[]>& buffer) const;
+
 	/**
 	 * Creates a vector to the given libSVM node.
 	 *
@@ -138,11 +149,20 @@ public:
 private:
 
 	/**
-	 * Fills a libSVM node with the data of a feature vector.
+	 * Remembers the shape and type of the feature vectors and ensures their depth is supported.
+	 *
+	 * @param[in] vector The feature vector.
+	 */
+	void setMatProperties(const cv::Mat& vector) const;
+
+	/**
+	 * Copies the values of a feature vector into the node.
 	 *
-	 * @param[in,out] node The libSVM node.
+	 * @param[in,out] node The libSVM node whose values are set.
 	 * @param[in] vector The feature vector.
 	 */
+	void fillNode(struct svm_node& node, const cv::Mat& vector) const;
+
 	template<class T>
 	void fillNode(struct svm_node& node, const cv::Mat& vector) const;
 
@@ -11,11 +11,20 @@ extern int libsvm_version;
 
 #define _DENSE_REP
 
+/* store the dense values in single precision, so nodes can refer to float data directly */
+#define _FLOAT_DENSE_REP
+
 #ifdef _DENSE_REP
+#ifdef _FLOAT_DENSE_REP
+typedef float svm_value;
+#else
+typedef double svm_value;
+#endif
+
 struct svm_node
 {
 	int dim;
-	double *values;
+	svm_value *values;
 };
 
 struct svm_problem
@@ -21,9 +21,11 @@ using std::vector;
 
 namespace libsvm {
 
-LibSvmTrainer::LibSvmTrainer(double c, bool compensateImbalance) : utils(), param() {
+LibSvmTrainer::LibSvmTrainer(double c, bool compensateImbalance, double cacheSize) : utils(), param() {
+	if (cacheSize <= 0)
+		throw invalid_argument("LibSvmTrainer: the cache size must be greater than zero");
 	param.reset(new struct svm_parameter);
-	param->cache_size = 100;
+	param->cache_size = cacheSize;
 	param->eps = 1e-4;
 	param->C = c;
 	param->svm_type = C_SVC;
@@ -63,15 +65,13 @@ LibSvmData LibSvmTrainer::train(const Kernel& kernel, bool probabilistic,
 	utils.setKernelParams(kernel, param.get());
 	param->probability = probabilistic ? 1 : 0;
 	LibSvmData data;
-	data.positiveExamples = move(createNodes(positives));
-	data.negativeExamples = move(createNodes(negatives));
+	createProblem(data, positives, negatives);
 	if (param->nr_weight == 2) { // compensate for imbalance in data
-		double positiveCount = data.positiveExamples.size();
-		double negativeCount = data.negativeExamples.size();
+		double positiveCount = positives.size();
+		double negativeCount = negatives.size();
 		param->weight[0] = negativeCount / positiveCount;
 		param->weight[1] = positiveCount / negativeCount;
 	}
-	data.problem = move(createProblem(data.positiveExamples, data.negativeExamples));
 	const char* message = svm_check_parameter(data.problem.get(), param.get());
 	if (message != 0)
 		throw invalid_argument(string("LibSvmTrainer: invalid SVM parameters: ") + message);
@@ -79,38 +79,30 @@ LibSvmData LibSvmTrainer::train(const Kernel& kernel, bool probabilistic,
 	return data;
 }
 
-vector<unique_ptr<struct svm_node, NodeDeleter>> LibSvmTrainer::createNodes(const vector<Mat>& examples) const {
-	vector<unique_ptr<struct svm_node, NodeDeleter>> nodes;
-	nodes.reserve(examples.size());
-	for (const Mat& example : examples)
-		nodes.push_back(move(utils.createNode(example)));
-	return move(nodes);
-}
-
-unique_ptr<struct svm_problem, ProblemDeleter> LibSvmTrainer::createProblem(
-		const vector<unique_ptr<struct svm_node, NodeDeleter>>& positiveExamples,
-		const vector<unique_ptr<struct svm_node, NodeDeleter>>& negativeExamples) const {
-	unique_ptr<struct svm_problem, ProblemDeleter> problem(new struct svm_problem);
-	problem->l = positiveExamples.size() + negativeExamples.size();
-	problem->y = new double[problem->l];
-	problem->x = new struct svm_node[problem->l];
+void LibSvmTrainer::createProblem(LibSvmData& data, const vector<Mat>& positives, const vector<Mat>& negatives) const {
+	size_t count = positives.size() + negatives.size();
+	data.nodes.resize(count);
+	data.copiedValues.resize(count);
+	data.labels.resize(count);
 	size_t i = 0;
-	for (auto& example : positiveExamples) {
-		problem->y[i] = 1;
-		problem->x[i] = *example;
+	for (const Mat& example : positives) {
+		utils.initNode(data.nodes[i], example, data.copiedValues[i]);
+		data.labels[i] = 1;
 		++i;
 	}
-	for (auto& example : negativeExamples) {
-		problem->y[i] = -1;
-		problem->x[i] = *example;
+	for (const Mat& example : negatives) {
+		utils.initNode(data.nodes[i], example, data.copiedValues[i]);
+		data.labels[i] = -1;
 		++i;
 	}
-	return move(problem);
+	data.problem.reset(new struct svm_problem);
+	data.problem->l = count;
+	data.problem->y = data.labels.data();
+	data.problem->x = data.nodes.data();
 }
 
 void LibSvmTrainer::setSvmParameters(SupportVectorMachine& svm, const struct svm_model* model) const {
-	svm.setSupportVectors(utils.extractSupportVectors(model));
-	svm.setCoefficients(utils.extractCoefficients(model));
+	svm.setSupportVectorsAndCoefficients(utils.extractSupportVectors(model), utils.extractCoefficients(model));
 	svm.setBias(utils.extractBias(model));
 }
 
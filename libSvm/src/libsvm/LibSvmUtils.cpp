@@ -25,31 +25,54 @@ LibSvmUtils::LibSvmUtils() :
 LibSvmUtils::~LibSvmUtils() {}
 
 unique_ptr<struct svm_node, NodeDeleter> LibSvmUtils::createNode(const Mat& vector) const {
+	setMatProperties(vector);
+	unique_ptr<struct svm_node, NodeDeleter> node(new struct svm_node);
+	node->dim = vector.total() * vector.channels();
+	node->values = new svm_value[node->dim];
+	fillNode(*node, vector);
+	return move(node);
+}
+
+void LibSvmUtils::initNode(struct svm_node& node, const Mat& vector, unique_ptr<svm_value[]>& buffer) const {
+	setMatProperties(vector);
+	node.dim = vector.total() * vector.channels();
+	if (vector.isContinuous() && vector.depth() == cv::DataType<svm_value>::depth) {
+		node.values = const_cast<svm_value*>(vector.ptr<svm_value>());
+		buffer.reset();
+	} else {
+		buffer.reset(new svm_value[node.dim]);
+		node.values = buffer.get();
+		fillNode(node, vector);
+	}
+}
+
+void LibSvmUtils::setMatProperties(const Mat& vector) const {
 	matRows = vector.rows;
 	matCols = vector.cols;
 	matType = vector.type();
 	matDepth = vector.depth();
 	if (matDepth != CV_8U && matDepth != CV_32F && matDepth != CV_64F)
 		throw invalid_argument("LibSvmUtils: vector has to be of depth CV_8U, CV_32F, or CV_64F to create a node of");
-	unique_ptr<struct svm_node, NodeDeleter> node(new struct svm_node);
-	node->dim = vector.total() * vector.channels();
-	node->values = new double[node->dim];
+}
+
+void LibSvmUtils::fillNode(struct svm_node& node, const Mat& vector) const {
 	if (matDepth == CV_8U)
-		fillNode<uchar>(*node, vector);
+		fillNode<uchar>(node, vector);
 	else if (matDepth == CV_32F)
-		fillNode<float>(*node, vector);
+		fillNode<float>(node, vector);
 	else if (matDepth == CV_64F)
-		fillNode<double>(*node, vector);
-	return move(node);
+		fillNode<double>(node, vector);
 }
 
 template<class T>
 void LibSvmUtils::fillNode(struct svm_node& node, const Mat& vector) const {
-	if (!vector.isContinuous())
-		throw invalid_argument("LibSvmUtils: vector has to be continuous");
-	const T* values = vector.ptr<T>();
-	for (int i = 0; i < node.dim; ++i)
-		node.values[i] = values[i];
+	int rowSize = vector.cols * vector.channels();
+	svm_value* nodeValues = node.values;
+	for (int row = 0; row < vector.rows; ++row) {
+		const T* values = vector.ptr<T>(row);
+		for (int i = 0; i < rowSize; ++i)
+			*(nodeValues++) = static_cast<svm_value>(values[i]);
+	}
 }
 
 Mat LibSvmUtils::createVector(const struct svm_node& node) const {
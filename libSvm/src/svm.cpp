@@ -10,6 +10,8 @@
 #include "svm.h"
 int libsvm_version = LIBSVM_VERSION;
 typedef float Qfloat;
+// minimum number of kernel values that are computed in parallel (if compiled with OpenMP)
+#define PARALLEL_COLUMN_LENGTH 256
 typedef signed char schar;
 #ifndef min
 template <class T> static inline T min(T x,T y) { return (x<y)?x:y; }
@@ -34,6 +36,38 @@ static inline double powi(double base, int times)
 	}
 	return ret;
 }
+#ifdef _DENSE_REP
+// dense loops over the node values, written to be vectorized by the compiler
+static inline double dense_dot(const svm_value *px, const svm_value *py, int dim)
+{
+	double sum = 0;
+#pragma omp simd reduction(+:sum)
+	for (int i = 0; i < dim; i++)
+		sum += (double)px[i] * (double)py[i];
+	return sum;
+}
+
+static inline double dense_squared_distance(const svm_value *px, const svm_value *py, int dim)
+{
+	double sum = 0;
+#pragma omp simd reduction(+:sum)
+	for (int i = 0; i < dim; i++)
+	{
+		double d = (double)px[i] - (double)py[i];
+		sum += d*d;
+	}
+	return sum;
+}
+
+static inline double dense_min_sum(const svm_value *px, const svm_value *py, int dim)
+{
+	double sum = 0;
+#pragma omp simd reduction(+:sum)
+	for (int i = 0; i < dim; i++)
+		sum += (double)(px[i] < py[i] ? px[i] : py[i]);
+	return sum;
+}
+#endif
 #define INF HUGE_VAL
 #define TAU 1e-12
 #define Malloc(type,n) (type *)malloc((n)*sizeof(type))
@@ -268,9 +302,7 @@ private:
 	{
 		double minSum = 0;
 #ifdef _DENSE_REP
-		int dim = min(x[i].dim, x[j].dim);
-		for (int k = 0; k < dim; k++)
-			minSum += min<double>(x[i].values[k], x[j].values[k]);
+		minSum = dense_min_sum(x[i].values, x[j].values, min(x[i].dim, x[j].dim));
 #else
 		const svm_node *px = x[i];
 		const svm_node *py = x[j];
@@ -330,6 +362,7 @@ Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param)
 	if(kernel_type == RBF)
 	{
 		x_square = new double[l];
+#pragma omp parallel for schedule(static)
 		for(int i=0;i<l;i++)
 			x_square[i] = dot(x[i],x[i]);
 	}
@@ -346,22 +379,12 @@ Kernel::~Kernel()
 #ifdef _DENSE_REP
 double Kernel::dot(const svm_node *px, const svm_node *py)
 {
-	double sum = 0;
-
-	int dim = min(px->dim, py->dim);
-	for (int i = 0; i < dim; i++)
-		sum += (px->values)[i] * (py->values)[i];
-	return sum;
+	return dense_dot(px->values, py->values, min(px->dim, py->dim));
 }
 
 double Kernel::dot(const svm_node &px, const svm_node &py)
 {
-	double sum = 0;
-
-	int dim = min(px.dim, py.dim);
-	for (int i = 0; i < dim; i++)
-		sum += px.values[i] * py.values[i];
-	return sum;
+	return dense_dot(px.values, py.values, min(px.dim, py.dim));
 }
 #else
 double Kernel::dot(const svm_node *px, const svm_node *py)
@@ -400,12 +423,8 @@ double Kernel::k_function(const svm_node *x, const svm_node *y,
 		{
 			double sum = 0;
 #ifdef _DENSE_REP
-			int dim = min(x->dim, y->dim), i;
-			for (i = 0; i < dim; i++)
-			{
-				double d = x->values[i] - y->values[i];
-				sum += d*d;
-			}
+			int dim = min(x->dim, y->dim), i = dim;
+			sum = dense_squared_distance(x->values, y->values, dim);
 			for (; i < x->dim; i++)
 				sum += x->values[i] * x->values[i];
 			for (; i < y->dim; i++)
@@ -461,9 +480,7 @@ double Kernel::k_function(const svm_node *x, const svm_node *y,
 		{
 			double minSum = 0;
 #ifdef _DENSE_REP
-			int dim = min(x->dim, y->dim);
-			for (int i = 0; i < dim; i++)
-				minSum += min<double>(x->values[i], y->values[i]);
+			minSum = dense_min_sum(x->values, y->values, min(x->dim, y->dim));
 #else
 			while(x->index != -1 && y->index != -1)
 			{
@@ -1389,6 +1406,7 @@ public:
 		clone(y,y_,prob.l);
 		cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)));
 		QD = new double[prob.l];
+#pragma omp parallel for schedule(static)
 		for(int i=0;i<prob.l;i++)
 			QD[i] = (this->*kernel_function)(i,i);
 	}
@@ -1399,6 +1417,7 @@ public:
 		int start, j;
 		if((start = cache->get_data(i,&data,len)) < len)
 		{
+#pragma omp parallel for private(j) schedule(guided) if(len - start >= PARALLEL_COLUMN_LENGTH)
 			for(j=start;j<len;j++)
 				data[j] = (Qfloat)(y[i]*y[j]*(this->*kernel_function)(i,j));
 		}
@@ -1438,6 +1457,7 @@ public:
 	{
 		cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)));
 		QD = new double[prob.l];
+#pragma omp parallel for schedule(static)
 		for(int i=0;i<prob.l;i++)
 			QD[i] = (this->*kernel_function)(i,i);
 	}
@@ -1448,6 +1468,7 @@ public:
 		int start, j;
 		if((start = cache->get_data(i,&data,len)) < len)
 		{
+#pragma omp parallel for private(j) schedule(guided) if(len - start >= PARALLEL_COLUMN_LENGTH)
 			for(j=start;j<len;j++)
 				data[j] = (Qfloat)(this->*kernel_function)(i,j);
 		}
@@ -1514,6 +1535,7 @@ public:
 		int j, real_i = index[i];
 		if(cache->get_data(real_i,&data,l) < l)
 		{
+#pragma omp parallel for private(j) schedule(guided) if(l >= PARALLEL_COLUMN_LENGTH)
 			for(j=0;j<l;j++)
 				data[j] = (Qfloat)(this->*kernel_function)(real_i,j);
 		}
@@ -2661,6 +2683,7 @@ double svm_predict_values(const svm_model *model, const svm_node *x, double* dec
 		double *sv_coef = model->sv_coef[0];
 		double sum = 0;
 		
+#pragma omp parallel for private(i) reduction(+:sum) schedule(static) if(model->l >= PARALLEL_COLUMN_LENGTH)
 		for(i=0;i<model->l;i++)
 #ifdef _DENSE_REP
 			sum += sv_coef[i] * Kernel::k_function(x,model->SV+i,model->param);
@@ -2681,6 +2704,7 @@ double svm_predict_values(const svm_model *model, const svm_node *x, double* dec
 		int l = model->l;
 		
 		double *kvalue = Malloc(double,l);
+#pragma omp parallel for private(i) schedule(static) if(l >= PARALLEL_COLUMN_LENGTH)
 		for(i=0;i<l;i++)
 #ifdef _DENSE_REP
 			kvalue[i] = Kernel::k_function(x,model->SV+i,model->param);
@@ -3153,7 +3177,7 @@ svm_model *svm_load_model(const char *model_file_name)
 	{
 		readline(fp);
 
-		model->SV[i].values = Malloc(double, elements);
+		model->SV[i].values = Malloc(svm_value, elements);
 		model->SV[i].dim = 0;
 
 		p = strtok(line, " \t");
@@ -3175,7 +3199,7 @@ svm_model *svm_load_model(const char *model_file_name)
 			index = (int) strtol(idx,&endptr,10);
 			while (*d < index)
 				model->SV[i].values[(*d)++] = 0.0;
-			model->SV[i].values[(*d)++] = strtod(val,&endptr);
+			model->SV[i].values[(*d)++] = (svm_value) strtod(val,&endptr);
 		}
 	}
 #else
@@ -0,0 +1,95 @@
+/*
+ * CorrelationFilter.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef TRACKING_CORRELATIONFILTER_HPP_
+#define TRACKING_CORRELATIONFILTER_HPP_
+
+#include "opencv2/core/core.hpp"
+#include <vector>
+
+namespace tracking {
+
+/**
+ * Multi-channel discriminative correlation filter that is learned in the Fourier domain.
+ *
+ * The filter is trained on a whole feature window at once, so all cyclic shifts of the window serve as (dense)
+ * negative training examples. The desired response is a Gaussian that peaks at the upper left corner of the
+ * target, so the response has the same meaning as the convolution of the window with a linear SVM's weights.
+ */
+class CorrelationFilter {
+public:
+
+	/**
+	 * Constructs a new correlation filter.
+	 *
+	 * @param[in] learnRate Weight of the new filter compared to the current one when updating (between zero and one).
+	 * @param[in] lambda Regularization parameter.
+	 * @param[in] sigmaFactor Standard deviation of the desired Gaussian response relative to the target size.
+	 */
+	explicit CorrelationFilter(double learnRate = 0.02, double lambda = 1e-4, double sigmaFactor = 0.1);
+
+	/**
+	 * Trains a new filter, discarding the previous one.
+	 *
+	 * @param[in] window Feature window (multi-channel, single-precision floating point).
+	 * @param[in] target Position and size of the target within the window in cells.
+	 */
+	void train(const cv::Mat& window, cv::Rect target);
+
+	/**
+	 * Updates the filter with a new feature window of the same size as the one it was trained with.
+	 *
+	 * @param[in] window Feature window (multi-channel, single-precision floating point).
+	 */
+	void update(const cv::Mat& window);
+
+	/**
+	 * Computes the cyclic correlation response of the filter to a feature window of the training window size.
+	 *
+	 * @param[in] window Feature window (multi-channel, single-precision floating point).
+	 * @return Response of type CV_32FC1 with the size of the window.
+	 */
+	cv::Mat computeResponse(const cv::Mat& window) const;
+
+	/**
+	 * @return True if the filter was not trained yet, false otherwise.
+	 */
+	bool empty() const {
+		return denominator.empty();
+	}
+
+private:
+
+	/**
+	 * Computes the Fourier transforms of the channels of a feature window after applying the cosine window.
+	 *
+	 * @param[in] window Feature window.
+	 * @return Complex spectra of the channels.
+	 */
+	std::vector<cv::Mat> transform(const cv::Mat& window) const;
+
+	/**
+	 * Computes the numerators and denominator of the filter given the spectra of a training window.
+	 *
+	 * @param[in] spectra Complex spectra of the window's channels.
+	 * @param[out] numerators Numerators of the filter, one per channel.
+	 * @param[out] denominator Denominator of the filter that is shared by all channels.
+	 */
+	void computeFilter(const std::vector<cv::Mat>& spectra, std::vector<cv::Mat>& numerators, cv::Mat& denominator) const;
+
+	double learnRate; ///< Weight of the new filter compared to the current one when updating (between zero and one).
+	double lambda; ///< Regularization parameter.
+	double sigmaFactor; ///< Standard deviation of the desired Gaussian response relative to the target size.
+	cv::Mat cosineWindow; ///< Cosine window that is applied to the feature channels.
+	cv::Mat desiredSpectrum; ///< Fourier transform of the desired Gaussian response.
+	std::vector<cv::Mat> numerators; ///< Numerators of the filter in the Fourier domain, one per feature channel.
+	cv::Mat denominator; ///< Real-valued denominator of the filter in the Fourier domain.
+};
+
+} // namespace tracking
+
+#endif /* TRACKING_CORRELATIONFILTER_HPP_ */
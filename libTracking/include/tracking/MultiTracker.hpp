@@ -12,6 +12,7 @@
 #include "classification/ProbabilisticSupportVectorMachine.hpp"
 #include "detection/AggregatedFeaturesDetector.hpp"
 #include "imageprocessing/VersionedImage.hpp"
+#include "imageprocessing/extraction/AggregatedFeaturesExtractor.hpp"
 #include "imageprocessing/extraction/FeatureExtractor.hpp"
 #include "opencv2/core/core.hpp"
 #include "tracking/filtering/MeasurementModel.hpp"
@@ -48,6 +49,16 @@ struct Associations {
 	std::vector<cv::Rect> unmatchedDetections; ///< Detections without an associated track.
 };
 
+/**
+ * Negative training candidates that are extracted once per frame and shared by the tracks.
+ */
+struct NegativeCandidatePool {
+	std::vector<cv::Rect> bounds; ///< Bounding boxes of the candidates within the image.
+	cv::Mat features; ///< Features of the candidates, one row per candidate and one column per value.
+	int patchRows; ///< Row count of a single candidate's feature matrix.
+	int patchType; ///< Type of a single candidate's feature matrix.
+};
+
 /**
  * Tracker that estimates the position of multiple detected targets in each frame.
  */
@@ -168,6 +179,43 @@ private:
 	 */
 	void updateTargetModels();
 
+	/**
+	 * Samples the negative training candidates of the current frame around all confirmed tracks.
+	 */
+	void updateNegativeCandidatePool();
+
+	/**
+	 * Samples negative training candidates from the surroundings of the target. The features of the candidates
+	 * refer to the feature pyramid and are not copied.
+	 *
+	 * @param[in] target Bounding box indicating the target position.
+	 * @param[in] count Number of candidates to sample.
+	 * @param[out] candidates Patches that are appended to.
+	 */
+	void sampleNegativeCandidates(cv::Rect target, int count, std::vector<std::shared_ptr<imageprocessing::Patch>>& candidates) const;
+
+	/**
+	 * Determines the indices of the pooled negative candidates that are suitable for the given target.
+	 *
+	 * @param[in] target Bounding box indicating the target position.
+	 * @return Indices of the candidates whose overlap with the target does not exceed the threshold.
+	 */
+	std::vector<int> getNegativeCandidateIndices(cv::Rect target) const;
+
+	/**
+	 * Computes the SVM scores of all pooled negative candidates at once.
+	 *
+	 * @param[in] svm Support vector machine.
+	 * @return Column vector containing the hyperplane distance of each candidate.
+	 */
+	cv::Mat computeNegativeCandidateScores(const classification::SupportVectorMachine& svm) const;
+
+	/**
+	 * @param[in] index Index of the pooled negative candidate.
+	 * @return Feature matrix of the candidate, not sharing data with the pool.
+	 */
+	cv::Mat getNegativeCandidate(int index) const;
+
 	/**
 	 * Adapts the target-specific classifier to the current appearance of the target and its surroundings.
 	 *
@@ -176,7 +224,7 @@ private:
 	void adapt(Track& track);
 
 	/**
-	 * Retrieves random negative training examples from the surroundings of the target.
+	 * Retrieves random negative training examples from the surroundings of the target, taken from the pool.
 	 *
 	 * @param[in] target Bounding box indicating the target position.
 	 * @return Negative training examples.
@@ -184,7 +232,7 @@ private:
 	std::vector<cv::Mat> getNegativeTrainingExamples(cv::Rect target) const;
 
 	/**
-	 * Retrieves hard negative training examples from the surroundings of the target.
+	 * Retrieves hard negative training examples from the surroundings of the target, taken from the pool.
 	 *
 	 * @param[in] target Bounding box indicating the target position.
 	 * @param[in] svm Current support vector machine.
@@ -213,11 +261,12 @@ private:
 	std::vector<Track> tracks; ///< Tracked targets.
 	int nextTrackId; ///< Identifier that is associated to the next new target.
 	std::shared_ptr<detection::AggregatedFeaturesDetector> detector; ///< Detector that finds new targets to track.
-	std::shared_ptr<imageprocessing::extraction::FeatureExtractor> pyramidFeatureExtractor; ///< Feature extractor that re-uses the feature pyramid of the detector.
+	std::shared_ptr<imageprocessing::extraction::AggregatedFeaturesExtractor> pyramidFeatureExtractor; ///< Feature extractor that re-uses the feature pyramid of the detector.
 	std::shared_ptr<imageprocessing::extraction::FeatureExtractor> exactFeatureExtractor; ///< Feature extractor that provides patches exactly as requested.
 	std::shared_ptr<classification::ProbabilisticSupportVectorMachine> svm; ///< SVM that is common to all targets.
 	std::shared_ptr<filtering::MeasurementModel> commonMeasurementModel; ///< Measurement model that is common to all targets.
 	std::shared_ptr<filtering::MotionModel> motionModel; ///< Motion model of the targets.
+	NegativeCandidatePool negativeCandidates; ///< Negative training candidates of the current frame.
 
 public:
 
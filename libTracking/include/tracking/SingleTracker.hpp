@@ -13,6 +13,7 @@
 #include "imageprocessing/filtering/ConvolutionFilter.hpp"
 #include "imageprocessing/filtering/FhogFilter.hpp"
 #include "opencv2/core/core.hpp"
+#include "tracking/CorrelationFilter.hpp"
 #include <memory>
 #include <random>
 #include <utility>
@@ -24,7 +25,8 @@ namespace tracking {
  *
  * This tracker needs to be initialized with the bounding box indicating the target position
  * in the first frame. For subsequent frames, the tracker predicts the new target positions
- * itself. It is based on FHOG features and a linear support vector machine.
+ * itself. It is based on FHOG features and either a linear support vector machine or a
+ * correlation filter.
  */
 class SingleTracker {
 public:
@@ -76,8 +78,36 @@ public:
 	 */
 	cv::Rect update(const cv::Mat& image);
 
+	/**
+	 * Enables or disables the shared feature window. If enabled, the FHOG descriptors are computed only once per
+	 * frame for a window that is large enough to contain the search windows of all scales. The features of the
+	 * other scales and of the retraining window are approximated by resampling that single feature window, which
+	 * allows to search more scales at no additional FHOG cost.
+	 *
+	 * @param[in] enabled Flag that indicates whether to use a single shared feature window per frame.
+	 * @param[in] scaleSteps Number of scales that are searched in each direction (larger and smaller).
+	 */
+	void setSharedFeatureWindow(bool enabled, int scaleSteps = 1);
+
+	/**
+	 * Enables or disables the correlation filter, which replaces the linear SVM as learner and detector. Instead of
+	 * a few sampled negative training examples, it learns from all cyclic shifts of the feature window in the Fourier
+	 * domain. Must be set before initializing the tracker, changing it afterwards throws an exception.
+	 *
+	 * @param[in] enabled Flag that indicates whether to use a correlation filter instead of a linear SVM.
+	 */
+	void setCorrelationFilter(bool enabled);
+
 private:
 
+	cv::Rect updateWithSharedFeatureWindow(const cv::Mat& image);
+
+	cv::Rect computeTargetBounds(const cv::Mat& image, cv::Rect windowBounds, const cv::Mat& window, cv::Point2d point) const;
+
+	cv::Mat getTrainingWindow(const cv::Mat& image, const cv::Mat& features, cv::Rect featureBounds) const;
+
+	void adapt(const cv::Mat& window);
+
 	bool isTargetTooSmall(int width, int height) const;
 
 	bool isTargetTooBig(const cv::Mat& image, int width, int height) const;
@@ -88,8 +118,12 @@ private:
 
 	cv::Mat getFeatures(const cv::Mat& image, cv::Rect windowBounds) const;
 
+	cv::Mat getFeatures(const cv::Mat& image, cv::Rect windowBounds, cv::Size sizeInCells) const;
+
 	std::pair<cv::Point2d, double> getMaxScore(const cv::Mat& window) const;
 
+	std::pair<cv::Point2d, double> getMaxResponse(const cv::Mat& response) const;
+
 	std::vector<cv::Mat> getPositiveTrainingExamples(const cv::Mat& window) const;
 
 	std::vector<cv::Mat> getNegativeTrainingExamples(const cv::Mat& window) const;
@@ -105,11 +139,15 @@ private:
 	std::shared_ptr<classification::SupportVectorMachine> svm; ///< SVM that is adapted to the target.
 	std::shared_ptr<classification::IncrementalClassifierTrainer<classification::SupportVectorMachine>> svmTrainer; ///< SVM trainer.
 	std::shared_ptr<imageprocessing::filtering::ConvolutionFilter> convolutionFilter; ///< Filter that convolves the FHOG window with the SVM weight.
+	std::shared_ptr<CorrelationFilter> correlationFilter; ///< Correlation filter that is adapted to the target.
+	bool useCorrelationFilter; ///< Flag that indicates whether the correlation filter is used instead of the SVM.
 	cv::Size targetSize; ///< Size of the target in FHOG cells.
 	cv::Size windowSize; ///< Size of the search window in FHOG cells.
 	double scaleFactor; ///< Scale factor of neighboring scales that are searched for the target.
 	int negativeExampleCount; ///< Number of negative training examples per classifier update.
 	double negativeOverlapThreshold; ///< Bounding box overlap ratio threshold of negative training examples with target position.
+	bool sharedFeatureWindow; ///< Flag that indicates whether the features of all scales are taken from a single feature window.
+	int scaleSteps; ///< Number of scales that are searched in each direction when using the shared feature window.
 	cv::Rect targetBounds; //< Current bounding box of the target in pixels.
 };
 
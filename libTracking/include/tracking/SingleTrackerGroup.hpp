@@ -0,0 +1,126 @@
+/*
+ * SingleTrackerGroup.hpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#ifndef TRACKING_SINGLETRACKERGROUP_HPP_
+#define TRACKING_SINGLETRACKERGROUP_HPP_
+
+#include "imageprocessing/filtering/FhogFilter.hpp"
+#include "opencv2/core/core.hpp"
+#include "tracking/SingleTracker.hpp"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace tracking {
+
+/**
+ * Group of independent single target trackers that are updated on the same frames.
+ *
+ * The trackers share a single FHOG filter (and its look-up table) and a grayscale version of the frame that is
+ * computed only once. The trackers are updated in parallel, each thread re-using its own scratch buffers for the
+ * window extraction. Because every tracker rescales its search window to the same size in cells, the FHOG
+ * computation has the same cost for each target, regardless of its scale.
+ */
+class SingleTrackerGroup {
+public:
+
+	/**
+	 * Constructs a new group of single target trackers.
+	 *
+	 * @param[in] fhogFilter Filter that computes the FHOG descriptors of the search windows of all trackers.
+	 * @param[in] targetSize Size of the targets in FHOG cells (larger one of width or height).
+	 * @param[in] padding Number of cells around the previous target position that is searched for the new position.
+	 * @param[in] scaleFactor Scale factor of neighboring scales that are searched for the targets.
+	 * @param[in] svmC Soft margin parameter of the SVMs.
+	 * @param[in] adaptationRate Weight of the new SVM parameters (between zero and one).
+	 * @param[in] grayscale Flag that indicates whether the trackers operate on a shared grayscale version of the frames.
+	 */
+	SingleTrackerGroup(std::shared_ptr<imageprocessing::filtering::FhogFilter> fhogFilter,
+			int targetSize = 10, int padding = 7, double scaleFactor = 1.05, double svmC = 10, double adaptationRate = 0.01,
+			bool grayscale = true);
+
+	/**
+	 * Adds a new target that is initialized on the frame that was given to the latest update.
+	 *
+	 * @param[in] bounds Bounding box that indicates the initial target position.
+	 * @param[in] force Flag that indicates whether to force the initialization, regardless of bounding box size and position.
+	 * @return Identifier of the new target, -1 if the tracker could not be initialized.
+	 */
+	int add(cv::Rect bounds, bool force = true);
+
+	/**
+	 * Removes a target.
+	 *
+	 * @param[in] id Identifier of the target.
+	 */
+	void remove(int id);
+
+	/**
+	 * Removes all targets.
+	 */
+	void clear();
+
+	/**
+	 * Updates all trackers with a new frame. Must be called before adding the targets of that frame.
+	 *
+	 * @param[in] image New frame.
+	 * @return Identifiers of and bounding boxes around the tracked targets.
+	 */
+	std::vector<std::pair<int, cv::Rect>> update(const cv::Mat& image);
+
+	/**
+	 * @return Number of tracked targets.
+	 */
+	size_t size() const {
+		return trackers.size();
+	}
+
+private:
+
+	/**
+	 * Tracker of a single target within the group.
+	 */
+	struct Member {
+		int id; ///< Identifier of the target.
+		std::unique_ptr<SingleTracker> tracker; ///< Tracker of the target.
+		cv::Rect bounds; ///< Current bounding box of the target.
+	};
+
+	/**
+	 * Loop body that updates a range of trackers.
+	 */
+	class UpdateBody : public cv::ParallelLoopBody {
+	public:
+
+		UpdateBody(std::vector<Member>& trackers, const cv::Mat& image) : trackers(trackers), image(image) {}
+
+		void operator()(const cv::Range& range) const override {
+			for (int i = range.start; i < range.end; ++i)
+				trackers[i].bounds = trackers[i].tracker->update(image);
+		}
+
+	private:
+
+		std::vector<Member>& trackers; ///< Trackers of the group.
+		const cv::Mat& image; ///< Current frame.
+	};
+
+	std::shared_ptr<imageprocessing::filtering::FhogFilter> fhogFilter; ///< Filter that computes the FHOG descriptors of all search windows.
+	int targetSize; ///< Size of the targets in FHOG cells (larger one of width or height).
+	int padding; ///< Number of cells around the previous target position that is searched for the new position.
+	double scaleFactor; ///< Scale factor of neighboring scales that are searched for the targets.
+	double svmC; ///< Soft margin parameter of the SVMs.
+	double adaptationRate; ///< Weight of the new SVM parameters (between zero and one).
+	bool grayscale; ///< Flag that indicates whether the trackers operate on a shared grayscale version of the frames.
+	cv::Mat image; ///< Current frame (or its grayscale version) that is shared by the trackers.
+	std::vector<Member> trackers; ///< Trackers of the targets.
+	int nextId; ///< Identifier that is associated to the next new target.
+};
+
+} // namespace tracking
+
+#endif /* TRACKING_SINGLETRACKERGROUP_HPP_ */
@@ -9,7 +9,7 @@
 #define TRACKING_FILTERING_CLASSIFIERMEASUREMENTMODEL_HPP_
 
 #include "classification/ProbabilisticClassifier.hpp"
-#include "imageprocessing/Patch.hpp"
+#include "imageprocessing/PatchView.hpp"
 #include "imageprocessing/extraction/FeatureExtractor.hpp"
 #include "tracking/filtering/MeasurementModel.hpp"
 
@@ -39,9 +39,10 @@ public:
 	}
 
 	double getLikelihood(const TargetState& state) const override {
-		std::shared_ptr<imageprocessing::Patch> featurePatch = featureExtractor->extract(
-				state.x, state.y, state.width(), state.height());
-		return featurePatch ? classifier->getProbability(featurePatch->getData()).second : 0;
+		imageprocessing::PatchView featurePatch; // refers to the features instead of copying them
+		if (!featureExtractor->extractView(state.bounds(), featurePatch))
+			return 0;
+		return classifier->getProbability(featurePatch.getData()).second;
 	}
 
 private:
@@ -0,0 +1,109 @@
+/*
+ * CorrelationFilter.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "tracking/CorrelationFilter.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include <stdexcept>
+
+using cv::Mat;
+using cv::Rect;
+using std::invalid_argument;
+using std::vector;
+
+namespace tracking {
+
+CorrelationFilter::CorrelationFilter(double learnRate, double lambda, double sigmaFactor) :
+		learnRate(learnRate), lambda(lambda), sigmaFactor(sigmaFactor) {
+	if (learnRate < 0 || learnRate > 1)
+		throw invalid_argument("CorrelationFilter: the learn rate must be between zero (inclusive) and one (inclusive)");
+	if (lambda <= 0)
+		throw invalid_argument("CorrelationFilter: lambda must be greater than zero");
+	if (sigmaFactor <= 0)
+		throw invalid_argument("CorrelationFilter: sigma factor must be greater than zero");
+}
+
+void CorrelationFilter::train(const Mat& window, Rect target) {
+	if (window.depth() != CV_32F)
+		throw invalid_argument("CorrelationFilter: the feature window must be of depth CV_32F");
+	cv::createHanningWindow(cosineWindow, window.size(), CV_32F);
+	double sigma = sigmaFactor * std::sqrt(static_cast<double>(target.area()));
+	double factor = -0.5 / (sigma * sigma);
+	Mat desiredResponse(window.size(), CV_32FC1);
+	for (int y = 0; y < desiredResponse.rows; ++y) {
+		int dy = std::abs(y - target.y);
+		dy = std::min(dy, desiredResponse.rows - dy);
+		float* values = desiredResponse.ptr<float>(y);
+		for (int x = 0; x < desiredResponse.cols; ++x) {
+			int dx = std::abs(x - target.x);
+			dx = std::min(dx, desiredResponse.cols - dx);
+			values[x] = static_cast<float>(std::exp(factor * (dx * dx + dy * dy)));
+		}
+	}
+	cv::dft(desiredResponse, desiredSpectrum, cv::DFT_COMPLEX_OUTPUT);
+	computeFilter(transform(window), numerators, denominator);
+}
+
+void CorrelationFilter::update(const Mat& window) {
+	if (empty())
+		throw std::runtime_error("CorrelationFilter: the filter must be trained before it can be updated");
+	if (window.size() != cosineWindow.size())
+		throw invalid_argument("CorrelationFilter: the feature window must have the same size as the training window");
+	vector<Mat> newNumerators;
+	Mat newDenominator;
+	computeFilter(transform(window), newNumerators, newDenominator);
+	for (size_t channel = 0; channel < numerators.size(); ++channel)
+		cv::addWeighted(numerators[channel], 1 - learnRate, newNumerators[channel], learnRate, 0, numerators[channel]);
+	cv::addWeighted(denominator, 1 - learnRate, newDenominator, learnRate, 0, denominator);
+}
+
+Mat CorrelationFilter::computeResponse(const Mat& window) const {
+	if (empty())
+		throw std::runtime_error("CorrelationFilter: the filter must be trained before computing responses");
+	if (window.size() != cosineWindow.size() || window.channels() != numerators.size())
+		throw invalid_argument("CorrelationFilter: the feature window must have the same size and channels as the training window");
+	vector<Mat> spectra = transform(window);
+	Mat responseSpectrum = Mat::zeros(window.size(), CV_32FC2);
+	Mat product;
+	for (size_t channel = 0; channel < spectra.size(); ++channel) {
+		cv::mulSpectrums(spectra[channel], numerators[channel], product, 0);
+		responseSpectrum += product;
+	}
+	Mat denominators[] = { denominator + lambda, denominator + lambda };
+	Mat complexDenominator;
+	cv::merge(denominators, 2, complexDenominator);
+	cv::divide(responseSpectrum, complexDenominator, responseSpectrum);
+	Mat response;
+	cv::idft(responseSpectrum, response, cv::DFT_SCALE | cv::DFT_REAL_OUTPUT);
+	return response;
+}
+
+vector<Mat> CorrelationFilter::transform(const Mat& window) const {
+	vector<Mat> channels;
+	cv::split(window, channels);
+	vector<Mat> spectra(channels.size());
+	for (size_t channel = 0; channel < channels.size(); ++channel) {
+		channels[channel] = channels[channel].mul(cosineWindow);
+		cv::dft(channels[channel], spectra[channel], cv::DFT_COMPLEX_OUTPUT);
+	}
+	return spectra;
+}
+
+void CorrelationFilter::computeFilter(const vector<Mat>& spectra, vector<Mat>& numerators, Mat& denominator) const {
+	numerators.resize(spectra.size());
+	Mat energy = Mat::zeros(desiredSpectrum.size(), CV_32FC2);
+	Mat product;
+	for (size_t channel = 0; channel < spectra.size(); ++channel) {
+		cv::mulSpectrums(desiredSpectrum, spectra[channel], numerators[channel], 0, true);
+		cv::mulSpectrums(spectra[channel], spectra[channel], product, 0, true);
+		energy += product;
+	}
+	Mat energyParts[2];
+	cv::split(energy, energyParts);
+	denominator = energyParts[0];
+}
+
+} // namespace tracking
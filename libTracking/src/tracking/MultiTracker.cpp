@@ -5,17 +5,17 @@
  *      Author: poschmann
  */
 
-#include "classification/IncrementalLinearSvmTrainer.hpp"
 #include "classification/LinearKernel.hpp"
+#include "classification/OnlineLinearSvmTrainer.hpp"
 #include "classification/PseudoProbabilisticSvmTrainer.hpp"
-#include "libsvm/LibSvmTrainer.hpp"
 #include "tracking/MultiTracker.hpp"
 #include "tracking/filtering/ClassifierMeasurementModel.hpp"
 #include "tracking/filtering/CorrelatedCombinationModel.hpp"
+#include "imageprocessing/Instrumentation.hpp"
 #include "imageprocessing/Patch.hpp"
 
-using classification::IncrementalLinearSvmTrainer;
 using classification::LinearKernel;
+using classification::OnlineLinearSvmTrainer;
 using classification::ProbabilisticSupportVectorMachine;
 using classification::PseudoProbabilisticSvmTrainer;
 using classification::SupportVectorMachine;
@@ -23,7 +23,6 @@ using cv::Mat;
 using cv::Point;
 using cv::Rect;
 using detection::AggregatedFeaturesDetector;
-using libsvm::LibSvmTrainer;
 using tracking::filtering::ClassifierMeasurementModel;
 using tracking::filtering::CorrelatedCombinationModel;
 using tracking::filtering::MeasurementModel;
@@ -31,7 +30,9 @@ using tracking::filtering::MotionModel;
 using tracking::filtering::ParticleFilter;
 using tracking::filtering::TargetState;
 using imageprocessing::Patch;
+using imageprocessing::PatchView;
 using imageprocessing::VersionedImage;
+using imageprocessing::extraction::AggregatedFeaturesExtractor;
 using imageprocessing::extraction::FeatureExtractor;
 using std::make_shared;
 using std::make_unique;
@@ -57,6 +58,7 @@ MultiTracker::MultiTracker(shared_ptr<FeatureExtractor> exactFeatureExtractor,
 				svm(svm),
 				commonMeasurementModel(make_shared<ClassifierMeasurementModel>(pyramidFeatureExtractor, svm)),
 				motionModel(motionModel),
+				negativeCandidates(),
 				particleCount(500),
 				adaptive(true),
 				associationThreshold(0.333),
@@ -85,16 +87,19 @@ vector<pair<int, Rect>> MultiTracker::update(const Mat& image) {
 	addNewTracks(associations.unmatchedDetections);
 	if (adaptive)
 		updateTargetModels();
+	INSTRUMENT_COUNT("tracker.tracks", tracks.size());
 	return extractTargets();
 }
 
 void MultiTracker::updateImage(const Mat& image) {
+	INSTRUMENT_SCOPE("tracker.image");
 	versionedImage->setData(image);
 	pyramidFeatureExtractor->update(versionedImage);
 	exactFeatureExtractor->update(versionedImage);
 }
 
 void MultiTracker::updateFilters() {
+	INSTRUMENT_SCOPE("tracker.filters");
 	for (Track& track : tracks) {
 		track.state = track.filter->update(versionedImage);
 		shared_ptr<Patch> patch = exactFeatureExtractor->extract(
@@ -111,6 +116,7 @@ void MultiTracker::updateFilters() {
 }
 
 Associations MultiTracker::pickAssociations(vector<Track>& tracks, vector<Rect>& detections) const {
+	INSTRUMENT_SCOPE("tracker.association");
 	Associations associations;
 	Mat overlaps(tracks.size(), detections.size(), CV_32FC1);
 	for (int i = 0; i < tracks.size(); ++i) {
@@ -172,7 +178,8 @@ void MultiTracker::removeObsoleteTracks(vector<reference_wrapper<Track>>& unmatc
 }
 
 bool MultiTracker::isVisible(const Track& track) const {
-	bool isTargetInsideFeaturePyramid = !!pyramidFeatureExtractor->extract(track.state.bounds());
+	PatchView patch;
+	bool isTargetInsideFeaturePyramid = pyramidFeatureExtractor->extractView(track.state.bounds(), patch);
 	return track.score > visibilityThreshold && isTargetInsideFeaturePyramid;
 }
 
@@ -201,8 +208,7 @@ void MultiTracker::addNewTracks(const vector<Rect>& unmatchedDetections) {
 
 Track MultiTracker::createTrack(Rect target) {
 	auto probabilisticSvm = make_shared<ProbabilisticSupportVectorMachine>(make_shared<LinearKernel>());
-	auto libSvmTrainer = make_shared<LibSvmTrainer>(targetSvmC, true);
-	auto incrementalSvmTrainer = make_shared<IncrementalLinearSvmTrainer>(libSvmTrainer, learnRate);
+	auto incrementalSvmTrainer = make_shared<OnlineLinearSvmTrainer>(targetSvmC, true, learnRate);
 	auto probabilisticSvmTrainer = make_shared<PseudoProbabilisticSvmTrainer>(incrementalSvmTrainer, 0.95, 0.05, 1.0, -1.0);
 	shared_ptr<MeasurementModel> targetMeasurementModel = make_shared<ClassifierMeasurementModel>(
 			pyramidFeatureExtractor, probabilisticSvm);
@@ -224,69 +230,113 @@ Track MultiTracker::createTrack(Rect target) {
 }
 
 void MultiTracker::updateTargetModels() {
+	INSTRUMENT_SCOPE("tracker.adaptation");
+	updateNegativeCandidatePool();
 	for (Track& track : tracks) {
 		if (track.confirmed)
 			adapt(track);
 	}
 }
 
-void MultiTracker::adapt(Track& track) {
-	Rect targetBounds = track.state.bounds();
-	if (track.svm->getSvm()->getSupportVectors().empty())
-		track.svmTrainer->train(*track.svm,
-				vector<Mat>{track.features}, getNegativeTrainingExamples(targetBounds));
-	else
-		track.svmTrainer->retrain(*track.svm,
-				vector<Mat>{track.features}, getNegativeTrainingExamples(targetBounds, *track.svm->getSvm()));
+void MultiTracker::updateNegativeCandidatePool() {
+	vector<shared_ptr<Patch>> candidates;
+	for (const Track& track : tracks) {
+		if (track.confirmed)
+			sampleNegativeCandidates(track.state.bounds(), 3 * negativeExampleCount, candidates);
+	}
+	negativeCandidates.bounds.clear();
+	negativeCandidates.bounds.reserve(candidates.size());
+	if (candidates.empty()) {
+		negativeCandidates.features = Mat();
+		return;
+	}
+	const Mat& firstData = candidates.front()->getData();
+	int valueCount = firstData.rows * firstData.cols * firstData.channels();
+	negativeCandidates.patchRows = firstData.rows;
+	negativeCandidates.patchType = firstData.type();
+	negativeCandidates.features.create(candidates.size(), valueCount, firstData.depth());
+	for (int i = 0; i < candidates.size(); ++i) {
+		const Mat& data = candidates[i]->getData();
+		Mat row(data.rows, data.cols, data.type(), negativeCandidates.features.ptr(i));
+		data.copyTo(row);
+		negativeCandidates.bounds.push_back(candidates[i]->getBounds());
+	}
 }
 
-vector<Mat> MultiTracker::getNegativeTrainingExamples(Rect target) const {
+void MultiTracker::sampleNegativeCandidates(Rect target, int count, vector<shared_ptr<Patch>>& candidates) const {
 	int lowerX = target.x - target.width;
 	int upperX = target.x + target.width;
 	int lowerY = target.y - target.height;
 	int upperY = target.y + target.height;
 	int lowerH = target.height / 2;
 	int upperH = target.height * 2;
-	vector<Mat> trainingExamples;
-	trainingExamples.reserve(negativeExampleCount);
-	while (trainingExamples.size() < trainingExamples.capacity()) {
+	candidates.reserve(candidates.size() + count);
+	for (int i = 0; i < count;) {
 		int x = std::uniform_int_distribution<int>{lowerX, upperX}(generator);
 		int y = std::uniform_int_distribution<int>{lowerY, upperY}(generator);
 		int height = std::uniform_int_distribution<int>{lowerH, upperH}(generator);
 		int width = height * target.width / target.height;
-		shared_ptr<Patch> patch = pyramidFeatureExtractor->extract(Rect(x, y, width, height));
-		if (patch && computeOverlap(target, patch->getBounds()) <= negativeOverlapThreshold)
-			trainingExamples.push_back(patch->getData());
+		shared_ptr<Patch> patch = pyramidFeatureExtractor->extractView(Rect(x, y, width, height));
+		if (patch && computeOverlap(target, patch->getBounds()) <= negativeOverlapThreshold) {
+			candidates.push_back(patch);
+			++i;
+		}
+	}
+}
+
+vector<int> MultiTracker::getNegativeCandidateIndices(Rect target) const {
+	vector<int> indices;
+	indices.reserve(negativeCandidates.bounds.size());
+	for (int i = 0; i < negativeCandidates.bounds.size(); ++i) {
+		if (computeOverlap(target, negativeCandidates.bounds[i]) <= negativeOverlapThreshold)
+			indices.push_back(i);
 	}
+	return indices;
+}
+
+Mat MultiTracker::computeNegativeCandidateScores(const SupportVectorMachine& svm) const {
+	return Mat(svm.computeHyperplaneDistances(negativeCandidates.features), true); // column vector of type CV_64F
+}
+
+Mat MultiTracker::getNegativeCandidate(int index) const {
+	Mat candidate = negativeCandidates.features.row(index).reshape(
+			CV_MAT_CN(negativeCandidates.patchType), negativeCandidates.patchRows);
+	return candidate.clone();
+}
+
+void MultiTracker::adapt(Track& track) {
+	Rect targetBounds = track.state.bounds();
+	if (track.svm->getSvm()->getSupportVectors().empty())
+		track.svmTrainer->train(*track.svm,
+				vector<Mat>{track.features}, getNegativeTrainingExamples(targetBounds));
+	else
+		track.svmTrainer->retrain(*track.svm,
+				vector<Mat>{track.features}, getNegativeTrainingExamples(targetBounds, *track.svm->getSvm()));
+}
+
+vector<Mat> MultiTracker::getNegativeTrainingExamples(Rect target) const {
+	vector<int> candidateIndices = getNegativeCandidateIndices(target);
+	std::shuffle(candidateIndices.begin(), candidateIndices.end(), generator);
+	int exampleCount = std::min(negativeExampleCount, static_cast<int>(candidateIndices.size()));
+	vector<Mat> trainingExamples;
+	trainingExamples.reserve(exampleCount);
+	for (int i = 0; i < exampleCount; ++i)
+		trainingExamples.push_back(getNegativeCandidate(candidateIndices[i]));
 	return trainingExamples;
 }
 
 vector<Mat> MultiTracker::getNegativeTrainingExamples(Rect target, const SupportVectorMachine& svm) const {
-	int lowerX = target.x - target.width;
-	int upperX = target.x + target.width;
-	int lowerY = target.y - target.height;
-	int upperY = target.y + target.height;
-	int lowerH = target.height / 2;
-	int upperH = target.height * 2;
-	vector<pair<double, Mat>> trainingCandidates;
-	trainingCandidates.reserve(3 * negativeExampleCount);
-	while (trainingCandidates.size() < trainingCandidates.capacity()) {
-		int x = std::uniform_int_distribution<int>{lowerX, upperX}(generator);
-		int y = std::uniform_int_distribution<int>{lowerY, upperY}(generator);
-		int height = std::uniform_int_distribution<int>{lowerH, upperH}(generator);
-		int width = height * target.width / target.height;
-		shared_ptr<Patch> patch = pyramidFeatureExtractor->extract(Rect(x, y, width, height));
-		if (patch && computeOverlap(target, patch->getBounds()) <= negativeOverlapThreshold) {
-			double score = svm.computeHyperplaneDistance(patch->getData());
-			trainingCandidates.emplace_back(score, patch->getData());
-		}
-	}
-	std::partial_sort(trainingCandidates.begin(), trainingCandidates.begin() + negativeExampleCount, trainingCandidates.end(),
-			[](const auto& a, const auto& b) { return a.first > b.first; });
+	vector<int> candidateIndices = getNegativeCandidateIndices(target);
+	if (candidateIndices.empty())
+		return vector<Mat>();
+	Mat scores = computeNegativeCandidateScores(svm);
+	int exampleCount = std::min(negativeExampleCount, static_cast<int>(candidateIndices.size()));
+	std::partial_sort(candidateIndices.begin(), candidateIndices.begin() + exampleCount, candidateIndices.end(),
+			[&](int a, int b) { return scores.at<double>(a) > scores.at<double>(b); });
 	vector<Mat> trainingExamples;
-	trainingExamples.reserve(negativeExampleCount);
-	for (int i = 0; i < trainingExamples.capacity(); ++i)
-		trainingExamples.push_back(trainingCandidates[i].second);
+	trainingExamples.reserve(exampleCount);
+	for (int i = 0; i < exampleCount; ++i)
+		trainingExamples.push_back(getNegativeCandidate(candidateIndices[i]));
 	return trainingExamples;
 }
 
@@ -6,16 +6,14 @@
  */
 
 #include "tracking/SingleTracker.hpp"
-#include "classification/IncrementalLinearSvmTrainer.hpp"
 #include "classification/LinearKernel.hpp"
-#include "libsvm/LibSvmTrainer.hpp"
+#include "classification/OnlineLinearSvmTrainer.hpp"
 #include <stdexcept>
 
 using namespace classification;
 using namespace cv;
 using namespace imageprocessing::filtering;
 using namespace std;
-using libsvm::LibSvmTrainer;
 
 namespace tracking {
 
@@ -29,13 +27,17 @@ SingleTracker::SingleTracker(shared_ptr<FhogFilter> fhogFilter,
 		generator(random_device()()),
 		fhogFilter(fhogFilter),
 		svm(make_shared<SupportVectorMachine>(make_shared<LinearKernel>())),
-		svmTrainer(make_shared<IncrementalLinearSvmTrainer>(make_shared<LibSvmTrainer>(svmC, true), adaptationRate)),
+		svmTrainer(make_shared<OnlineLinearSvmTrainer>(svmC, true, adaptationRate)),
 		convolutionFilter(make_shared<ConvolutionFilter>(CV_32F)),
+		correlationFilter(make_shared<CorrelationFilter>(adaptationRate)),
+		useCorrelationFilter(false),
 		targetSize(targetSize, targetSize),
 		windowSize(targetSize + 2 * padding, targetSize + 2 * padding),
 		scaleFactor(scaleFactor),
 		negativeExampleCount(10),
-		negativeOverlapThreshold(0.5) {
+		negativeOverlapThreshold(0.5),
+		sharedFeatureWindow(false),
+		scaleSteps(1) {
 	convolutionFilter->setAnchor(Point(0, 0));
 	if (targetSize < 1)
 		throw invalid_argument("SingleTracker: target size must be greater than zero");
@@ -71,6 +73,11 @@ Rect SingleTracker::init(const Mat& image, Rect bounds, bool force) {
 	if (force ||
 			(isTargetWithinImageBounds(image, targetBounds) && !isTargetTooSmall(targetBounds.width, targetBounds.height))) {
 		Mat window = getFeatures(image, getWindowBounds(image, targetBounds));
+		if (useCorrelationFilter) {
+			Rect target((window.cols - targetSize.width) / 2, (window.rows - targetSize.height) / 2, targetSize.width, targetSize.height);
+			correlationFilter->train(window, target);
+			return targetBounds;
+		}
 		svmTrainer->train(*svm, getPositiveTrainingExamples(window), getNegativeTrainingExamples(window));
 		convolutionFilter->setKernel(svm->getSupportVectors()[0]);
 		convolutionFilter->setDelta(-svm->getBias());
@@ -83,9 +90,24 @@ Rect SingleTracker::init(const Mat& image, Rect bounds, bool force) {
 	return targetBounds;
 }
 
+void SingleTracker::setSharedFeatureWindow(bool enabled, int scaleSteps) {
+	if (scaleSteps < 0)
+		throw invalid_argument("SingleTracker: number of scale steps must not be negative");
+	this->sharedFeatureWindow = enabled;
+	this->scaleSteps = scaleSteps;
+}
+
+void SingleTracker::setCorrelationFilter(bool enabled) {
+	if (enabled != useCorrelationFilter && targetBounds.area() != 0)
+		throw runtime_error("SingleTracker: the correlation filter must be set before initializing the tracker");
+	useCorrelationFilter = enabled;
+}
+
 Rect SingleTracker::update(const Mat& image) {
 	if (targetBounds.area() == 0)
 		throw runtime_error("SingleTracker: not initialized (target bounds too small or outside the image)");
+	if (sharedFeatureWindow)
+		return updateWithSharedFeatureWindow(image);
 	Rect windowBounds = getWindowBounds(image, targetBounds);
 	Mat window = getFeatures(image, windowBounds);
 	pair<Point2d, double> maxScore = getMaxScore(window);
@@ -121,31 +143,107 @@ Rect SingleTracker::update(const Mat& image) {
 		}
 	}
 
-	Point2d point = maxScore.first;
-	targetBounds.x = static_cast<int>(round(windowBounds.x + point.x * windowBounds.width / window.cols));
-	targetBounds.y = static_cast<int>(round(windowBounds.y + point.y * windowBounds.height / window.rows));
-	targetBounds.width = static_cast<int>(round(targetSize.width * windowBounds.width / static_cast<double>(window.cols)));
-	targetBounds.height = static_cast<int>(round(targetSize.height * windowBounds.height / static_cast<double>(window.rows)));
+	targetBounds = computeTargetBounds(image, windowBounds, window, maxScore.first);
+	if (isTargetWithinImageBounds(image, targetBounds))
+		adapt(getFeatures(image, getWindowBounds(image, targetBounds)));
 
-	cx = targetBounds.x + targetBounds.width / 2;
-	cy = targetBounds.y + targetBounds.height / 2;
+  return targetBounds;
+}
+
+Rect SingleTracker::updateWithSharedFeatureWindow(const Mat& image) {
+	int cx = targetBounds.x + targetBounds.width / 2;
+	int cy = targetBounds.y + targetBounds.height / 2;
+	double maxScale = pow(scaleFactor, scaleSteps);
+	int maxWidth = static_cast<int>(ceil(targetBounds.width * maxScale));
+	int maxHeight = static_cast<int>(ceil(targetBounds.height * maxScale));
+	Rect featureBounds = getWindowBounds(image, Rect(cx - maxWidth / 2, cy - maxHeight / 2, maxWidth, maxHeight));
+	Size featureSize(static_cast<int>(round(windowSize.width * maxScale)), static_cast<int>(round(windowSize.height * maxScale)));
+	Mat features = getFeatures(image, featureBounds, featureSize);
+
+	Mat window;
+	Mat bestFeatures;
+	Rect windowBounds;
+	pair<Point2d, double> maxScore(Point2d(), -numeric_limits<double>::infinity());
+	for (int step = -scaleSteps; step <= scaleSteps; ++step) {
+		double scale = pow(scaleFactor, step);
+		int width = static_cast<int>(step > 0 ? ceil(targetBounds.width * scale) : floor(targetBounds.width * scale));
+		int height = static_cast<int>(step > 0 ? ceil(targetBounds.height * scale) : floor(targetBounds.height * scale));
+		if ((step > 0 && isTargetTooBig(image, width, height)) || (step < 0 && isTargetTooSmall(width, height)))
+			continue;
+		Size scaledSize(static_cast<int>(round(windowSize.width * maxScale / scale)),
+				static_cast<int>(round(windowSize.height * maxScale / scale)));
+		Mat scaledFeatures = features;
+		if (scaledSize != features.size()) {
+			int interpolation = scaledSize.width > features.cols ? INTER_LINEAR : INTER_AREA;
+			resize(features, scaledFeatures, scaledSize, 0, 0, interpolation);
+		}
+		Rect windowInCells((scaledFeatures.cols - windowSize.width) / 2, (scaledFeatures.rows - windowSize.height) / 2,
+				windowSize.width, windowSize.height);
+		Mat scaledWindow = scaledFeatures(windowInCells);
+		pair<Point2d, double> scaledMaxScore = getMaxScore(scaledWindow);
+		if (scaledMaxScore.second > maxScore.second) {
+			double cellWidth = featureBounds.width / static_cast<double>(scaledFeatures.cols);
+			double cellHeight = featureBounds.height / static_cast<double>(scaledFeatures.rows);
+			windowBounds = Rect(
+					static_cast<int>(round(featureBounds.x + windowInCells.x * cellWidth)),
+					static_cast<int>(round(featureBounds.y + windowInCells.y * cellHeight)),
+					static_cast<int>(round(windowInCells.width * cellWidth)),
+					static_cast<int>(round(windowInCells.height * cellHeight)));
+			window = scaledWindow;
+			bestFeatures = scaledFeatures;
+			maxScore = scaledMaxScore;
+		}
+	}
+
+	targetBounds = computeTargetBounds(image, windowBounds, window, maxScore.first);
+	if (isTargetWithinImageBounds(image, targetBounds))
+		adapt(getTrainingWindow(image, bestFeatures, featureBounds));
+
+	return targetBounds;
+}
+
+Rect SingleTracker::computeTargetBounds(const Mat& image, Rect windowBounds, const Mat& window, Point2d point) const {
+	Rect bounds;
+	bounds.x = static_cast<int>(round(windowBounds.x + point.x * windowBounds.width / window.cols));
+	bounds.y = static_cast<int>(round(windowBounds.y + point.y * windowBounds.height / window.rows));
+	bounds.width = static_cast<int>(round(targetSize.width * windowBounds.width / static_cast<double>(window.cols)));
+	bounds.height = static_cast<int>(round(targetSize.height * windowBounds.height / static_cast<double>(window.rows)));
+
+	int cx = bounds.x + bounds.width / 2;
+	int cy = bounds.y + bounds.height / 2;
 	if (cx < 0 || cx >= image.cols || cy < 0 || cy >= image.rows) {
 		cx = max(cx, 0);
 		cx = min(cx, image.cols - 1);
 		cy = max(cy, 0);
 		cy = min(cy, image.rows - 1);
-		targetBounds.x = cx - targetBounds.width / 2;
-		targetBounds.y = cy - targetBounds.height / 2;
+		bounds.x = cx - bounds.width / 2;
+		bounds.y = cy - bounds.height / 2;
 	}
+	return bounds;
+}
 
-	if (isTargetWithinImageBounds(image, targetBounds)) {
-		window = getFeatures(image, getWindowBounds(image, targetBounds));
-		svmTrainer->retrain(*svm, getPositiveTrainingExamples(window), getNegativeTrainingExamples(window, *svm));
-		convolutionFilter->setKernel(svm->getSupportVectors()[0]);
-		convolutionFilter->setDelta(-svm->getBias());
-	}
+Mat SingleTracker::getTrainingWindow(const Mat& image, const Mat& features, Rect featureBounds) const {
+	double cellWidth = featureBounds.width / static_cast<double>(features.cols);
+	double cellHeight = featureBounds.height / static_cast<double>(features.rows);
+	int targetX = static_cast<int>(round((targetBounds.x - featureBounds.x) / cellWidth));
+	int targetY = static_cast<int>(round((targetBounds.y - featureBounds.y) / cellHeight));
+	Rect windowInCells(targetX - (windowSize.width - targetSize.width) / 2, targetY - (windowSize.height - targetSize.height) / 2,
+			windowSize.width, windowSize.height);
+	if (windowInCells.x < 0 || windowInCells.y < 0
+			|| windowInCells.x + windowInCells.width > features.cols
+			|| windowInCells.y + windowInCells.height > features.rows)
+		return getFeatures(image, getWindowBounds(image, targetBounds));
+	return features(windowInCells);
+}
 
-  return targetBounds;
+void SingleTracker::adapt(const Mat& window) {
+	if (useCorrelationFilter) {
+		correlationFilter->update(window);
+		return;
+	}
+	svmTrainer->retrain(*svm, getPositiveTrainingExamples(window), getNegativeTrainingExamples(window, *svm));
+	convolutionFilter->setKernel(svm->getSupportVectors()[0]);
+	convolutionFilter->setDelta(-svm->getBias());
 }
 
 bool SingleTracker::isTargetTooSmall(int width, int height) const {
@@ -182,6 +280,13 @@ Rect SingleTracker::getWindowBounds(const Mat& image, Rect targetBounds) const {
 }
 
 Mat SingleTracker::getFeatures(const Mat& image, Rect windowBounds) const {
+	return getFeatures(image, windowBounds, windowSize);
+}
+
+Mat SingleTracker::getFeatures(const Mat& image, Rect windowBounds, Size sizeInCells) const {
+	// scratch buffers are kept per thread, so trackers that run in parallel re-use their memory
+	thread_local Mat paddedWindow;
+	thread_local Mat resizedWindow;
 	Mat window;
 	if (windowBounds.x < 0 || windowBounds.y < 0
 			|| windowBounds.x + windowBounds.width >= image.cols
@@ -190,21 +295,23 @@ Mat SingleTracker::getFeatures(const Mat& image, Rect windowBounds) const {
 		double wt = max(0, windowBounds.y);
 		double wr = min(image.cols, windowBounds.x + windowBounds.width);
 		double wb = min(image.rows, windowBounds.y + windowBounds.height);
-		copyMakeBorder(image(Rect(wl, wt, wr - wl, wb - wt)), window,
+		copyMakeBorder(image(Rect(wl, wt, wr - wl, wb - wt)), paddedWindow,
 				wt - windowBounds.y, windowBounds.y + windowBounds.height - wb,
 				wl - windowBounds.x, windowBounds.x + windowBounds.width - wr, BORDER_REPLICATE);
+		window = paddedWindow;
 	} else {
 		window = image(windowBounds);
 	}
-	Mat resizedWindow;
 	int cellSize = fhogFilter->getCellSize();
-	Size newSize(windowSize.width * cellSize, windowSize.height * cellSize);
+	Size newSize(sizeInCells.width * cellSize, sizeInCells.height * cellSize);
 	int interpolation = newSize.width > window.cols ? INTER_LINEAR : INTER_AREA;
 	resize(window, resizedWindow, newSize, 0, 0, interpolation);
 	return fhogFilter->applyTo(resizedWindow);
 }
 
 pair<Point2d, double> SingleTracker::getMaxScore(const Mat& window) const {
+	if (useCorrelationFilter)
+		return getMaxResponse(correlationFilter->computeResponse(window));
 	Mat convolvedWindow = convolutionFilter->applyTo(window);
 	convolvedWindow = convolvedWindow(Rect(0, 0, window.cols - targetSize.width + 1, window.rows - targetSize.height + 1));
   Point iPoint;
@@ -224,6 +331,25 @@ pair<Point2d, double> SingleTracker::getMaxScore(const Mat& window) const {
 	return make_pair(point, maxScore);
 }
 
+pair<Point2d, double> SingleTracker::getMaxResponse(const Mat& response) const {
+	Point iPoint;
+	double maxResponse;
+	minMaxLoc(response, nullptr, &maxResponse, nullptr, &iPoint);
+	int prevX = (iPoint.x + response.cols - 1) % response.cols;
+	int nextX = (iPoint.x + 1) % response.cols;
+	int prevY = (iPoint.y + response.rows - 1) % response.rows;
+	int nextY = (iPoint.y + 1) % response.rows;
+	Point2d point(iPoint.x, iPoint.y);
+	point.x += subPixelPeak(response.at<float>(iPoint.y, prevX), maxResponse, response.at<float>(iPoint.y, nextX));
+	point.y += subPixelPeak(response.at<float>(prevY, iPoint.x), maxResponse, response.at<float>(nextY, iPoint.x));
+	// the response is cyclic, so displacements of more than half the window wrap around
+	if (point.x > (response.cols - targetSize.width) / 2 + response.cols / 2)
+		point.x -= response.cols;
+	if (point.y > (response.rows - targetSize.height) / 2 + response.rows / 2)
+		point.y -= response.rows;
+	return make_pair(point, maxResponse);
+}
+
 vector<Mat> SingleTracker::getPositiveTrainingExamples(const Mat& window) const {
 	Rect target((window.cols - targetSize.width) / 2, (window.rows - targetSize.height) / 2, targetSize.width, targetSize.height);
 	return vector<Mat>{ window(target).clone() };
@@ -247,18 +373,20 @@ vector<Mat> SingleTracker::getNegativeTrainingExamples(const Mat& window) const
 
 vector<Mat> SingleTracker::getNegativeTrainingExamples(const Mat& window, const SupportVectorMachine& svm) const {
 	Rect target((window.cols - targetSize.width) / 2, (window.rows - targetSize.height) / 2, targetSize.width, targetSize.height);
-	vector<pair<double, Mat>> trainingCandidates;
-	trainingCandidates.reserve(3 * negativeExampleCount);
-	while (trainingCandidates.size() < trainingCandidates.capacity()) {
+	vector<Mat> candidateExamples;
+	candidateExamples.reserve(3 * negativeExampleCount);
+	while (candidateExamples.size() < candidateExamples.capacity()) {
 		int x = uniform_int_distribution<int>{0, window.cols - targetSize.width}(generator);
 		int y = uniform_int_distribution<int>{0, window.rows - targetSize.height}(generator);
 		Rect candidate(x, y, targetSize.width, targetSize.height);
-		if (computeOverlap(target, candidate) < negativeOverlapThreshold) {
-			Mat example = window(candidate).clone();
-			double score = svm.computeHyperplaneDistance(example);
-			trainingCandidates.emplace_back(score, example);
-		}
+		if (computeOverlap(target, candidate) < negativeOverlapThreshold)
+			candidateExamples.push_back(window(candidate).clone());
 	}
+	vector<double> scores = svm.computeHyperplaneDistances(candidateExamples);
+	vector<pair<double, Mat>> trainingCandidates;
+	trainingCandidates.reserve(candidateExamples.size());
+	for (size_t i = 0; i < candidateExamples.size(); ++i)
+		trainingCandidates.emplace_back(scores[i], candidateExamples[i]);
 	std::partial_sort(trainingCandidates.begin(), trainingCandidates.begin() + negativeExampleCount, trainingCandidates.end(),
 			[](const auto& a, const auto& b) { return a.first > b.first; });
 	vector<Mat> trainingExamples;
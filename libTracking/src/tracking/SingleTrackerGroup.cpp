@@ -0,0 +1,73 @@
+/*
+ * SingleTrackerGroup.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: poschmann
+ */
+
+#include "tracking/SingleTrackerGroup.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+using cv::Mat;
+using cv::Rect;
+using imageprocessing::filtering::FhogFilter;
+using std::make_unique;
+using std::pair;
+using std::shared_ptr;
+using std::vector;
+
+namespace tracking {
+
+SingleTrackerGroup::SingleTrackerGroup(shared_ptr<FhogFilter> fhogFilter,
+		int targetSize, int padding, double scaleFactor, double svmC, double adaptationRate, bool grayscale) :
+				fhogFilter(fhogFilter),
+				targetSize(targetSize),
+				padding(padding),
+				scaleFactor(scaleFactor),
+				svmC(svmC),
+				adaptationRate(adaptationRate),
+				grayscale(grayscale),
+				image(),
+				trackers(),
+				nextId(0) {
+	if (!fhogFilter)
+		throw std::invalid_argument("SingleTrackerGroup: the FHOG filter must not be null");
+}
+
+int SingleTrackerGroup::add(Rect bounds, bool force) {
+	if (image.empty())
+		throw std::runtime_error("SingleTrackerGroup: update must be called with the current frame before adding targets");
+	auto tracker = make_unique<SingleTracker>(fhogFilter, targetSize, padding, scaleFactor, svmC, adaptationRate);
+	Rect initialBounds = tracker->init(image, bounds, force);
+	if (initialBounds.area() == 0)
+		return -1;
+	trackers.push_back({ nextId, std::move(tracker), initialBounds });
+	return nextId++;
+}
+
+void SingleTrackerGroup::remove(int id) {
+	trackers.erase(std::remove_if(trackers.begin(), trackers.end(), [id](const Member& member) {
+		return member.id == id;
+	}), trackers.end());
+}
+
+void SingleTrackerGroup::clear() {
+	trackers.clear();
+}
+
+vector<pair<int, Rect>> SingleTrackerGroup::update(const Mat& image) {
+	if (grayscale && image.channels() == 3)
+		cv::cvtColor(image, this->image, CV_BGR2GRAY);
+	else
+		this->image = image;
+	cv::parallel_for_(cv::Range(0, trackers.size()), UpdateBody(trackers, this->image));
+	vector<pair<int, Rect>> idsAndBounds;
+	idsAndBounds.reserve(trackers.size());
+	for (const Member& member : trackers)
+		idsAndBounds.emplace_back(member.id, member.bounds);
+	return idsAndBounds;
+}
+
+} // namespace tracking
@@ -6,6 +6,7 @@
  */
 
 #include "tracking/filtering/ParticleFilter.hpp"
+#include "imageprocessing/Instrumentation.hpp"
 #include <stdexcept>
 
 using cv::Rect;
@@ -56,6 +57,7 @@ TargetState ParticleFilter::update(const shared_ptr<VersionedImage> image) {
 }
 
 void ParticleFilter::resampleParticles() {
+	INSTRUMENT_SCOPE("particles.resample");
 	int count = particles.size();
 	vector<Particle> newParticles;
 	newParticles.reserve(count);
@@ -73,11 +75,13 @@ void ParticleFilter::resampleParticles() {
 }
 
 void ParticleFilter::moveParticles() {
+	INSTRUMENT_SCOPE("particles.move");
 	for (Particle& particle : particles)
 		particle.state = motionModel->sample(particle.state);
 }
 
 void ParticleFilter::weightParticles(const shared_ptr<VersionedImage> image) {
+	INSTRUMENT_SCOPE("particles.weight");
 	measurementModel->update(image);
 	for (Particle& particle : particles)
 		particle.weight *= measurementModel->getLikelihood(particle.state);